@@ -29,11 +29,17 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include <iostream>
 #include <string>
 #include <utility>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
 
 #include "codegen/netlist/Netlist.hpp"
 #include "codegen/netlist/NetlistLoader.hpp"
 #include "codegen/netlist/ComponentFactory.hpp"
 #include "codegen/SolverEngineGenerator.hpp"
+#include "codegen/SubsystemSolverEngineGenerator.hpp"
+#include "codegen/SystemPartitioner.hpp"
 
 #define STRINGFY(x) #x
 #define TOSTRING(x) STRINGFY(x)
@@ -61,12 +67,65 @@ const static std::string HELP_TEXT =
 R"(
 
 Simple usage: codegen netlist_file
+Usage with options: codegen [options] netlist_file
 
 To see this help text, use codegen -help
 To learn more about this tool, use codegen -about
 
 For more detailed information, see the manual/user guide.
 
+OPTIONS:
+
+-report -- print the multiply-accumulates per time step of each supported solve strategy
+-sparse_lu -- solve system with sparse LU forward/back substitution instead of dense inverse matrix
+-sparse_assembly -- assemble conductance matrix sparsely; with -sparse_lu, never forms the dense matrix
+-fused_gain -- solve system directly from component sources with fused (G^-1)*A source gain matrix
+-simd -- solve dense system product with AVX-512/AVX2 SIMD kernel (scalar fallback) on CPU targets
+-eliminate_dead -- solve and output only solutions read by components or probed
+-probe n1,n2,... -- probe given node solutions in output; implies -eliminate_dead
+-kron -- Kron reduce away nodes that have no sources and are neither read by components nor probed
+-sparsify budget -- prune solve matrix within given worst-case solution error relative to solution magnitude
+-sparsify_abs budget -- prune solve matrix within given absolute worst-case solution error
+-source_magnitude mag -- expected maximum magnitude of component sources for -sparsify/-sparsify_abs (default 1)
+                         and -fixed_point (default 1000)
+-adder_tree fan_in -- split solution and source vector sums into balanced adder trees of given fan-in (>=2)
+-switch_bank bytes -- stamp switch-dependent conductances of supporting components (SeriesRLIdealSwitch) and solve
+                     from a bank of inverses indexed by switch state within given memory budget in bytes
+-fixed_point resolution -- use fixed point real types, with the format of coefficients, sources, solutions, states,
+                           and parameters picked by range analysis for given target resolution; the generated header
+                           includes the bit-accurate ap_fixed emulation lblmc_fixed.hpp found in include/runtime,
+                           which requires C++11
+-fixed_width bits -- maximum fixed point word width in bits of any signal for -fixed_point (default 64)
+-state_magnitude mag -- expected maximum magnitude of component states for -fixed_point (default 1000)
+-saturate -- saturate fixed point words on overflow instead of wrapping for -fixed_point
+-rescale divider -- scale solve matrix by 1/divider (a power of 2) and solutions back by divider
+-selected_inverse -- compute only the elements of the inverse matrix read by the solve, from one sparse LU
+                     factorization with the solves spread over threads, instead of the full dense inverse
+-threads count -- number of threads computing -selected_inverse and formatting literal solve matrices (default is
+                  the number of hardware threads)
+-state_struct -- hold component fields and solutions in a <model>_state structure, set by <model>_init and stepped by
+                 <model>_step taking the structure by pointer, instead of static variables of the solver function
+-multi_step steps -- also generate <model>_solver_n (<model>_step_n with -state_struct) running given number of time
+                    steps per call, with arrays of the inputs of each step and of the outputs of each decimated step
+-decimate factor -- output the last of every given number of steps of -multi_step (default 1)
+-partition count -- partition the system at nodes of inductors, capacitors, and NortonPorts into given number of
+                   subsystems of balanced estimated cost and few ports, and generate a solver for each subsystem
+                   <model>_<index>, exchanging the port sources port_inject_<port>_out/_in with the others
+-batch width -- step given number of independent instances of the model in lockstep, with states, inputs, outputs,
+                and source parameters in structure-of-arrays layout; disables -simd
+-table_threshold macs -- loop over compressed (CSR/ELL) tables of the solve matrix, or of the sparse LU factors, for
+                        solves of at least given number of multiply-accumulates, instead of unrolling them; 0 always
+                        unrolls (default 32768)
+-binary_matrix -- store the dense solve matrix in binary file <model>_<matrix>.bin, loaded by the solver on its first
+                  call from the directory of macro LBLMC_BINARY_MATRIX_DIR, instead of a literal array;
+                  lblmc_binary_matrices_loaded() is false after a failed load
+-split chars -- split the solver into part functions of about given number of characters of code each, defined in
+               sources <model>_part<k>.cpp listed with <model>.cpp in <model>_sources.txt to compile in parallel;
+               the solver is stepped through a <model>_state structure as with -state_struct, and the sources are
+               compiled for the real type of macro LBLMC_SPLIT_REAL, double unless defined
+-hls ii -- generate the solver for Xilinx HLS as a top-level function, pipelined to the given initiation interval in
+           clock cycles with its arrays partitioned and ports given interfaces to match; 0 leaves the solver unpipelined
+
 NETLIST FORMAT:
 
 Only 1 command, comment, or component listing can be placed in each line.
@@ -145,80 +204,331 @@ int main(int argc, char* argv[])
 			std::cout << PROGRAM_TITLE + "\n" + COPYRIGHT + "\n" + PROGRAM_VERSION + ABOUT_TEXT << std::endl;
 			return 0;
 		}
-		else if(std::string(argv[1])[0] == '-' )
+	}
+
+	std::string netlist_filename;
+	bool report_enable = false;
+	bool switched_conductance_enable = false;
+	unsigned int num_partitions = 0;
+	std::vector<unsigned int> probes;
+
+	SolverEngineGeneratorParameters seg_params;
+	seg_params.codegen_solver_templated_function_enable = true;
+	seg_params.codegen_solver_templated_real_type_enable = true;
+
+	for(int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+
+		if(arg == "-report")
+		{
+			report_enable = true;
+		}
+		else if(arg == "-sparse_lu")
+		{
+			seg_params.solve_sparse_lu_enable = true;
+		}
+		else if(arg == "-sparse_assembly")
+		{
+			seg_params.solve_sparse_assembly_enable = true;
+		}
+		else if(arg == "-fused_gain")
+		{
+			seg_params.solve_fused_source_gain_enable = true;
+		}
+		else if(arg == "-simd")
+		{
+			seg_params.solve_simd_enable = true;
+		}
+		else if(arg == "-state_struct")
+		{
+			seg_params.codegen_state_struct_enable = true;
+		}
+		else if(arg == "-multi_step" && i+1 < argc)
+		{
+			seg_params.codegen_multi_step_count = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if(arg == "-decimate" && i+1 < argc)
+		{
+			seg_params.codegen_multi_step_decimation = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if(arg == "-partition" && i+1 < argc)
+		{
+			num_partitions = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if(arg == "-batch" && i+1 < argc)
+		{
+			seg_params.codegen_batch_width = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if(arg == "-table_threshold" && i+1 < argc)
+		{
+			seg_params.solve_table_mac_threshold = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if(arg == "-binary_matrix")
+		{
+			seg_params.codegen_binary_matrix_enable = true;
+		}
+		else if(arg == "-split" && i+1 < argc)
+		{
+			seg_params.codegen_split_function_size = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if(arg == "-hls" && i+1 < argc)
+		{
+			seg_params.xilinx_hls_enable = true;
+			seg_params.xilinx_hls_init_interval = std::strtoul(argv[++i], nullptr, 10);
+			seg_params.xilinx_hls_inline = false;
+		}
+		else if(arg == "-eliminate_dead")
+		{
+			seg_params.solve_dead_solution_elimination_enable = true;
+		}
+		else if(arg == "-probe" && i+1 < argc)
+		{
+			seg_params.solve_dead_solution_elimination_enable = true;
+
+			std::stringstream probe_list(argv[++i]);
+			std::string probe;
+
+			while(std::getline(probe_list, probe, ','))
+			{
+				probes.push_back(std::strtoul(probe.c_str(), nullptr, 10));
+			}
+		}
+		else if(arg == "-kron")
+		{
+			seg_params.solve_kron_reduction_enable = true;
+		}
+		else if(arg == "-sparsify" && i+1 < argc)
+		{
+			seg_params.sparsify_error_budget = std::strtod(argv[++i], nullptr);
+			seg_params.sparsify_relative_enable = true;
+		}
+		else if(arg == "-sparsify_abs" && i+1 < argc)
+		{
+			seg_params.sparsify_error_budget = std::strtod(argv[++i], nullptr);
+			seg_params.sparsify_relative_enable = false;
+		}
+		else if(arg == "-source_magnitude" && i+1 < argc)
+		{
+			seg_params.sparsify_source_magnitude = std::strtod(argv[++i], nullptr);
+			seg_params.fixed_point_source_magnitude = seg_params.sparsify_source_magnitude;
+		}
+		else if(arg == "-adder_tree" && i+1 < argc)
+		{
+			seg_params.solve_adder_tree_fan_in = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if(arg == "-switch_bank" && i+1 < argc)
+		{
+			switched_conductance_enable = true;
+			seg_params.switch_bank_memory_budget = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if(arg == "-fixed_point" && i+1 < argc)
+		{
+				//fixed point types are defined in the generated header, so the real type cannot be templated
+
+			seg_params.fixed_point_enable = true;
+			seg_params.fixed_point_word_length_analysis_enable = true;
+			seg_params.fixed_point_resolution = std::strtod(argv[++i], nullptr);
+			seg_params.codegen_solver_templated_real_type_enable = false;
+		}
+		else if(arg == "-fixed_width" && i+1 < argc)
+		{
+			seg_params.fixed_point_word_width = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if(arg == "-state_magnitude" && i+1 < argc)
+		{
+			seg_params.fixed_point_state_magnitude = std::strtod(argv[++i], nullptr);
+		}
+		else if(arg == "-saturate")
+		{
+			seg_params.fixed_point_saturation_enable = true;
+		}
+		else if(arg == "-rescale" && i+1 < argc)
+		{
+			seg_params.inv_conduct_matrix_rescale_enable = true;
+			seg_params.inv_conduct_matrix_divider = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if(arg == "-selected_inverse")
+		{
+			seg_params.inv_conduct_matrix_selected_enable = true;
+		}
+		else if(arg == "-threads" && i+1 < argc)
+		{
+			seg_params.inv_conduct_matrix_num_threads = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if(arg[0] == '-')
 		{
 			std::cout << "Unsupported switch/option given.\n" << std::endl;
 			return 0;
 		}
+		else if(netlist_filename.empty())
+		{
+			netlist_filename = arg;
+		}
 		else
 		{
-			std::string netlist_filename(argv[1]);
+			std::cout << "More than 1 netlist file is currently not supported.\n" << std::endl;
+			return 0;
+		}
+	}
 
-			ComponentFactory factory;
-			factory.registerBuiltinComponentProducers();
+	if(netlist_filename.empty())
+	{
+		std::cout << "No netlist file given.\n" << std::endl;
+		return 0;
+	}
 
-			NetlistLoader netlist_loader;
-			Netlist netlist;
+	ComponentFactory factory;
+	factory.registerBuiltinComponentProducers();
 
-			try
-			{
-				netlist = std::move(netlist_loader.loadFromFile(netlist_filename));
-			}
-			catch(std::exception& e)
-			{
-				std::cerr<<
-				"Error occurred during loading netlist:\n" <<
-				e.what() << std::endl;
+	NetlistLoader netlist_loader;
+	Netlist netlist;
 
-				return 1;
-			}
+	try
+	{
+		netlist = std::move(netlist_loader.loadFromFile(netlist_filename));
+	}
+	catch(std::exception& e)
+	{
+		std::cerr<<
+		"Error occurred during loading netlist:\n" <<
+		e.what() << std::endl;
 
-			std::string model_name = netlist.getModelName();
-			std::string model_solver_src_filename = model_name+std::string(".hpp");
-			unsigned int num_solutions = netlist.getNumberOfNodes();
+		return 1;
+	}
+
+	if(num_partitions > 0)
+	{
+		SystemPartitioner partitioner;
+		std::vector<SubsystemSolverEngineGenerator> subsystem_gens;
+		std::vector< std::vector<SubsystemSolverEngineGenerator::PortModel> > port_models;
+		std::vector< ComponentFactory::ComponentPtr > component_generators;
+
+		try
+		{
+			partitioner.partition(netlist, num_partitions);
 
-			std::vector< ComponentFactory::ComponentPtr > component_generators;
+			std::cout << partitioner.generateReport();
 
-			SolverEngineGenerator seg(model_name, num_solutions);
-			SolverEngineGeneratorParameters seg_params;
-			seg_params.codegen_solver_templated_function_enable = true;
-			seg_params.codegen_solver_templated_real_type_enable = true;
-				seg.setParameters(seg_params);
+				//stamp each subsystem alone to compute its port models
 
-			try
+			for(const auto& sub : partitioner.getSubsystems())
 			{
-				for(const auto& comp_listing : netlist.getComponents())
+				subsystem_gens.emplace_back(sub.netlist.getModelName(), sub.nodes.size());
+				auto& gen = subsystem_gens.back();
+
+				gen.setParameters(seg_params);
+				gen.setPorts(sub.ports);
+
+				std::vector<unsigned int> local_probes;
+
+				for(auto probe : probes)
 				{
-					component_generators.push_back( factory.produceComponent(comp_listing) );
+					auto found = std::find(sub.nodes.begin(), sub.nodes.end(), probe);
+					if(found != sub.nodes.end()) local_probes.push_back(found - sub.nodes.begin() + 1);
 				}
 
-				for(const auto& comp_gen_ptr : component_generators)
+				gen.setProbedSolutions(local_probes);
+
+				for(const auto& comp_listing : sub.netlist.getComponents())
 				{
-					comp_gen_ptr->stampSystem(seg);
+					component_generators.push_back( factory.produceComponent(comp_listing) );
+					component_generators.back()->setSwitchedConductanceEnable(switched_conductance_enable);
+					component_generators.back()->stampSystem(gen);
 				}
 
-				seg.generateCFunctionAndExport(model_solver_src_filename);
+				port_models.push_back(gen.computePortModels());
 			}
-			catch(const std::exception& e)
+
+				//then stamp the port models of the others into each subsystem and generate its solver
+
+			for(unsigned int s = 0; s < subsystem_gens.size(); s++)
 			{
-				std::cerr<<
-				"Error occurred during generation of solver code:\n" <<
-				e.what() << std::endl;
+				auto& gen = subsystem_gens[s];
 
-				return 1;
-			}
+				for(unsigned int o = 0; o < subsystem_gens.size(); o++)
+				{
+					if(o == s) continue;
 
-			std::cout <<"\'"<< model_solver_src_filename << "\' generated from netlist \'" << netlist_filename <<"\'"<< std::endl;
+					for(const auto& model : port_models[o])
+					{
+						if(gen.hasPort(model.id)) gen.stampOthersPortModel(model);
+					}
+				}
 
-			return 0;
+				gen.addOwnSourceGains(port_models[s]);
+
+				const std::string filename = gen.getModelName() + std::string(".hpp");
+				gen.generateCFunctionAndExport(filename);
+
+				std::cout <<"\'"<< filename << "\' generated from netlist \'" << netlist_filename <<"\'"<< std::endl;
+			}
 		}
+		catch(const std::exception& e)
+		{
+			std::cerr<<
+			"Error occurred during generation of subsystem solver code:\n" <<
+			e.what() << std::endl;
+
+			return 1;
+		}
+
+		return 0;
 	}
 
-	if(argc > 2)
+	std::string model_name = netlist.getModelName();
+	std::string model_solver_src_filename = model_name+std::string(".hpp");
+	unsigned int num_solutions = netlist.getNumberOfNodes();
+
+	std::vector< ComponentFactory::ComponentPtr > component_generators;
+
+	SolverEngineGenerator seg(model_name, num_solutions, seg_params);
+
+	try
 	{
-		std::cout << "More than 1 argument is currently not supported.\n" << std::endl;
-		return 0;
+		seg.setProbedSolutions(probes);
+
+		for(const auto& comp_listing : netlist.getComponents())
+		{
+			component_generators.push_back( factory.produceComponent(comp_listing) );
+		}
+
+		for(const auto& comp_gen_ptr : component_generators)
+		{
+			comp_gen_ptr->setSwitchedConductanceEnable(switched_conductance_enable);
+			comp_gen_ptr->stampSystem(seg);
+		}
+
+		if(report_enable)
+		{
+			std::cout << seg.generateSolveStrategyReport() << std::endl;
+		}
+
+		seg.generateCFunctionAndExport(model_solver_src_filename);
+
+		if(seg_params.sparsify_error_budget > 0.0 && !report_enable)
+		{
+			std::cout << seg.generateSparsificationReport();
+		}
+
+		std::cout << seg.generateWordLengthReport();
+
+		if(seg_params.solve_kron_reduction_enable)
+		{
+			std::cout << "Kron reduction removed " << num_solutions - seg.findRetainedSolutions().size()
+			<< " of " << num_solutions << " nodes" << std::endl;
+		}
 	}
+	catch(const std::exception& e)
+	{
+		std::cerr<<
+		"Error occurred during generation of solver code:\n" <<
+		e.what() << std::endl;
+
+		return 1;
+	}
+
+	std::cout <<"\'"<< model_solver_src_filename << "\' generated from netlist \'" << netlist_filename <<"\'"<< std::endl;
 
 	return 0;
 }
@@ -0,0 +1,108 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef LBLMC_ADDERTREEGENERATOR_HPP
+#define LBLMC_ADDERTREEGENERATOR_HPP
+
+#include <vector>
+#include <string>
+
+namespace lblmc
+{
+
+/**
+	\brief Generates code that splits a sum of many terms into a balanced tree of named partial sums
+
+	A sum emitted as one left-to-right chain "t0 + t1 + ... + tN" has a critical path of N adder
+	stages.  This generator instead groups the terms into partial sums of at most fan_in terms each,
+	level by level, so the critical path is only ceil(log_fan_in(N)) adder stages.  This shortens
+	the latency of HLS pipelines and exposes instruction level parallelism to out-of-order CPUs.
+
+	A fan_in below 2 disables the tree and keeps the linear left-to-right sum.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class AdderTreeGenerator
+{
+private:
+	unsigned int fan_in; ///< maximum number of terms summed by each adder of the tree; <2 for linear sums
+
+public:
+
+	/**
+		\brief parameter constructor
+		\param fan_in maximum number of terms summed by each adder of the tree; <2 for linear sums
+	**/
+	explicit AdderTreeGenerator(unsigned int fan_in = 0) : fan_in(fan_in) {}
+
+	inline void setFanIn(unsigned int fan_in) { this->fan_in = fan_in; }
+
+	inline unsigned int getFanIn() const { return fan_in; }
+
+	/**
+		\return true if sums are split into adder trees; false if kept as linear sums
+	**/
+	inline bool isEnabled() const { return fan_in >= 2; }
+
+	/**
+		\brief generates code for the partial sums of the adder tree of given terms
+
+		Each partial sum is declared as a local real variable named "<partial_prefix>_<level>_<index>".
+		The declarations are appended to given code buffer in order of dependency.
+
+		\param code string to which the partial sum declarations are appended
+		\param terms C++ expressions of the terms to sum; if empty, the sum is "real(0.0)"
+		\param partial_prefix unique C++ compatible label prefix for the partial sum variables
+		\return C++ expression of the top-level sum of at most fan_in operands
+	**/
+	std::string generatePartialSums
+	(
+		std::string& code,
+		const std::vector<std::string>& terms,
+		const std::string& partial_prefix
+	) const;
+
+	/**
+		\brief generates code for a full assignment of the sum of given terms to a target
+		\param target C++ lvalue expression that is assigned the sum, e.g. "x[3]"
+		\param terms C++ expressions of the terms to sum; if empty, the target is assigned "real(0.0)"
+		\param partial_prefix unique C++ compatible label prefix for the partial sum variables
+		\return string with the partial sum declarations followed by the assignment statement
+	**/
+	std::string generateAssignment
+	(
+		const std::string& target,
+		const std::vector<std::string>& terms,
+		const std::string& partial_prefix
+	) const;
+
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_ADDERTREEGENERATOR_HPP
@@ -0,0 +1,93 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef LBLMC_REALLITERALFORMATTER_HPP
+#define LBLMC_REALLITERALFORMATTER_HPP
+
+#include <string>
+#include <ostream>
+
+namespace lblmc
+{
+
+/**
+	\brief Formats real numbers as C/C++ floating point literals in their shortest round-trip form
+
+	Literals are formatted with std::to_chars() in scientific notation, with the fewest digits that still
+	parse back to the exact same double, such as 1e-03 for 0.001.  This is several times faster than
+	formatting through streams at a fixed 16 digit precision, and the literals are shorter.  Floating point
+	std::to_chars() is C++17, so C++14 builds format the same literals with snprintf() instead, more slowly.
+
+	Matrices, such as literal solve matrices with millions of elements, are formatted row by row in chunks
+	spread over threads, with each chunk formatted into its own pre-sized buffer, and the chunks written
+	to the output stream in order.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class RealLiteralFormatter
+{
+public:
+
+	static const unsigned int MAX_LENGTH = 32; ///< upper bound of the number of characters of a formatted literal
+
+	static const unsigned int CHUNK_SIZE = 65536; ///< approximate number of matrix elements formatted by a thread at a time
+
+	/**
+		\brief formats the given value as a literal into the given character buffer
+		\param first beginning of the buffer, with room for at least MAX_LENGTH characters
+		\param value value to format
+		\return pointer past the last character written; no null terminator is written
+	**/
+	static char* format(char* first, double value);
+
+	/**
+		\brief formats the given value as a literal
+		\param value value to format
+		\return string containing the literal
+	**/
+	static std::string format(double value);
+
+	/**
+		\brief writes the rows of a dense matrix as C/C++ initializer lists to a stream
+
+		Each row is written as {m0,m1,...}, followed by a comma unless it is the last, and a newline.
+
+		\param out stream the rows are written to
+		\param M dense matrix of rows by cols elements in row-major order
+		\param rows number of rows of the matrix
+		\param cols number of columns of the matrix
+		\param num_threads number of threads formatting the rows; 0 uses the number of hardware threads
+	**/
+	static void writeMatrixRows(std::ostream& out, const double* M, unsigned int rows, unsigned int cols, unsigned int num_threads = 0);
+
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_REALLITERALFORMATTER_HPP
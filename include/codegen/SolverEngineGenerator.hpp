@@ -25,10 +25,22 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 
 #include <string>
 #include <vector>
+#include <ostream>
 
 #include "codegen/SystemConductanceGenerator.hpp"
 #include "codegen/SystemSourceVectorGenerator.hpp"
 #include "codegen/SystemSolverGenerator.hpp"
+#include "codegen/SystemLUSolverGenerator.hpp"
+#include "codegen/SystemSIMDSolverGenerator.hpp"
+#include "codegen/SystemSparsifier.hpp"
+#include "codegen/SystemSwitchBankGenerator.hpp"
+#include "codegen/SystemBinaryMatrixGenerator.hpp"
+#include "codegen/SystemTableSolverGenerator.hpp"
+#include "codegen/SystemWordLengthAnalyzer.hpp"
+#include "codegen/SystemBatchGenerator.hpp"
+#include "codegen/SystemStateGenerator.hpp"
+#include "codegen/SystemSplitGenerator.hpp"
+#include "codegen/SystemDirectiveGenerator.hpp"
 
 namespace lblmc
 {
@@ -42,6 +54,13 @@ struct SolverEngineGeneratorParameters
 	// General code generation settings
 	bool codegen_solver_templated_function_enable; ///< enables making the generated solver function into a template; default is false
 	bool codegen_solver_templated_real_type_enable; ///< enables templating the generated solver function's real type; depends on codegen_solver_templated_function_enable being true; default is false
+	bool codegen_state_struct_enable; ///< enables generating a reentrant solver stepping a <model>_state structure (see SystemStateGenerator); not supported with codegen_batch_width; default is false
+	unsigned int codegen_multi_step_count; ///< number of time steps per call of an additional multi-step solver function; not supported with codegen_batch_width; 0 generates none; default is 0
+	unsigned int codegen_multi_step_decimation; ///< decimation factor of the outputs of the multi-step function; must divide codegen_multi_step_count; default is 1
+	unsigned int codegen_batch_width; ///< number of model instances stepped in lockstep, differing only in source parameters (see SystemBatchGenerator); 0 or 1 generates the single-instance solver; default is 0
+	bool codegen_binary_matrix_enable; ///< enables loading the dense solve matrix from a binary file instead of a literal array (see SystemBinaryMatrixGenerator); ignored for HLS; default is false
+	std::string codegen_binary_matrix_directory; ///< directory the binary matrix files are written to; empty for the current directory; default is empty
+	unsigned long codegen_split_function_size; ///< approximate characters of code per part function of a split solver (see SystemSplitGenerator); 0 generates the single header solver; default is 0
 
 	// Xilinx (Vivado) High-Level Synthesis settings
 	bool         xilinx_hls_enable;       ///< enable code generation for Xilinx HL synthesis; default is false
@@ -49,16 +68,42 @@ struct SolverEngineGeneratorParameters
 	bool         xilinx_hls_latency_enable; ///< enable setting of clock cycle latency; default if false
 	unsigned int xilinx_hls_latency_min;  ///< set minimum number of clock cycles to execute; default is 0
 	unsigned int xilinx_hls_latency_max;  ///< set maximum number of clock cycles to execute; default is 0
-	bool         xilinx_hls_inline;       ///< enable inlining of the generated code into top-level design; default is true
+	bool         xilinx_hls_inline;       ///< enable inlining of the generated code into top-level design, which then sets its interfaces and pipeline; default is true
+	unsigned int xilinx_hls_init_interval; ///< target pipeline initiation interval of the solver in clock cycles, unless inlined (see SystemDirectiveGenerator); 0 leaves the solver unpipelined; default is 0
 
 	// Fixed Point settings
-	bool         fixed_point_enable;         ///< enable use of fixed point for real numbers; default is false
-	unsigned int fixed_point_word_width;  ///< set word width in bits of the fixed point words; default is 64
-	unsigned int fixed_point_int_width;   ///< set the integral width in bits of the fixed point words; default is 32
+	bool         fixed_point_enable;         ///< enable use of fixed point for real numbers, as ap_fixed for HLS or else lblmc_fixed; ignored with templated real type; default is false
+	unsigned int fixed_point_word_width;  ///< set word width in bits of the fixed point words, or the maximum word width of each signal class with fixed_point_word_length_analysis_enable; default is 64
+	unsigned int fixed_point_int_width;   ///< set the integral width in bits of the fixed point words; unused with fixed_point_word_length_analysis_enable; default is 32
+	bool         fixed_point_word_length_analysis_enable; ///< enable picking the fixed point format of each signal class by worst-case range analysis (see SystemWordLengthAnalyzer); default is false
+	double       fixed_point_resolution; ///< target resolution (least significant bit weight) of sources, solutions, and states for word-length analysis; default is 1e-6
+	double       fixed_point_source_magnitude; ///< expected maximum magnitude of each component source contribution for word-length analysis, raised to the largest literal source parameter; default is 1e3
+	double       fixed_point_state_magnitude; ///< expected maximum magnitude of component states and signals for word-length analysis; default is 1e3
+	bool         fixed_point_saturation_enable; ///< enable saturation of fixed point words on overflow instead of wrapping; default is false
 
 	// Inverted Conductance Matrix Optimizations
-	bool inv_conduct_matrix_rescale_enable;     ///< enable rescaling of the inverted conductance matrix by a power of 2 scalar; default is false
+	bool inv_conduct_matrix_rescale_enable;     ///< enable rescaling of the inverted conductance matrix by a power of 2 scalar, narrowing its range for fixed point; default is false
 	unsigned int inv_conduct_matrix_divider; ///< set power of 2 divider scalar for the inverted conductance matrix; default is 2
+	bool inv_conduct_matrix_selected_enable; ///< enable computing only the needed elements of G^-1 from one sparse LU factorization (see SystemConductanceGenerator::getSelectedInverse()); default is false
+	unsigned int inv_conduct_matrix_num_threads; ///< set number of threads computing selected elements of G^-1 and formatting literal solve matrices; 0 uses all hardware threads; default is 0
+
+	// System Solve settings
+	bool solve_sparse_lu_enable; ///< enable solving Gx=b by forward/back substitution over sparse LU factors of fill-reducing ordered G, instead of product with dense G^-1; default is false
+	bool solve_sparse_assembly_enable; ///< enable assembling G sparsely, made dense only for strategies that need it (see SystemConductanceGenerator::setSparseAssemblyEnable()); default is false
+	bool solve_fused_source_gain_enable; ///< enable solving x=(G^-1*A)*b_components with a precomputed source gain matrix, fusing away aggregation of b; default is false
+	bool solve_simd_enable; ///< enable solving the dense product with an explicit SIMD kernel over a column-blocked matrix (see SystemSIMDSolverGenerator); ignored for HLS and sparse LU; default is false
+	bool solve_dead_solution_elimination_enable; ///< enable solving and outputting only the solutions read by component code or probed (see SolverEngineGenerator::setProbedSolutions()); default is false
+	bool solve_kron_reduction_enable; ///< enable Kron reduction of G, eliminating unobserved solutions without sources before inversion or factoring; default is false
+	unsigned long solve_table_mac_threshold; ///< multiply-accumulates per solve at and above which the solve loops over tables (see SystemTableSolverGenerator); ignored for HLS and fixed point; 0 always unrolls; default is 32768
+	unsigned int solve_adder_tree_fan_in; ///< set fan-in of balanced adder trees summing each solution x and source vector b element; 0 or 1 keeps left-to-right linear sums (bit-exact with prior code); default is 0
+
+	// Solve Matrix Sparsification settings
+	double sparsify_error_budget; ///< worst-case error budget of each solution for pruning elements of G^-1, or of (G^-1)*A when fused, beyond zero_bound; not applied to sparse LU; 0 disables; bound holds per solve step; default is 0
+	bool sparsify_relative_enable; ///< treat sparsify_error_budget as relative to the worst-case magnitude of each solution, instead of absolute in units of the solutions; default is true
+	double sparsify_source_magnitude; ///< expected maximum magnitude of each component source contribution, bounding the source vector b for sparsification; default is 1.0
+
+	// Switch-State Inverse Bank settings
+	unsigned long switch_bank_memory_budget; ///< largest size in bytes of the bank of inverted conductance matrices indexed by switch state (see Component::setSwitchedConductanceEnable()); default is 1048576 (1 MiB)
 
 	// Input/Output Signal settings
 	bool io_signal_output_enable;  ///< enable use of output signals; default is true
@@ -68,17 +113,44 @@ struct SolverEngineGeneratorParameters
 	SolverEngineGeneratorParameters() :
 		codegen_solver_templated_function_enable(false),
 		codegen_solver_templated_real_type_enable(false),
+		codegen_state_struct_enable(false),
+		codegen_multi_step_count(0),
+		codegen_multi_step_decimation(1),
+		codegen_batch_width(0),
+		codegen_binary_matrix_enable(false),
+		codegen_binary_matrix_directory(),
+		codegen_split_function_size(0),
 		xilinx_hls_enable(false),
 		xilinx_hls_clock_period(50.0e-9),
 		xilinx_hls_latency_enable(false),
 		xilinx_hls_latency_min(0),
 		xilinx_hls_latency_max(0),
 		xilinx_hls_inline(true),
+		xilinx_hls_init_interval(0),
 		fixed_point_enable(false),
         fixed_point_word_width(64),
         fixed_point_int_width(32),
+		fixed_point_word_length_analysis_enable(false),
+		fixed_point_resolution(1.0e-6),
+		fixed_point_source_magnitude(1.0e3),
+		fixed_point_state_magnitude(1.0e3),
+		fixed_point_saturation_enable(false),
 		inv_conduct_matrix_rescale_enable(false),
         inv_conduct_matrix_divider(2),
+		inv_conduct_matrix_selected_enable(false),
+		inv_conduct_matrix_num_threads(0),
+		solve_sparse_lu_enable(false),
+		solve_sparse_assembly_enable(false),
+		solve_fused_source_gain_enable(false),
+		solve_simd_enable(false),
+		solve_dead_solution_elimination_enable(false),
+		solve_kron_reduction_enable(false),
+		solve_table_mac_threshold(32768),
+		solve_adder_tree_fan_in(0),
+		sparsify_error_budget(0.0),
+		sparsify_relative_enable(true),
+		sparsify_source_magnitude(1.0),
+		switch_bank_memory_budget(1048576),
 		io_signal_output_enable(true),
 		io_source_vector_output_enable(false),
 		io_component_sources_output_enable(false)
@@ -104,6 +176,7 @@ protected:
 	std::string model_name;
 	unsigned int num_solutions;
 	std::vector<std::string> comp_parameters;
+	std::vector<std::string> comp_source_parameters; ///< names of literal parameters of components that only set source or control values
 	std::vector<std::string> comp_fields;
 	std::vector<std::string> comp_inputs;
 	std::vector<std::string> comp_outputs;
@@ -114,6 +187,270 @@ protected:
 
 	SolverEngineGeneratorParameters parameters;
 
+	std::vector<unsigned int> probed_solutions; ///< indices of solutions x[i] the user observes from x_out, kept by dead solution elimination
+
+	/**
+		\brief marks the solutions x[i] that the given generated code reads by constant index
+		\param code C++ code of a component; comments are ignored
+		\param referenced flags indexed by solution x[i], set true for each x[i] referenced in the code
+		\return false if the code refers to the solution vector x other than by constant index, so its
+		references cannot be resolved
+	**/
+	static bool markSolutionReferences(const std::string& code, std::vector<bool>& referenced);
+
+	/**
+		\return flags indexed by solution x[i] of the solutions to solve; empty to solve all, as when
+		solve_dead_solution_elimination_enable is false
+	**/
+	std::vector<bool> findSolvedSolutions() const;
+
+	/**
+		\brief Kron reduces the given system to eliminate its solutions that have no sources and are not observed
+
+		The system is left unreduced if nothing can be eliminated, or if the eliminated solutions cannot be
+		solved on their own.
+
+		\param cond_gen conductance matrix of the system to reduce, usually a copy of conductance_matrix_gen
+		\param src_gen source vector of the system to reduce, usually a copy of source_vector_gen
+		\return original index of solution x[i] for each row of the reduced system
+	**/
+	std::vector<unsigned int> reduceSystem(SystemConductanceGenerator& cond_gen, SystemSourceVectorGenerator& src_gen) const;
+
+	/**
+		\brief inverts the given conductance matrix in place into the solve matrix G^-1
+
+		With inv_conduct_matrix_selected_enable, only the elements of G^-1 read by the solve are computed,
+		being those in rows of solved solutions and in columns of b with sources; the rest are left zero.
+
+		\param invg_gen conductance matrix of the solved system, inverted in place
+		\param src_gen source vector of the solved system
+		\param solved flags indexed by solution x[i] of solved solutions; all are solved if empty
+		\param solution_indices original index of solution x[i] for each row of a reduced system; empty if unreduced
+	**/
+	void invertSolveMatrix
+	(
+		SystemConductanceGenerator& invg_gen,
+		const SystemSourceVectorGenerator& src_gen,
+		const std::vector<bool>& solved,
+		const std::vector<unsigned int>& solution_indices
+	) const;
+
+	/**
+		\brief prunes the given solve matrix within the error budget set by the sparsify_* parameters
+
+		\param M solve matrix; G^-1, or (G^-1)*A when fused
+		\param src_gen source vector of the solved system, bounding the inputs of the solve matrix
+		\param fused true if M is the fused source gain matrix (G^-1)*A with inputs b_components; false if M is G^-1 with inputs b
+		\param zero_bound value indicating how close a solve matrix element must be to zero to be discarded regardless of the budget
+		\return sparsifier holding the pruned matrix and its error bounds
+	**/
+	SystemSparsifier sparsifySolveMatrix(const MatrixRMXd& M, const SystemSourceVectorGenerator& src_gen, bool fused, double zero_bound) const;
+
+	/**
+		\return divider the inverted conductance or fused source gain matrix is scaled by; 1 unless
+		inv_conduct_matrix_rescale_enable is true
+		\throw std::invalid_argument if inv_conduct_matrix_divider is not a power of 2
+	**/
+	double findSolveMatrixDivider() const;
+
+	/**
+		\brief pieces of the generated code solving the system, as picked by the solve strategy parameters
+	**/
+	struct SolveCode
+	{
+		unsigned int dimension; ///< number of rows of the solved system, Kron reduced if enabled
+		unsigned int num_components; ///< number of component sources
+		std::string literals; ///< definitions of the literal solve matrices or tables; empty for unrolled sparse LU
+		std::string aggregation; ///< code aggregating the source vector b from the component sources; empty if fused away
+		std::string solve; ///< code solving the solutions x, with their rescaling if enabled
+		bool unrolled_rows; ///< true if aggregation and solve are single statements per element with linear sums, sharing no temporaries
+		std::string directives; ///< HLS directives partitioning the solve matrix and vectors, following their declarations; empty unless for HLS
+	};
+
+	/**
+		\brief generates the code solving the system with the strategy picked by the solve_* parameters
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+		\return pieces of the solve code
+	**/
+	SolveCode generateSolveCode(double zero_bound) const;
+
+	/**
+		\param parameter_list parameter list of the solver function, whose ports are given interface directives
+		\param steps number of time steps per call of the solver function; the function is pipelined to
+		xilinx_hls_init_interval for a single step, or else the step loop within is, over which the ports are accessed
+		\return code of the synthesis directives, or directive placeholders, heading the solver body
+	**/
+	std::string generateDirectiveCode(const std::string& parameter_list, unsigned int steps = 1) const;
+
+	/**
+		\brief generates the HLS directives partitioning the solve matrix and the solution and source vectors for xilinx_hls_init_interval
+
+		Each element of the vectors is taken as written once and read once per step, besides the reads of the
+		vector the solve matrix multiplies, one per multiply-accumulate.
+
+		\param matrix_name name of the literal solve matrix; empty if the solve has none, as the unrolled sparse LU
+		\param matrix_dimensions number of elements of each dimension of the solve matrix
+		\param num_macs number of multiply-accumulates of the solve per step, each reading one element of the matrix
+		\param fused_enable true if the matrix multiplies the component sources b_components, or else the source vector b
+		\param dimension number of elements of the source vector b
+		\param num_components number of component sources
+		\param vectors_enable true to partition x and b_components too, false if they are held by the state structure
+		\return string containing the generated directives; empty if the solver is not pipelined
+	**/
+	std::string generateSolveDirectiveCode(const std::string& matrix_name, const std::vector<unsigned long>& matrix_dimensions,
+		unsigned long num_macs, bool fused_enable, unsigned int dimension, unsigned int num_components, bool vectors_enable) const;
+
+	/**
+		\return code copying the solutions, and the source vector and component sources if enabled, to the outputs of the solver
+	**/
+	std::string generateOutputCode() const;
+
+	/**
+		\param num_macs number of multiply-accumulates of the solve per step
+		\return true if a solve of the given number of multiply-accumulates loops over tables instead of being unrolled,
+		as set by solve_table_mac_threshold and unless for HLS, fixed point, adder trees, or batches
+	**/
+	bool isTableSolveEnabled(unsigned long num_macs) const;
+
+	/**
+		\return true if dense solve matrices are stored in binary files instead of literal arrays, as set by codegen_binary_matrix_enable and unless for HLS
+	**/
+	bool isBinaryMatrixEnabled() const;
+
+	/**
+		\brief writes a dense solve matrix to its binary file <model>_<M_name>.bin in codegen_binary_matrix_directory, and the
+		code declaring its array and loading it on the first call of the solver to the given stream
+		\param out stream the code is written to
+		\param M_name C/C++ compatible name for the matrix array
+		\param dimensions sizes of each dimension of the array
+		\param M elements of the matrix in the order of the array
+		\param prefix code preceding the declaration, such as an alignment attribute
+	**/
+	void generateBinaryMatrixCode(std::ostream& out, std::string M_name, const std::vector<unsigned long>& dimensions,
+		const double* M, std::string prefix = "") const;
+
+	/**
+		\return true if the generated solver steps a batch of instances, as set by codegen_batch_width
+	**/
+	bool isBatchEnabled() const;
+
+	/**
+		\return true if the generated solver holds its persistent fields in a state structure, as set by codegen_state_struct_enable
+	**/
+	bool isStateStructEnabled() const;
+
+	/**
+		\brief creates the generator collecting the persistent fields of the components and the solutions into the state structure
+		\param hold_locals true to also hold the temporaries of the components in the state structure
+		\return state generator holding the persistent fields
+	**/
+	SystemStateGenerator createStateGenerator(bool hold_locals = false) const;
+
+	/**
+		\brief generates the function setting a state structure to the initial state of the model
+		\return string containing the C++ function definition
+	**/
+	std::string generateStateInitCFunction() const;
+
+	/**
+		\return true if the generated solver is split into part functions over several source files, as set by
+		codegen_split_function_size and unless for HLS
+	**/
+	virtual bool isSplitEnabled() const;
+
+	/**
+		\brief generates the solver split into part functions over several source files, see codegen_split_function_size
+
+		Header <model>.hpp defines the <model>_state structure, <model>_init, and <model>_step, which calls the parts in
+		order.  Source <model>.cpp defines the literals and initial state, and sources <model>_part<k>.cpp the parts,
+		all listed in <model>_sources.txt.  With a templated real type, the sources are instantiated for the real type
+		of macro LBLMC_SPLIT_REAL, double unless defined.  For CPU targets, so ignored with xilinx_hls_enable.
+
+		\param filename name of the header file of the solver, including directory path and file extension; the
+		sources are written next to it, named after it without its extension
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+		\throw std::runtime_error if batched or multi-step, or if the files cannot be written
+	**/
+	void generateSplitCFunctionAndExport(std::string filename, double zero_bound) const;
+
+	/**
+		\return true if the solve uses the SIMD kernel, as set by solve_simd_enable and unless batched
+	**/
+	bool isSIMDSolveEnabled() const;
+
+	/**
+		\brief creates the generator widening the code of the components over the batch of instances
+		\param parameter_list set to the widened parameter list of the batched solver, without its parameter structure argument
+		\return batch generator holding the widened variables of the components and the solver
+	**/
+	SystemBatchGenerator createBatchGenerator(std::string& parameter_list) const;
+
+	/**
+		\brief generates the solver function stepping codegen_batch_width instances in lockstep
+		\param out stream the C++ function definition is written to
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+	**/
+	void generateBatchedCFunction(std::ostream& out, double zero_bound) const;
+
+	/**
+		\return true if a multi-step solver function is generated, as set by codegen_multi_step_count
+	**/
+	bool isMultiStepEnabled() const;
+
+	/**
+		\brief generates the solver function running codegen_multi_step_count time steps per call
+
+		The function, <model>_solver_n or <model>_step_n with the state structure, loops over the step body with inputs
+		widened to arrays [...][K] of each step and outputs to arrays [...][K/D] of every D-th step, K being the step count
+		and D codegen_multi_step_decimation.  Without the state structure, it keeps its own fields apart from <model>_solver.
+
+		\param out stream the C++ function definition is written to
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+		\throw std::invalid_argument if codegen_multi_step_decimation is zero or does not divide codegen_multi_step_count
+	**/
+	void generateMultiStepCFunction(std::ostream& out, double zero_bound) const;
+
+	/**
+		\return true if generated code uses a fixed point type for each signal class picked by word-length analysis
+	**/
+	bool isWordLengthAnalysisEnabled() const;
+
+	/**
+		\brief picks the fixed point format of each signal class by worst-case range analysis of the solved system,
+		as set by the fixed_point_* parameters
+		\param zero_bound value indicating how close a solve matrix element must be to zero to be discarded
+		\return analyzer holding the picked formats
+	**/
+	SystemWordLengthAnalyzer analyzeWordLengths(double zero_bound) const;
+
+	/**
+		\return name of the C/C++ type of the given signal class in generated code; real unless word-length analysis is enabled
+	**/
+	std::string getSignalTypeName(SystemWordLengthAnalyzer::SignalClass signal_class) const;
+
+	/**
+		\return given component parameter code, with its literal parameters of the parameter class type if word-length
+		analysis is enabled
+	**/
+	std::string generateParameterCode(const std::string& code) const;
+
+	/**
+		\brief generates the code defining the real type(s) of generated code, as set by the fixed_point_* parameters
+		\param zero_bound value indicating how close a solve matrix element must be to zero to be discarded
+		\return string containing the code; empty with templated real type
+	**/
+	std::string generateRealTypeCode(double zero_bound) const;
+
+	/**
+		\brief generates code multiplying the solutions back by the divider of a rescaled solve matrix
+		\param dimension number of rows of the solved system
+		\param solved flags of solved solutions x[i]; empty if all are solved
+		\param solution_indices index of solution x[i] of each row; empty for x[r+1] of row r
+		\param divider divider the solve matrix is scaled by
+	**/
+	std::string generateSolutionRescaleCode(unsigned int dimension, const std::vector<bool>& solved,
+		const std::vector<unsigned int>& solution_indices, double divider) const;
+
 public:
 
 	/**
@@ -132,6 +469,23 @@ public:
 		unsigned int num_solutions
 	);
 
+	/**
+		\brief parameter constructor with generator parameters
+
+		Unlike setting the parameters after construction, the conductance matrix is never allocated dense
+		when solve_sparse_assembly_enable is set.
+
+		\param model_name string name of the model the engine is for; name must be C++ compatible label that is not null/empty
+		\param num_solutions the number of solutions the generated engine solves for
+		\param parameters parameters of the generator
+	**/
+	SolverEngineGenerator
+	(
+		std::string model_name,
+		unsigned int num_solutions,
+		const SolverEngineGeneratorParameters& parameters
+	);
+
 	/**
 		\brief copy constructor
 	**/
@@ -160,10 +514,44 @@ public:
 	**/
 	inline unsigned int getNumberOfSolutions() const { return num_solutions; }
 
-	inline void setParameters(SolverEngineGeneratorParameters param) { parameters = param; }
+	inline void setParameters(SolverEngineGeneratorParameters param)
+	{
+		parameters = param;
+		conductance_matrix_gen.setSparseAssemblyEnable(param.solve_sparse_assembly_enable);
+	}
 
 	const SolverEngineGeneratorParameters& getParameters() const { return parameters; }
 
+	/**
+		\brief sets the solutions x[i] the user observes from x_out, which dead solution elimination always keeps
+		\param probes indices of solutions x[i], from 1 to the number of solutions (index 0 is ground)
+		\throw std::out_of_range if any index is out of the range of solutions
+	**/
+	void setProbedSolutions(const std::vector<unsigned int>& probes);
+
+	inline const std::vector<unsigned int>& getProbedSolutions() const { return probed_solutions; }
+
+	/**
+		\brief finds the solutions x[i] observed by the generated solver
+
+		A solution is observed if the component update or output update code reads it, or it is probed.
+
+		\return flags indexed by solution x[i], with index 0 being ground; all true if the references
+		of component code cannot be resolved
+	**/
+	virtual std::vector<bool> findObservedSolutions() const;
+
+	/**
+		\return indices of solutions x[i] retained by the generated solver; all solutions unless
+		solve_kron_reduction_enable is true
+	**/
+	std::vector<unsigned int> findRetainedSolutions() const;
+
+	/**
+		\return number of solutions that Kron reduction would eliminate, whether or not it is enabled
+	**/
+	unsigned int getNumberOfKronReducibleSolutions() const;
+
 	/**
 		\return reference to generator's internal Conductance Matrix generator
 	**/
@@ -189,6 +577,13 @@ public:
 	**/
 	void insertComponentParametersCode(std::string& code);
 
+	/**
+		\brief inserts the names of literal parameters of a component that only set source or control values, which
+		instances of batched solvers may sweep (see Component::getSourceParameters())
+		\param names names of the parameters, as declared in the component's parameter code
+	**/
+	void insertComponentSourceParameters(const std::vector<std::string>& names);
+
 	/**
 		\brief inserts C++ code string for a component's fields (internal variables and states)
 
@@ -281,26 +676,89 @@ public:
 	**/
 	virtual std::string generateCFunctionParameterList() const;
 
+	/**
+		\brief generates a report of the multiply-accumulates (MACs) per time step of each supported
+		strategy to solve Gx=b, for choosing between them
+
+		The strategies reported are the product with dense inverted conductance matrix G^-1, the
+		forward/back substitution over sparse LU factors of G (see solve_sparse_lu_enable), the
+		product with fused source gain matrix (G^-1)*A (see solve_fused_source_gain_enable), and the
+		SIMD kernel product with dense G^-1 (see solve_simd_enable), and the table-driven product with
+		dense G^-1 (see solve_table_mac_threshold).  The number of solutions left
+		unobserved for solve_dead_solution_elimination_enable and the number of solutions eliminable
+		by solve_kron_reduction_enable are reported too, while the MAC counts are for the full system.
+		Systems with switched conductances only support the switch-state inverse bank, so the report
+		covers the bank instead (see SystemSwitchBankGenerator::generateReport()).
+
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+		\return string containing the report
+	**/
+	virtual std::string generateSolveStrategyReport(double zero_bound = 1.0e-12) const;
+
+	/**
+		\brief generates a report of the sparsity and worst-case solution error achieved by pruning the
+		solve matrix within the error budget set by the sparsify_* parameters
+		\param zero_bound value indicating how close a solve matrix element must be to zero to be discarded regardless of the budget
+		\return string containing the report; empty if sparsification is disabled, sparse LU is used, or the system has switched conductances
+	**/
+	std::string generateSparsificationReport(double zero_bound = 1.0e-12) const;
+
+	/**
+		\brief generates a report of the fixed point format picked for each signal class by word-length analysis
+		\param zero_bound value indicating how close a solve matrix element must be to zero to be discarded
+		\return string containing the report; empty unless fixed point with word-length analysis is enabled
+	**/
+	std::string generateWordLengthReport(double zero_bound = 1.0e-12) const;
+
 	/**
 		\brief generates valid C++ code string of the simulation engine that can be inlined into existing C++ code
 		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
 		\return string containing valid, inlineable C++ code for the simulation engine
 	**/
-    virtual std::string generateCInlineCode(double zero_bound = 1.0e-12) const;
+    std::string generateCInlineCode(double zero_bound = 1.0e-12) const;
+
+	/**
+		\brief writes valid C++ code of the simulation engine that can be inlined into existing C++ code to a stream
+
+		The code is written section by section, so memory held while generating scales with the largest section,
+		typically the literal solve matrix, rather than with the whole code.
+
+		\param out stream the inlineable C++ code for the simulation engine is written to
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+	**/
+	virtual void generateCInlineCode(std::ostream& out, double zero_bound = 1.0e-12) const;
 
     /**
 		\brief generates valid C++ code string of the simulation engine as a C++ function definition
 		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
 		\return string containing valid C++ function definition for the simulation engine
 	**/
-	virtual std::string generateCFunction(double zero_bound = 1.0e-12) const;
+	std::string generateCFunction(double zero_bound = 1.0e-12) const;
+
+	/**
+		\brief writes valid C++ code of the simulation engine as a C++ function definition to a stream
+		\param out stream the C++ function definition for the simulation engine is written to
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+	**/
+	virtual void generateCFunction(std::ostream& out, double zero_bound = 1.0e-12) const;
 
 	/**
 		\brief generates valid C++ code string of the simulation engine as a C++ function definition exported to a header file
+
+		With codegen_split_function_size, the solver is instead split over the header and several source files
+		next to it (see generateSplitCFunctionAndExport()).
+
 		\param filename name of the header file that will contain the engine definition, including directory path and file extension
 		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
 	**/
-	virtual void generateCFunctionAndExport(std::string filename, double zero_bound = 1.0e-12) const;
+	void generateCFunctionAndExport(std::string filename, double zero_bound = 1.0e-12) const;
+
+	/**
+		\brief writes the header file contents defining the simulation engine as a C++ function to a stream
+		\param out stream the header file contents are written to, such as an open file
+		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
+	**/
+	virtual void generateCFunctionAndExport(std::ostream& out, double zero_bound = 1.0e-12) const;
 
 };
 
@@ -30,6 +30,8 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SystemConductanceGenerator.hpp"
 #include "codegen/SystemSourceVectorGenerator.hpp"
 #include "codegen/SystemSolverGenerator.hpp"
+#include "codegen/SystemLUSolverGenerator.hpp"
+#include "codegen/SystemSIMDSolverGenerator.hpp"
 #include "codegen/SolverEngineGenerator.hpp"
 
 namespace lblmc
@@ -182,6 +184,12 @@ public:
 	**/
 	const Port& getPort(unsigned int id) const;
 
+	/**
+		\param id of the port
+		\return true if the subsystem has a port of given id
+	**/
+	bool hasPort(unsigned int id) const;
+
 	/**
 		\return ports of the subsystem which for a solver engine will be generated
 	**/
@@ -203,7 +211,9 @@ public:
 		\brief stamps the port model of another subsystem into this subsystem's set of equations
 
 		This method takes the port model of another subsystem and adds its contributions
-		to the conductance and source vector of this subsystem
+		to the conductance and source vector of this subsystem.  Transconductances from ports
+		of the other subsystem that this subsystem does not have, such as those to a third
+		subsystem, are left out.
 
 		\param port_model port model from other subsystem
 	**/
@@ -271,6 +281,22 @@ public:
 	**/
 	std::string generatePortSourceOutputParameterList() const;
 
+	/**
+		\brief finds the solutions x[i] observed by the generated solver
+
+		In addition to those observed by SolverEngineGenerator::findObservedSolutions(), the terminal
+		voltages of the subsystem's ports are observed, as they interface the subsystem to the rest of
+		a system.
+
+		\return flags indexed by solution x[i], with index 0 being ground
+	**/
+	std::vector<bool> findObservedSolutions() const;
+
+	/**
+		\return false, as subsystem solvers are generated as single headers
+	**/
+	bool isSplitEnabled() const;
+
 	/**
 		\brief generates valid parameter (argument) list for the simulation engine top-level function
 
@@ -282,26 +308,30 @@ public:
 	**/
 	std::string generateCFunctionParameterList() const;
 
+	using SolverEngineGenerator::generateCInlineCode;
+	using SolverEngineGenerator::generateCFunction;
+	using SolverEngineGenerator::generateCFunctionAndExport;
+
 	/**
-		\brief generates valid C++ code string of the simulation engine that can be inlined into existing C++ code
+		\brief writes valid C++ code of the simulation engine that can be inlined into existing C++ code to a stream
+		\param out stream the inlineable C++ code for the simulation engine is written to
 		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
-		\return string containing valid, inlineable C++ code for the simulation engine
 	**/
-    std::string generateCInlineCode(double zero_bound = 1.0e-12) const;
+	void generateCInlineCode(std::ostream& out, double zero_bound = 1.0e-12) const;
 
-    /**
-		\brief generates valid C++ code string of the simulation engine as a C++ function definition
+	/**
+		\brief writes valid C++ code of the simulation engine as a C++ function definition to a stream
+		\param out stream the C++ function definition for the simulation engine is written to
 		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
-		\return string containing valid C++ function definition for the simulation engine
 	**/
-	std::string generateCFunction(double zero_bound = 1.0e-12) const;
+	void generateCFunction(std::ostream& out, double zero_bound = 1.0e-12) const;
 
 	/**
-		\brief generates valid C++ code string of the simulation engine as a C++ function definition exported to a header file
-		\param filename name of the header file that will contain the engine definition, including directory path and file extension
+		\brief writes the header file contents defining the simulation engine as a C++ function to a stream
+		\param out stream the header file contents are written to, such as an open file
 		\param zero_bound value indicating how close a system conductance matrix element must be to zero to be discarded for reduced calculations
 	**/
-	void generateCFunctionAndExport(std::string filename, double zero_bound = 1.0e-12) const;
+	void generateCFunctionAndExport(std::ostream& out, double zero_bound = 1.0e-12) const;
 
 };
 
@@ -0,0 +1,242 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef SYSTEMBATCHGENERATOR_HPP
+#define SYSTEMBATCHGENERATOR_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+#include "codegen/SystemStateGenerator.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief Rewrites the single-instance code of a generated solver to step W independent instances in lockstep
+
+	Each variable of an instance is widened into structure-of-arrays layout, with the instance index w
+	as its last, contiguous dimension:
+
+	<pre>
+	static real current_l0 = 0.0;         ->  static real current_l0[W];       current_l0[w]
+	static real x[N];                     ->  static real x[N][W];             x[i][w]
+	real* l_current_l0                    ->  real l_current_l0[W]             *l_current_l0 -> l_current_l0[w]
+	real u_in[3]                          ->  real u_in[3][W]                  u_in[k][w]
+	const static real SRC_CURRENT_i0 = 1; ->  params.SRC_CURRENT_i0[w]
+	</pre>
+
+	Static fields are initialized for every instance on the first call.  Real source parameters, which only
+	set source or control values (see Component::getSourceParameters()), move into a parameter structure with
+	an array of W values per parameter, defaulting to their netlist values, so that the instances can sweep
+	them.  All other parameters stay shared literals: the instances share one solve matrix computed from the
+	parameters stamped into the conductance matrix, such as companion conductances, and from those derived
+	from them, so these cannot differ between instances.  Fields without static storage, such as
+	temporaries, are declared within the loop over the instances.
+
+	Code wrapped by generateLoop() runs once per instance, with its references to the widened variables
+	indexed by w.  Since instances are contiguous, such a loop over a solve x=M*b broadcasts each literal
+	element of M over a vector of instances, turning the matrix-vector product of one instance into a
+	matrix-matrix product over the batch that compilers vectorize across instances.
+
+	The same rewriting widens the arguments of a solver stepping several time steps per call over its
+	time steps, with the inputs and outputs of each step indexed by expressions of the step index.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class SystemBatchGenerator
+{
+public:
+
+	static const std::string INDEX; ///< name of the instance index in generated loops
+	static const std::string PARAMETERS; ///< name of the parameter structure argument of the batched solver
+
+private:
+
+	/**
+		\brief kinds of references widened by the batch
+	**/
+	enum VariableKind
+	{
+		VALUE = 0, ///< variable or array, indexed as name[...][w]
+		POINTER, ///< pointer argument to an instance value, dereferenced as name[w]
+		PARAMETER ///< member of the parameter structure, as params.name[w]
+	};
+
+	typedef SystemStateGenerator::Field Field; ///< static field of an instance, widened into an array over the instances
+
+	unsigned int width; ///< number of instances W
+	std::map<std::string, VariableKind> variables; ///< widened variables by name
+	std::map<std::string, std::string> indices; ///< index expressions of the widened variables not indexed by INDEX
+	std::vector<Field> fields; ///< static fields of the instances
+	std::set<std::string> source_parameters; ///< names of parameters that may differ between instances
+	std::vector<std::pair<std::string, std::string> > parameters; ///< names and default values of per-instance parameters
+	std::string shared_code; ///< parameters shared by all instances
+	std::string local_code; ///< declarations of fields without static storage, made per instance
+
+public:
+
+	SystemBatchGenerator();
+
+	/**
+		\brief parameter constructor
+		\param width number of instances W stepped in lockstep; must be nonzero
+		\throw std::invalid_argument if width is zero
+	**/
+	explicit SystemBatchGenerator(unsigned int width);
+
+	SystemBatchGenerator(const SystemBatchGenerator& base) = default;
+
+	/**
+		\brief resets the generator to widen no variables
+		\param width number of instances W stepped in lockstep; must be nonzero
+		\throw std::invalid_argument if width is zero
+	**/
+	void reset(unsigned int width);
+
+	inline unsigned int getWidth() const { return width; }
+
+	/**
+		\brief widens a variable or array declared by the caller, such as the solution vector x
+		\param name name of the variable
+	**/
+	void insertVariable(const std::string& name);
+
+	/**
+		\brief marks literal parameters of components as source parameters, which become per-instance parameters
+		\param names names of the parameters, as given to SolverEngineGenerator::insertComponentSourceParameters()
+	**/
+	void insertSourceParameters(const std::vector<std::string>& names);
+
+	/**
+		\brief inserts literal parameters of components, as given to SolverEngineGenerator::insertComponentParametersCode()
+
+		Declarations "const static real name = value;" of source parameters become per-instance parameters;
+		all other declarations are kept as parameters shared by all instances.
+
+		\throw std::runtime_error if the code has declarations that cannot be parsed
+	**/
+	void insertParameters(const std::string& code);
+
+	/**
+		\brief inserts fields of components, as given to SolverEngineGenerator::insertComponentFieldsCode()
+		\throw std::runtime_error if the code has declarations that cannot be parsed
+	**/
+	void insertFields(const std::string& code);
+
+	/**
+		\brief widens an argument list of input or output signals, as given to
+		SolverEngineGenerator::insertComponentInputsCode() or SolverEngineGenerator::insertComponentOutputsCode()
+		\return argument list with each argument widened over the instances
+		\throw std::runtime_error if an argument cannot be parsed
+	**/
+	std::string insertArguments(const std::string& arguments);
+
+	/**
+		\brief widens an argument list over a given length, indexed by a given expression, such as the
+		arguments of a solver stepping several time steps per call
+		\param arguments argument list, as given to SolverEngineGenerator::insertComponentInputsCode()
+		\param length length of the dimension appended to each argument
+		\param index expression indexing the appended dimension in code rewritten by batchCode()
+		\return argument list with each argument widened over the given length
+		\throw std::runtime_error if an argument cannot be parsed
+	**/
+	std::string insertArguments(const std::string& arguments, unsigned int length, const std::string& index);
+
+	/**
+		\return code declaring the parameters shared by all instances
+	**/
+	inline const std::string& getSharedParametersCode() const { return shared_code; }
+
+	/**
+		\return code declaring the fields without static storage of one instance, for use within a
+		loop generated by generateLoop()
+	**/
+	inline const std::string& getLocalFieldsCode() const { return local_code; }
+
+	/**
+		\return true if any real parameters were inserted
+	**/
+	inline bool hasParameters() const { return !parameters.empty(); }
+
+	/**
+		\brief generates the parameter structure, with W values of each real parameter defaulting to its
+		netlist value
+		\param struct_name name of the structure
+		\param templated_real true if the structure is templated on the real type
+		\return string containing the structure definition
+	**/
+	std::string generateParametersStruct(const std::string& struct_name, bool templated_real) const;
+
+	/**
+		\return code declaring the widened static fields, without initializers
+	**/
+	std::string generateFieldDeclarations() const;
+
+	/**
+		\return code initializing the static fields of every instance on the first call
+	**/
+	std::string generateFieldInitializationCode() const;
+
+	/**
+		\brief rewrites code of one instance to index the widened variables by the instance index
+		\param code C++ code of one instance; comments and literals are kept as is
+		\return rewritten code
+	**/
+	std::string batchCode(const std::string& code) const;
+
+	/**
+		\brief generates a loop over the instances running the given code of one instance
+		\param code C++ code of one instance, rewritten by batchCode()
+		\return string containing the loop
+	**/
+	std::string generateLoop(const std::string& code) const;
+
+	/**
+		\brief generates a loop running the given code a given number of times
+		\param code C++ code of one iteration, rewritten by batchCode()
+		\param count number of iterations
+		\param index name of the loop index
+		\return string containing the loop
+	**/
+	std::string generateLoop(const std::string& code, unsigned int count, const std::string& index) const;
+
+private:
+
+	/**
+		\return expression indexing the widened dimension of the given variable
+	**/
+	std::string getIndex(const std::string& name) const;
+};
+
+} //namespace lblmc
+
+#endif //SYSTEMBATCHGENERATOR_HPP
@@ -0,0 +1,99 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef LBLMC_SYSTEMBINARYMATRIXGENERATOR_HPP
+#define LBLMC_SYSTEMBINARYMATRIXGENERATOR_HPP
+
+#include <string>
+#include <vector>
+
+namespace lblmc
+{
+
+/**
+	\brief Stores solve matrices in binary files loaded by generated solvers, instead of literal arrays
+
+	A dense solve matrix of a large system, such as G^-1, takes millions of elements that compilers parse
+	slowly and with gigabytes of memory when given as a literal array.  This generator instead writes the
+	elements into a binary file and generates code declaring a static array that the solver fills from the
+	file on its first call.  The generated code then compiles quickly, and the matrix can be replaced by
+	rewriting the file without recompiling.
+
+	The binary file holds the 8 byte magic LBLMCMAT, the number of elements as an 8 byte unsigned integer,
+	and the elements as 8 byte doubles, all in the byte order of the machine generating the code.
+
+	The loader, emitted once per header by generateLoaderCode(), opens the file in the directory given by
+	macro LBLMC_BINARY_MATRIX_DIR, which is the current directory unless defined before the header is
+	included, and converts each element to the real type of the array.  If the file is missing or does not
+	hold the expected number of elements, the loader zeroes the array and lblmc_binary_matrices_loaded()
+	returns false thereafter, leaving the caller of the solver to decide how to handle the failure.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class SystemBinaryMatrixGenerator
+{
+public:
+
+	/**
+		\brief writes the elements of a matrix to a binary file
+		\param filename name of the binary file, including directory path and file extension
+		\param M elements of the matrix, in the order the array in generated code stores them
+		\param count number of elements
+		\throw std::runtime_error if the file cannot be opened or written
+	**/
+	static void exportBinary(std::string filename, const double* M, unsigned long count);
+
+	/**
+		\brief generates the binary matrix loader shared by all generated solvers
+
+		The code is include-guarded by LBLMC_BINARY_MATRIX_LOADER, so it can be emitted at file scope of every
+		generated header that uses it.  It defines macro LBLMC_BINARY_MATRIX_DIR unless already defined, function
+		lblmc_binary_matrices_loaded(), and function template lblmc_load_binary_matrix(filename, M, count).
+
+		\return string containing the generated code
+	**/
+	static std::string generateLoaderCode();
+
+	/**
+		\brief generates code declaring a static array loaded from a binary file on the first call of the solver
+		\param M_name C/C++ compatible name for the matrix array
+		\param dimensions sizes of each dimension of the array
+		\param filename name of the binary file, without directory path, as found in LBLMC_BINARY_MATRIX_DIR
+		\param type_name C/C++ type of the array elements; default is real
+		\param prefix code preceding the declaration, such as an alignment attribute; default is empty
+		\return string containing the generated code
+	**/
+	static std::string generateLoadCode(std::string M_name, const std::vector<unsigned long>& dimensions, std::string filename,
+		std::string type_name = "real", std::string prefix = "");
+
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_SYSTEMBINARYMATRIXGENERATOR_HPP
@@ -29,12 +29,44 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 
 #include <vector>
 #include <string>
+#include <ostream>
+#include <memory>
+#include <mutex>
+
+#include <Eigen/SparseLU>
 
 #include "codegen/CodeGenDataTypes.hpp"
 
 namespace lblmc
 {
 
+/**
+	\brief Describes a conductance between two nodes that depends on the state of a switch
+
+	Switched conductances are not stamped into the conductance matrix itself, but kept aside by
+	SystemConductanceGenerator so that the matrix of each switch state can be formed from them.
+
+	\see SystemConductanceGenerator::stampSwitchedConductance()
+	\see SystemSwitchBankGenerator
+**/
+class SwitchedConductance
+{
+
+public:
+
+	unsigned int p;          ///< index of the node where positive terminal of conductance resides
+	unsigned int n;          ///< index of the node where negative terminal of conductance resides
+	double on_conductance;   ///< conductance when switch is on (closed)
+	double off_conductance;  ///< conductance when switch is off (open)
+	std::string state;       ///< C/C++ boolean expression of switch state in generated code, true when on
+
+	SwitchedConductance() :
+		p(0), n(0), on_conductance(0.0), off_conductance(0.0), state() {}
+
+	SwitchedConductance(unsigned int p, unsigned int n, double on_conductance, double off_conductance, std::string state) :
+		p(p), n(n), on_conductance(on_conductance), off_conductance(off_conductance), state(state) {}
+};
+
 /**
 	\brief Generates the square conductance matrix for a system model simulated in LB-LMC
 
@@ -48,14 +80,85 @@ namespace lblmc
 	the matrix can be exported by this class's instances to file or memory to be processed for
 	development of a LB-LMC simulation engine that is RTL synthesizable.
 
+	The LU factorization and inverse of the matrix are computed on first use and cached until the
+	matrix is changed by a stamp, reset, reduction, inversion, or import method, or through the
+	non-const accessors asPointer(), asArray(), and asEigen3Matrix().  Copies of a generator share
+	its cache until either changes its matrix, so solvers generated repeatedly from copies of the
+	same system factor its matrix only once.
+
+	For large systems, the generator can assemble the matrix sparsely instead (see
+	setSparseAssemblyEnable()), with the stamp methods collecting the stamps as triplets that are
+	summed into a compressed sparse row (CSR) matrix on use, so that stamping a system of n nodes takes
+	memory in proportion to its stamps rather than n*n.  isInvertible() then factors the sparse matrix
+	with a sparse LU, and asSparseMatrix() gives the matrix to consumers that work on it sparsely, such as
+	SystemLUSolverGenerator.  The const dense accessors and the methods that need the dense matrix, such as
+	getInverse(), spy(), and the export methods, work on a dense copy made on demand, while the non-const
+	dense accessors, kronReduce(), invertSelf(), and importFromASCIIMatlab() return the generator to dense
+	assembly, as their results are generally dense.
+
 	\note This class is NOT intended for RTL Synthesis.
 
  **/
 class SystemConductanceGenerator
 {
 private:
-	MatrixRMXd matrix;
+
+	/**
+		\brief LU factorization and inverse of the matrix, computed on first use
+	**/
+	struct Factorization
+	{
+		std::mutex mutex; ///< guards computation of the members below
+		std::unique_ptr< Eigen::FullPivLU<MatrixRMXd> > lu; ///< full pivot LU factorization of matrix; null until computed
+		std::unique_ptr<MatrixRMXd> inverse; ///< inverse of matrix; null until computed
+		std::unique_ptr< Eigen::SparseLU< Eigen::SparseMatrix<double> > > sparse_lu; ///< sparse LU factorization of matrix in sparse assembly; null until computed
+	};
+
+	mutable MatrixRMXd matrix; ///< matrix in dense assembly; in sparse assembly, empty or a dense copy of sparse_matrix made on demand
 	unsigned int dimension;
+	bool sparse_assembly_enable; ///< whether the matrix is assembled sparsely in sparse_matrix instead of matrix
+	mutable std::vector< Eigen::Triplet<double> > triplets; ///< stamps not yet summed into sparse_matrix, in sparse assembly
+	mutable SparseMatrixRMXd sparse_matrix; ///< matrix in sparse assembly, up to the stamps in triplets
+	mutable bool dense_current; ///< whether matrix holds a current dense copy of sparse_matrix, in sparse assembly
+	std::vector<SwitchedConductance> switched_conductances; ///< conductances depending on switch states; not stamped in matrix
+	std::shared_ptr<Factorization> factorization; ///< cached factorization of matrix, shared by copies until either changes its matrix
+
+	/**
+		\brief discards the cached factorization and inverse, and any dense copy of the sparse matrix, as the matrix is about to change
+	**/
+	void invalidateFactorization();
+
+	/**
+		\brief computes the LU factorization of the matrix into the cache if not already computed
+		\note the mutex of the cache must be held by the caller
+	**/
+	void factorize() const;
+
+	/**
+		\brief computes the sparse LU factorization of the matrix into the cache if not already computed
+		\note the mutex of the cache must be held by the caller
+	**/
+	void factorizeSparse() const;
+
+	/**
+		\brief sums the stamps collected in sparse assembly into the sparse matrix, dropping exact zeros
+	**/
+	void assemble() const;
+
+	/**
+		\return the dense matrix, made from the sparse matrix first in sparse assembly
+	**/
+	const MatrixRMXd& denseMatrix() const;
+
+	/**
+		\brief adds a value to an element of the matrix, for stamping
+	**/
+	void addElement(unsigned int r, unsigned int c, double value);
+
+	/**
+		\brief sets an element of the matrix, for stamping
+	**/
+	void setElement(unsigned int r, unsigned int c, double value);
 
 public:
 
@@ -64,8 +167,10 @@ public:
 	/**
 	 * parameter constructor
 	 * \param dimension non-zero dimension of square conductance matrix (length or width)
+	 * \param sparse_assembly_enable assemble the matrix sparsely (see setSparseAssemblyEnable()),
+	 * without allocating the dense matrix; defaults to false
 	 */
-	SystemConductanceGenerator(unsigned int dimension);
+	SystemConductanceGenerator(unsigned int dimension, bool sparse_assembly_enable = false);
 
 	/**
 	 * initialization constructor
@@ -110,8 +215,36 @@ public:
 	 */
 	void reset(const SystemConductanceGenerator& base);
 
+	/**
+		\brief sets whether the matrix is assembled sparsely
+
+		In sparse assembly, stamps are collected as triplets and summed into a compressed sparse row
+		matrix on use, instead of into the dense matrix.  Switching the assembly converts the matrix
+		stamped so far.
+
+		\param enable true for sparse assembly; false for dense assembly
+	**/
+	void setSparseAssemblyEnable(bool enable);
+
+	inline bool isSparseAssemblyEnabled() const { return sparse_assembly_enable; }
+
+	/**
+		\brief gets the conductance matrix as a compressed sparse row matrix, without exact zeros
+
+		In dense assembly, the sparse matrix is made from the dense matrix.
+
+		\return sparse conductance matrix
+	**/
+	SparseMatrixRMXd asSparseMatrix() const;
+
 	/**
 	 * returns conductance matrix as an observer pointer
+	 *
+	 * In sparse assembly, the generator is returned to dense assembly first.
+	 *
+	 * As the matrix can be changed through the pointer, the cached factorization is discarded;
+	 * the pointer should not be used to change the matrix after the factorization is computed again.
+	 *
 	 * \return pointer to conductance matrix data
 	 */
 	double* asPointer();
@@ -129,10 +262,20 @@ public:
 
 	/**
 	 * returns the conductance matrix as a Eigen3 Matrix Type
+	 *
+	 * As with asPointer(), the generator is returned to dense assembly, and the cached factorization is discarded.
+	 *
 	 * \return
 	 */
 	MatrixRMXd& asEigen3Matrix();
 
+	/**
+	 * returns the conductance matrix as a Eigen3 Matrix Type
+	 *
+	 * In sparse assembly, this is a dense copy of the sparse matrix made on demand, valid until the matrix is changed.
+	 *
+	 * \return
+	 */
 	const MatrixRMXd& asEigen3Matrix() const;
 
 	/**
@@ -211,6 +354,46 @@ public:
 	**/
 	void stampPartialConductance(double conductance, unsigned int r, unsigned int c);
 
+	/**
+		\brief stamps a conductance that depends on the state of a switch for given node indices
+
+		The conductance is not stamped into the conductance matrix, which holds only the conductances that
+		are independent of switch states.  The matrix of a given switch state is formed by
+		asSwitchStateEigen3Matrix().  Switches are numbered in the order they are stamped, and the state of
+		switch s is bit s of a packed switch state.
+
+		<pre>
+		p ---/\/\/\--- /---- n
+		</pre>
+
+		\param on_conductance the conductance when switch is on (closed)
+		\param off_conductance the conductance when switch is off (open); can be zero for ideal switches
+		\param p the index of the node where positive terminal of conductance resides
+		\param n the index of the node where negative terminal of conductance resides
+		\param state C/C++ boolean expression of the switch state in generated code, true when on; usually
+		a switch input or temporary of the component that is set before the system is solved
+		\throw std::invalid_argument if node indices are outside dimension of conductance matrix or equal,
+		if on and off conductances are equal, or if state is empty
+	**/
+	void stampSwitchedConductance(double on_conductance, double off_conductance, unsigned int p, unsigned int n, std::string state);
+
+	/**
+		\return conductances stamped by stampSwitchedConductance(), in switch order
+	**/
+	inline const std::vector<SwitchedConductance>& getSwitchedConductances() const { return switched_conductances; }
+
+	/**
+		\return number of switches with conductances stamped by stampSwitchedConductance()
+	**/
+	inline unsigned int getNumberOfSwitches() const { return switched_conductances.size(); }
+
+	/**
+		\brief forms the conductance matrix of the system for the given switch state
+		\param switch_state packed switch state, with bit s set if switch s is on
+		\return conductance matrix with the switched conductances stamped for the state
+	**/
+	MatrixRMXd asSwitchStateEigen3Matrix(unsigned long switch_state) const;
+
 	/**
 		\brief stamps the incidence constants for an ideal voltage source into conductance matrix
 		for	modified nodal analysis
@@ -223,19 +406,95 @@ public:
 	**/
 	void stampIdealVoltageSourceIncidence(unsigned int solution_id, unsigned int p, unsigned int n);
 
+	/**
+		\brief gets the full pivot LU factorization of the conductance matrix, computed on first use and cached
+
+		This is a dense factorization, even in sparse assembly.
+
+		\return factorization of the matrix, valid until the matrix is changed
+	**/
+	const Eigen::FullPivLU<MatrixRMXd>& getFactorization() const;
+
+	/**
+		\brief gets the inverse of the conductance matrix, computed on first use and cached
+
+		In sparse assembly, the inverse is solved from the sparse LU factorization of the matrix.
+
+		\throw std::runtime_error if matrix is singular (non-invertible)
+		\return inverse of the matrix, valid until the matrix is changed
+	**/
+	const MatrixRMXd& getInverse() const;
+
+	/**
+		\brief gets the selected elements of the inverse of the conductance matrix, leaving the rest zero
+
+		Only the elements in both a selected row and a selected column are computed, as needed by a solve
+		x=(G^-1)*b that solves only some solutions x[i] from a source vector b with sources at only some
+		rows.  The matrix is factored once with a sparse LU, which is cached, and the selected columns of
+		G^-1, or the selected rows by the transposed factors if there are fewer of them, are solved in
+		blocks distributed over a pool of threads.
+
+		\param rows flags indexed by row of G^-1 of rows to compute; all rows if empty
+		\param cols flags indexed by column of G^-1 of columns to compute; all columns if empty
+		\param num_threads number of threads solving the blocks; number of hardware threads if zero
+		\throw std::runtime_error if matrix is singular (non-invertible)
+		\return inverse of the matrix with only the selected elements computed, and the rest zero
+	**/
+	MatrixRMXd getSelectedInverse(const std::vector<bool>& rows, const std::vector<bool>& cols, unsigned int num_threads = 0) const;
+
 	/**
 		\brief checks if generated matrix is invertible (non-singular)
+
+		In sparse assembly, the matrix is checked by its sparse LU factorization, which fails on a zero
+		pivot, without making the dense matrix.
+
 		\return true if invertible (non-singular); false if non-invertible (singular)
 	**/
 	bool isInvertible() const;
 
+	/**
+		\brief eliminates the given solutions from the system Gx=b by Kron reduction
+
+		The conductance matrix is replaced with the Schur complement G' = Grr - Gre*(Gee^-1)*Ger, where r are
+		the retained and e the eliminated solutions.  Provided the source vector b has no sources at the
+		eliminated solutions, the reduced system G'x'=b' yields the same retained solutions as Gx=b.
+
+		Switched conductances are renumbered onto the retained solutions, as they are added to the
+		retained submatrix Grr only.
+
+		In sparse assembly, the generator is returned to dense assembly, as the reduced matrix is generally dense.
+
+		\param eliminated flags indexed by solution x[i] of solutions to eliminate, with index 0 being ground
+		\return original index of solution x[i] for each row of the reduced matrix, in order
+		\throw std::invalid_argument if all solutions would be eliminated, or if a switched conductance is
+		connected to an eliminated solution
+		\throw std::runtime_error if the conductance submatrix Gee of the eliminated solutions is singular
+	**/
+	std::vector<unsigned int> kronReduce(const std::vector<bool>& eliminated);
+
 	/**
 	 * inverts the conductance matrix and stores the result into itself
+	 *
+	 * In sparse assembly, the generator is returned to dense assembly, as the inverse is generally dense.
+	 *
 	 * \throw std::runtime_error if matrix is singular (non-invertible)
 	 * \see isInvertible() to check if matrix is invertible
 	 */
 	void invertSelf();
 
+	/**
+	 * inverts the selected elements of the conductance matrix and stores the result into itself
+	 *
+	 * The elements outside the selected rows and columns are left zero; see getSelectedInverse().
+	 * In sparse assembly, the generator is returned to dense assembly, as with invertSelf().
+	 *
+	 * \param rows flags indexed by row of G^-1 of rows to compute; all rows if empty
+	 * \param cols flags indexed by column of G^-1 of columns to compute; all columns if empty
+	 * \param num_threads number of threads solving the inverse; number of hardware threads if zero
+	 * \throw std::runtime_error if matrix is singular (non-invertible)
+	 */
+	void invertSelectedSelf(const std::vector<bool>& rows, const std::vector<bool>& cols, unsigned int num_threads = 0);
+
 	/**
 		\brief inverts the conductance matrix and returns the result
 
@@ -315,6 +574,8 @@ public:
 	 * In this version, the imported matrix from the file is expected to be square and same dimension as this object.
 	 * Also, this version does not check the file for proper formatting, so beware!
 	 *
+	 * In sparse assembly, the generator is returned to dense assembly.
+	 *
 	 * @param filename filename of the matlab ASCII text file from which to import the matrix
 	 */
 	void importFromASCIIMatlab(std::string filename);
@@ -329,6 +590,19 @@ public:
 	**/
 	std::string asCLiteral(std::string mat_name) const;
 
+	/**
+		\brief writes the conductance matrix as C/C++ code definition for a literal (const static) array to a stream
+
+		The definition is written row by row, so no copy of the whole definition is held in memory.  Elements are
+		formatted in their shortest round-trip form by RealLiteralFormatter, with the rows spread over threads.
+
+		\param out stream the code definition of the literal array is written to
+		\param mat_name C/C++ compatible name for the matrix array; with no spaces
+		\param type_name C/C++ type of the array elements; default is real
+		\param num_threads number of threads formatting the rows; 0 uses the number of hardware threads
+	**/
+	void asCLiteral(std::ostream& out, std::string mat_name, std::string type_name = "real", unsigned int num_threads = 0) const;
+
 };
 
 } //namespace lblmc
@@ -0,0 +1,140 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef LBLMC_SYSTEMDIRECTIVEGENERATOR_HPP
+#define LBLMC_SYSTEMDIRECTIVEGENERATOR_HPP
+
+#include <string>
+#include <vector>
+
+namespace lblmc
+{
+
+/**
+	\brief Generates Xilinx HLS directives of a solver for a target pipeline initiation interval
+
+	A solver pipelined to an initiation interval (II) of n clock cycles starts a new time step every n
+	cycles, so every array it accesses must supply the accesses of a step within n cycles.  An array
+	left whole is one memory of MEMORY_PORTS ports, so this generator partitions each array into
+
+		banks = ceil(accesses per step / (ports * II))
+
+	banks, starting from its last dimension: a dimension of at most as many elements as the banks left
+	to make is partitioned completely, and the first dimension that is larger is partitioned cyclically
+	by the banks left.  For instance, inv_g[40][40] read 1600 times per step is partitioned completely
+	in its second dimension and cyclically by 20 in its first for II=1, and completely in its second
+	dimension alone for II=20.
+
+	Pipelining the solver unrolls every loop within it, so the loops of the components over their
+	submodules, marked by UNROLL_PLACEHOLDER in their code, are unrolled to match.  Without a target II,
+	the solver is left unpipelined, the arrays whole, and each marked loop pipelined to start one
+	submodule per cycle instead.
+
+	\note This class is intended for RTL Synthesis only.
+**/
+class SystemDirectiveGenerator
+{
+public:
+
+	const static unsigned int MEMORY_PORTS = 2; ///< ports of each bank of an array partitioned within the solver, as of dual-port block RAM
+	static const std::string UNROLL_PLACEHOLDER; ///< comment marking the body of a loop of component code over its submodules
+
+private:
+
+	unsigned int init_interval; ///< target pipeline initiation interval II of the solver in clock cycles; 0 if not pipelined
+
+public:
+
+	SystemDirectiveGenerator();
+
+	/**
+		\brief parameter constructor
+		\param init_interval target pipeline initiation interval II of the solver in clock cycles; 0 to not pipeline the solver
+	**/
+	explicit SystemDirectiveGenerator(unsigned int init_interval);
+
+	SystemDirectiveGenerator(const SystemDirectiveGenerator& base) = default;
+
+	inline unsigned int getInitInterval() const { return init_interval; }
+
+	inline void setInitInterval(unsigned int init_interval) { this->init_interval = init_interval; }
+
+	/**
+		\param accesses number of reads and writes of an array per time step
+		\param ports number of ports of each bank
+		\return number of banks the array is partitioned into to supply its accesses within the target II; 1 if not pipelined
+	**/
+	unsigned long getNumberOfBanks(unsigned long accesses, unsigned int ports = MEMORY_PORTS) const;
+
+	/**
+		\return pipeline directive of the solver for the target II; empty if not pipelined
+	**/
+	std::string generatePipelineCode() const;
+
+	/**
+		\brief replaces the UNROLL_PLACEHOLDER comments of component code with loop directives
+
+		Marked loops are unrolled within a pipelined solver, or else pipelined with II=1.
+
+		\param code component code, such as an update body
+		\return code with the directives in place of the placeholders
+	**/
+	std::string generateLoopCode(const std::string& code) const;
+
+	/**
+		\brief generates the partition directives of an array for the target II
+		\param name name of the array
+		\param dimensions number of elements of each dimension of the array
+		\param accesses number of reads and writes of the array per time step
+		\param ports number of ports of each bank
+		\return string containing one directive per partitioned dimension; empty if the array is left whole
+	**/
+	std::string generateArrayPartitionCode(const std::string& name, const std::vector<unsigned long>& dimensions,
+		unsigned long accesses, unsigned int ports = MEMORY_PORTS) const;
+
+	/**
+		\brief generates the interface directives of every port of a solver function
+
+		Array ports are memory interfaces, partitioned for the target II as single port memories of which
+		every element is read or written once per call.  With several iterations of the pipeline per call,
+		the last dimension of array ports is taken as indexed by the iteration, as the time step of the
+		arrays of a multi-step solver, so each iteration accesses one slice of the other dimensions.
+		Ports passed by reference or pointer are outputs with valid signals, and ports passed by value are
+		plain inputs.  The block-level handshake of the function is its return port.
+
+		\param parameter_list parameter list of the solver function
+		\param iterations number of times the pipeline starts per call, such as the time steps of a loop; 1 if the function itself is pipelined
+		\return string containing the generated directives
+	**/
+	std::string generateInterfaceCode(const std::string& parameter_list, unsigned int iterations = 1) const;
+};
+
+} //namespace lblmc
+
+#endif //LBLMC_SYSTEMDIRECTIVEGENERATOR_HPP
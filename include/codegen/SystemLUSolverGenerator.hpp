@@ -0,0 +1,221 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef SYSTEMLUSOLVERGENERATOR_HPP
+#define SYSTEMLUSOLVERGENERATOR_HPP
+
+#include <vector>
+#include <string>
+#include <map>
+#include <ostream>
+
+#include "codegen/CodeGenDataTypes.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief Generates solver code for Gx=b by forward and back substitution over sparse LU factors of G
+
+	Unlike SystemSolverGenerator, which multiplies the source vector b by the dense inverted
+	conductance matrix G^-1, this generator orders the conductance matrix G with an approximate
+	minimum degree (AMD) ordering to reduce fill-in, factors the ordered matrix once at code
+	generation time into L*U, and emits unrolled forward and back substitution statements that
+	refer only to the nonzero elements of the factors L and U.
+
+	For sparse system networks, whose inverted conductance matrix is nearly fully dense, the
+	substitution requires far fewer multiply-accumulates (MACs) than the dense product x=(G^-1)*b.
+
+	G may be given as a compressed sparse row matrix, such as from
+	SystemConductanceGenerator::asSparseMatrix(), and the factors are kept as rows of their nonzero
+	elements, so the factoring takes memory and time in proportion to the nonzeros of the factors
+	rather than the square of the dimension.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class SystemLUSolverGenerator
+{
+private:
+	std::vector< std::map<unsigned int, double> > lu; ///< rows of nonzero elements of combined factors of ordered G by column; strictly lower part is L (unit diagonal implied), upper part is U
+	std::vector<unsigned int> row_order; ///< original row index of G (and b) for each row of the factors
+	std::vector<unsigned int> col_order; ///< original column index of G (and x) for each column of the factors
+	unsigned int dimension; ///< number of solutions in the system Gx=b
+	double zero_bound; ///< range from zero when determining whether factor elements are close to zero to be ignored; defaults to 1e-12.
+	unsigned int adder_tree_fan_in; ///< fan-in of balanced adder trees summing each substitution row in generated code; <2 for linear sums; defaults to 0.
+	std::vector<bool> solved; ///< flags of solutions x[i] (index 0 is ground) required from generated code; empty to solve all
+	std::vector<unsigned int> solution_indices; ///< index of solution x[i] computed by each row of G; empty for x[r+1] of row r
+
+public:
+
+	SystemLUSolverGenerator();
+
+	/**
+	 * parameter constructor
+	 *
+	 * Orders and factors the given conductance matrix.
+	 *
+	 * \param G the conductance matrix of Gx=b
+	 * \param zero_bound range from zero when determining whether factor elements are close to zero to be ignored; defaults to 1e-12.
+	 * \throw std::runtime_error if G is singular
+	 */
+	SystemLUSolverGenerator(const MatrixRMXd& G, double zero_bound = 1.0e-12);
+	SystemLUSolverGenerator(const SparseMatrixRMXd& G, double zero_bound = 1.0e-12);
+	SystemLUSolverGenerator(const SystemLUSolverGenerator& base);
+
+	/**
+	 * orders and factors the given conductance matrix, replacing any previous factors
+	 * \param G the conductance matrix of Gx=b
+	 * \param zero_bound range from zero when determining whether factor elements are close to zero to be ignored; defaults to 1e-12.
+	 * \throw std::runtime_error if G is singular
+	 */
+	void reset(const MatrixRMXd& G, double zero_bound = 1.0e-12);
+	void reset(const SparseMatrixRMXd& G, double zero_bound = 1.0e-12);
+	void reset(const SystemLUSolverGenerator& base);
+
+	/**
+		\return number of solutions in the system Gx=b
+	**/
+	inline unsigned int getDimension() const { return dimension; }
+
+	/**
+		\brief sets fan-in of balanced adder trees that sum the terms of each substitution row in generated inline code
+		\param fan_in maximum number of terms summed by each adder of the tree; <2 keeps the linear left-to-right sums
+		\see AdderTreeGenerator
+	**/
+	inline void setAdderTreeFanIn(unsigned int fan_in) { adder_tree_fan_in = fan_in; }
+
+	/**
+		\brief sets which solutions x[i] are required from generated inline code
+
+		Substitution rows are omitted unless they compute a required solution or a value that a required
+		solution depends on through the factors L and U.
+
+		\param solved flags indexed by solution x[i], with index 0 being ground; empty to solve all solutions
+	**/
+	inline void setSolvedSolutions(const std::vector<bool>& solved) { this->solved = solved; }
+
+	/**
+		\brief sets the index of solution x[i] computed by each row of G, as for a Kron reduced system
+		\param indices index of solution x[i] for each row; empty for x[r+1] of row r
+		\see SystemConductanceGenerator::kronReduce()
+	**/
+	inline void setSolutionIndices(const std::vector<unsigned int>& indices) { solution_indices = indices; }
+
+	/**
+		\return number of nonzero elements of L below its unit diagonal that are kept in generated code
+	**/
+	unsigned long getNumberOfLowerNonzeros() const;
+
+	/**
+		\return number of nonzero elements of U, including its diagonal, that are kept in generated code
+	**/
+	unsigned long getNumberOfUpperNonzeros() const;
+
+	/**
+		\return number of multiply-accumulates the generated substitution performs per solve, over the rows
+		required by the solved solutions
+	**/
+	unsigned long getNumberOfMultiplyAccumulates() const;
+
+	/**
+		\return largest magnitude of the coefficients in generated code: the kept elements of L and U, and the
+		inverses of the diagonal of U
+	**/
+	double getLargestCoefficientMagnitude() const;
+
+	/**
+		\brief generates C/C++ inline-able code that solves Gx=b by forward and back substitution
+
+		Input of the inline code is the source vector NumType b[<num_nodes>] and the output is
+		NumType x[<num_nodes>+1] with x[0] being ground, as with SystemSolverGenerator.  The
+		generated code declares its own temporary array NumType lu_y[<num_nodes>] for the forward
+		substitution.
+
+		\return string containing the generated code
+	**/
+	std::string generateCInlineCode() const;
+
+	/**
+		\brief writes C/C++ code definitions of the literal (const static) tables of the factors L and U to a stream
+
+		The value tables lu_fwd_val and lu_bwd_val hold the negated kept elements of L and U by substitution row,
+		and lu_bwd_diag the inverses of the diagonal of U, while the index tables (see SystemTableSolverGenerator)
+		hold the columns and rows each element refers to.
+
+		\param out stream the definitions are written to
+		\param type_name C/C++ type of the value table elements; default is real
+	**/
+	void generateTableCLiteral(std::ostream& out, std::string type_name = "real") const;
+
+	/**
+		\brief generates C/C++ inline-able code that solves Gx=b by forward and back substitution looping over the
+		tables of generateTableCLiteral()
+
+		Input and output of the inline code are those of generateCInlineCode(), and the code sums each row in the
+		same order, but its size does not depend on the number of nonzeros of the factors.  The generated code
+		declares its own temporaries lu_y and table_sum, and loop indices table_r and table_k.
+
+		\return string containing the generated code
+	**/
+	std::string generateTableCInlineCode() const;
+
+private:
+
+	void factor(const SparseMatrixRMXd& G);
+
+	void findRequiredRows(std::vector<bool>& forward_rows, std::vector<bool>& back_rows) const;
+
+	/**
+		\brief substitution tables of the factors, by required row in the order of substitution
+	**/
+	struct Tables
+	{
+		std::vector<double> fwd_val; ///< negated kept elements of L
+		std::vector<unsigned int> fwd_col; ///< row of lu_y read by each element of L
+		std::vector<unsigned int> fwd_ptr; ///< offset of the elements of each forward row, followed by the number of elements
+		std::vector<unsigned int> fwd_row; ///< row of lu_y written by each forward row
+		std::vector<unsigned int> fwd_b; ///< index of b read by each forward row
+		std::vector<double> bwd_val; ///< negated kept elements of U above its diagonal
+		std::vector<unsigned int> bwd_col; ///< solution x[i] read by each element of U
+		std::vector<unsigned int> bwd_ptr; ///< offset of the elements of each back row, followed by the number of elements
+		std::vector<unsigned int> bwd_row; ///< row of lu_y read by each back row
+		std::vector<unsigned int> bwd_x; ///< solution x[i] written by each back row
+		std::vector<double> bwd_diag; ///< inverse of the diagonal element of U of each back row
+	};
+
+	Tables buildTables() const;
+
+	inline unsigned int solutionIndex(unsigned int r) const { return solution_indices.empty() ? r+1 : solution_indices[r]; }
+
+	inline bool isKept(double v) const { return !(v < zero_bound && v > -zero_bound); }
+};
+
+} //namespace lblmc
+
+#endif //SYSTEMLUSOLVERGENERATOR_HPP
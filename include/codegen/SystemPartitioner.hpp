@@ -0,0 +1,145 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef SYSTEMPARTITIONER_HPP
+#define SYSTEMPARTITIONER_HPP
+
+#include <vector>
+#include <string>
+
+#include "codegen/netlist/Netlist.hpp"
+#include "codegen/SubsystemSolverEngineGenerator.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief Partitions the netlist of a system into subsystems for Nodal Decomposition
+
+	The subsystems of a system decomposed under LB-LMC are joined at ports, where each subsystem sees
+	the others as Norton models whose sources lag by one time step.  This class picks the ports of a
+	netlist automatically, so its subsystems can be solved in parallel on separate cores or devices.
+
+	Only nodes with a latency-providing component, such as an inductor, capacitor, or NortonPort,
+	are cut into ports, so the one step lag of the port sources follows the latency already in the
+	model.  Components joined by any other node are kept in the same subsystem, and each cut node is
+	shared by exactly two subsystems, as a port between the node and ground of both.
+
+	The per time step cost of a subsystem is estimated as n*n multiply-accumulates for the dense solve
+	of its n nodes, plus one for each terminal of its components to stamp sources and read solutions.
+	Starting from subsystems grown from distant parts of the network, components are moved between
+	subsystems to first minimize the largest cost, then the number of ports while keeping the largest
+	cost within a tolerance of its minimum.  This is a greedy local search, so the result is balanced
+	and has few ports, but is not guaranteed optimal.
+
+	The subsystems are given as netlists with nodes renumbered from 1, along with their ports, ready
+	for SubsystemSolverEngineGenerator::setPorts(), computePortModels(), and stampOthersPortModels().
+	Port ids are shared by the two subsystems of a port.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class SystemPartitioner
+{
+public:
+
+	/**
+		\brief subsystem of a partitioned system
+	**/
+	struct Subsystem
+	{
+		Netlist netlist; ///< components of the subsystem, with nodes renumbered from 1
+		std::vector<unsigned int> nodes; ///< node of the system for each node of the subsystem; nodes[i] for node i+1
+		std::vector<SubsystemSolverEngineGenerator::Port> ports; ///< ports of the subsystem to the others, by node of the subsystem
+		unsigned long operations; ///< estimated multiply-accumulates per time step
+
+		Subsystem() : netlist(), nodes(), ports(), operations(0) {}
+	};
+
+private:
+
+	std::vector<std::string> latency_types; ///< types of components that provide latency for cuts
+	double tolerance; ///< fraction the largest cost may exceed its minimum to remove ports
+	std::vector<Subsystem> subsystems; ///< subsystems of last partition()
+	unsigned int num_ports; ///< number of ports of last partition()
+	unsigned long system_operations; ///< estimated multiply-accumulates per time step of the unpartitioned system
+
+public:
+
+	/**
+		\brief default constructor
+
+		Inductors, capacitors, and NortonPorts provide latency by default, and the largest cost may
+		exceed its minimum by 5% to remove ports.
+	**/
+	SystemPartitioner();
+
+	SystemPartitioner(const SystemPartitioner& base) = default;
+
+	/**
+		\brief sets the types of components that provide latency, whose nodes can be cut into ports
+		\param types netlist type names of the components, such as "Inductor"
+	**/
+	inline void setLatencyComponentTypes(const std::vector<std::string>& types) { latency_types = types; }
+
+	inline const std::vector<std::string>& getLatencyComponentTypes() const { return latency_types; }
+
+	/**
+		\brief sets the fraction the largest cost of the subsystems may exceed its minimum to remove ports
+		\throw std::invalid_argument if tolerance is negative
+	**/
+	void setBalanceTolerance(double tolerance);
+
+	inline double getBalanceTolerance() const { return tolerance; }
+
+	/**
+		\brief partitions the netlist of a system into the given number of subsystems
+		\param netlist netlist of the system
+		\param num_subsystems number of subsystems to partition into; must be nonzero
+		\throw std::invalid_argument if num_subsystems is zero or the netlist has no components
+		\throw std::runtime_error if the netlist has too few latency-providing components to be cut
+		into the given number of subsystems with each cut node shared by two subsystems
+	**/
+	void partition(const Netlist& netlist, unsigned int num_subsystems);
+
+	/**
+		\return subsystems of last partition(), named as the system suffixed by their index
+	**/
+	inline const std::vector<Subsystem>& getSubsystems() const { return subsystems; }
+
+	inline unsigned int getNumberOfPorts() const { return num_ports; }
+
+	/**
+		\return printable report of the ports and estimated costs of the subsystems
+	**/
+	std::string generateReport() const;
+};
+
+} //namespace lblmc
+
+#endif //SYSTEMPARTITIONER_HPP
@@ -0,0 +1,169 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef SYSTEMSIMDSOLVERGENERATOR_HPP
+#define SYSTEMSIMDSOLVERGENERATOR_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace lblmc
+{
+
+/**
+	\brief Generates SIMD-vectorized CPU solver code for the dense matrix-vector product x=M*v
+
+	SystemSolverGenerator unrolls x=(G^-1)*b into one scalar statement per solution, which compilers
+	seldom auto-vectorize for large systems.  This generator instead stores the matrix M (typically G^-1,
+	or the fused source gain matrix (G^-1)*A) in a padded, aligned, column-blocked layout and emits a
+	call to an explicit SIMD matrix-vector kernel.
+
+	The rows of M are split into panels of PANEL_HEIGHT rows, padding the last panel with zeros.
+	Each panel is stored column after column, so that the PANEL_HEIGHT elements of a panel column are
+	contiguous and aligned to 64 bytes.  The kernel accumulates each panel as a sum of its columns
+	scaled by the broadcast elements of v, with fused multiply-adds on the vector registers.
+
+	The kernel, emitted once per header by generateKernelCode(), uses AVX-512 intrinsics when compiled
+	with __AVX512F__, AVX2 intrinsics when compiled with __AVX2__ (and FMA3 when __FMA__), and otherwise
+	a portable scalar loop over the same layout.  The intrinsic kernels apply only when the real type of
+	the generated solver is double; any other real type uses the portable kernel.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class SystemSIMDSolverGenerator
+{
+public:
+
+	const static unsigned int PANEL_HEIGHT = 8; ///< rows per panel; one AVX-512 or two AVX2 double vectors
+
+private:
+	const double* M; ///< dense matrix of x=M*v in row-major order
+	unsigned int rows; ///< number of rows of M; number of solutions in x
+	unsigned int cols; ///< number of columns of M; number of elements in v
+	double zero_bound; ///< range from zero when determining whether elements of M are close to zero to be stored as zero; defaults to 1e-12.
+	std::vector<bool> solved; ///< flags of solutions x[i] (index 0 is ground) solved in generated inline code; empty to solve all
+	std::vector<unsigned int> solution_indices; ///< index of solution x[i] computed by each row of M; empty for x[r+1] of row r
+	std::vector<unsigned int> row_index; ///< rows of M that are solved, in the order they are packed into panels
+
+public:
+
+	SystemSIMDSolverGenerator();
+
+	/**
+	 * parameter constructor
+	 * \param M dense matrix of x=M*v in row-major order
+	 * \param rows number of rows of M
+	 * \param cols number of columns of M
+	 * \param zero_bound range from zero when determining whether elements of M are close to zero to be stored as zero; defaults to 1e-12.
+	 */
+	SystemSIMDSolverGenerator(const double* M, unsigned int rows, unsigned int cols, double zero_bound = 1.0e-12);
+	SystemSIMDSolverGenerator(const SystemSIMDSolverGenerator& base);
+
+	void reset(const double* M, unsigned int rows, unsigned int cols, double zero_bound = 1.0e-12);
+	void reset(const SystemSIMDSolverGenerator& base);
+
+	/**
+		\brief sets which solutions x[i] are solved; only rows of M for solved solutions are packed into panels
+		\param solved flags indexed by solution x[i], with index 0 being ground; empty to solve all solutions
+	**/
+	void setSolvedSolutions(const std::vector<bool>& solved);
+
+	/**
+		\brief sets the index of solution x[i] computed by each row of M, as for a Kron reduced system
+		\param indices index of solution x[i] for each row; empty for x[r+1] of row r
+		\see SystemConductanceGenerator::kronReduce()
+	**/
+	void setSolutionIndices(const std::vector<unsigned int>& indices);
+
+	/**
+		\return number of row panels of the column-blocked layout
+	**/
+	inline unsigned int getNumberOfPanels() const { return (row_index.size() + PANEL_HEIGHT - 1) / PANEL_HEIGHT; }
+
+	/**
+		\return number of solved rows of M padded up to a whole number of panels
+	**/
+	inline unsigned int getPaddedRows() const { return getNumberOfPanels() * PANEL_HEIGHT; }
+
+	/**
+		\brief generates the SIMD matrix-vector kernel and alignment macro shared by all generated solvers
+
+		The code is include-guarded by LBLMC_SIMD_MATVEC_KERNEL, so it can be emitted at file scope of every
+		generated header that uses it.  It defines macro LBLMC_SIMD_ALIGN and function template
+		lblmc_simd_matvec(M, v, x, panels, cols) with an intrinsic overload for double.
+
+		\return string containing the generated code
+	**/
+	static std::string generateKernelCode();
+
+	/**
+		\return elements of M in the column-blocked layout of generateCLiteral(), with the rows padded up to whole panels,
+		and elements within zero_bound of zero stored as zero; empty if no rows are solved
+	**/
+	std::vector<double> getBlockedMatrix() const;
+
+	/**
+		\brief generates C/C++ code definition of the literal (const static) matrix M in column-blocked layout
+		\param M_name C/C++ compatible name for the matrix array
+		\return string containing the definition; empty if no rows are solved
+	**/
+	std::string generateCLiteral(std::string M_name) const;
+
+	/**
+		\brief writes C/C++ code definition of the literal (const static) matrix M in column-blocked layout to a stream
+		\param out stream the definition is written to; nothing is written if no rows are solved
+		\param M_name C/C++ compatible name for the matrix array
+		\param type_name C/C++ type of the array elements; default is real
+	**/
+	void generateCLiteral(std::ostream& out, std::string M_name, std::string type_name = "real") const;
+
+	/**
+		\brief generates C/C++ inline-able code that solves x=M*v with the SIMD matrix-vector kernel
+
+		Input of the inline code is NumType <v_name>[cols] and the output is NumType x[rows+1] with x[0] being
+		ground, as with SystemSolverGenerator.  The generated code declares its own aligned temporary array
+		NumType x_simd[<padded rows>] that the kernel stores whole panels into.
+
+		\param M_name name of the column-blocked matrix literal in generated code
+		\param v_name name of the input vector in generated code; b for G^-1, or b_components for (G^-1)*A
+		\return string containing the generated code
+	**/
+	std::string generateCInlineCode(std::string M_name, std::string v_name) const;
+
+private:
+
+	inline unsigned int solutionIndex(unsigned int r) const { return solution_indices.empty() ? r+1 : solution_indices[r]; }
+
+	void updateRowIndex();
+};
+
+} //namespace lblmc
+
+#endif //SYSTEMSIMDSOLVERGENERATOR_HPP
@@ -32,6 +32,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 
 #include <vector>
 #include <string>
+#include <ostream>
 
 namespace lblmc
 {
@@ -43,6 +44,9 @@ private:
 	unsigned int dimension; ///< number of solutions in the system Gx=b
 	unsigned int num_components; ///< number of components in system to contribute to vector b of Gx=b
 	double zero_bound; ///< range from zero when determining whether Aij*bi=xi is close to zero to be ignored; defaults to 1e-12.
+	unsigned int adder_tree_fan_in; ///< fan-in of balanced adder trees summing each x[r] in generated code; <2 for linear sums; defaults to 0.
+	std::vector<bool> solved; ///< flags of solutions x[i] (index 0 is ground) solved in generated inline code; empty to solve all
+	std::vector<unsigned int> solution_indices; ///< index of solution x[i] computed by each row of the system; empty for x[r+1] of row r
 
 public:
 
@@ -61,6 +65,73 @@ public:
 	void reset(const double* A, unsigned int dimension, unsigned int num_components, double zero_bound = 1.0e-12);
 	void reset(const SystemSolverGenerator& base);
 
+	/**
+		\brief sets fan-in of balanced adder trees that sum the terms of each solution x[r] in generated inline code
+		\param fan_in maximum number of terms summed by each adder of the tree; <2 keeps the linear left-to-right sums
+		\see AdderTreeGenerator
+	**/
+	inline void setAdderTreeFanIn(unsigned int fan_in) { adder_tree_fan_in = fan_in; }
+
+	/**
+		\brief sets which solutions x[i] are solved by generated inline code; rows of unsolved solutions are omitted
+		\param solved flags indexed by solution x[i], with index 0 being ground; empty to solve all solutions
+	**/
+	inline void setSolvedSolutions(const std::vector<bool>& solved) { this->solved = solved; }
+
+	/**
+		\brief sets the index of solution x[i] computed by each row of the system, as for a Kron reduced system
+		\param indices index of solution x[i] for each row; empty for x[r+1] of row r
+		\see SystemConductanceGenerator::kronReduce()
+	**/
+	inline void setSolutionIndices(const std::vector<unsigned int>& indices) { solution_indices = indices; }
+
+	/**
+		\return number of multiply-accumulates the generated solver x=(G^-1)*b performs per solve,
+		excluding the elements of G^-1 discarded by zero_bound
+	**/
+	unsigned long getNumberOfMultiplyAccumulates() const;
+
+	/**
+		\param K source gain matrix K = (G^-1)*A of dimension rows by num_components columns in row-major order, where
+		A is the incidence matrix of component sources into b
+		\return number of multiply-accumulates the generated solver x=K*b_components performs per solve,
+		excluding the elements of K discarded by zero_bound
+	**/
+	unsigned long getNumberOfSourceGainMultiplyAccumulates(const double* K) const;
+
+	/**
+		\brief generates C/C++ code definition of the literal (const static) source gain matrix K = (G^-1)*A
+		\param K source gain matrix of dimension rows by num_components columns in row-major order
+		\param K_name C/C++ compatible name for the matrix array; default is src_gain
+		\return string containing the definition; empty if there are no component sources
+	**/
+	std::string generateSourceGainCLiteral(const double* K, std::string K_name = "src_gain") const;
+
+	/**
+		\brief writes C/C++ code definition of the literal (const static) source gain matrix K = (G^-1)*A to a stream
+		\param out stream the definition is written to; nothing is written if there are no component sources
+		\param K source gain matrix of dimension rows by num_components columns in row-major order
+		\param K_name C/C++ compatible name for the matrix array; default is src_gain
+		\param type_name C/C++ type of the array elements; default is real
+		\param num_threads number of threads formatting the rows; 0 uses the number of hardware threads
+	**/
+	void generateSourceGainCLiteral(std::ostream& out, const double* K, std::string K_name = "src_gain", std::string type_name = "real",
+		unsigned int num_threads = 0) const;
+
+	/**
+		\brief generates C/C++ inline-able code that solves x=K*b_components directly from component sources
+
+		The source gain matrix K = (G^-1)*A fuses the aggregation of the component source contributions into the
+		source vector b = A*b_components with the solve x=(G^-1)*b, removing the aggregation stage from the solver.
+
+		Input of the inline code is NumType b_components[<num_components>] and the output is NumType x[<num_nodes>+1].
+
+		\param K source gain matrix of dimension rows by num_components columns in row-major order
+		\param K_name name of the source gain matrix in generated code; default is src_gain
+		\return string containing the generated code
+	**/
+	std::string generateSourceGainCInlineCode(const double* K, std::string K_name = "src_gain") const;
+
 	/**
 		\brief generates C/C++ inline-able code that includes only the solver for x=(G^-1)*b
 
@@ -75,6 +146,17 @@ public:
 	**/
 	void generateCInlineCode(std::string& buffer, const char* invg_name = "inv_g");
 
+	/**
+		\brief writes C/C++ inline-able code that includes only the solver for x=(G^-1)*b to a stream
+
+		The code is the same as that of generateCInlineCode(std::string&, const char*), but is written row by row
+		into the stream rather than held in a string buffer.
+
+		\param out stream the generated code is written to
+		\param invg_name name of the inverted conductance matrix G^-1; default is inv_g
+	**/
+	void generateCInlineCode(std::ostream& out, const char* invg_name = "inv_g") const;
+
 	/**
 		\brief generates C/C++ code for system solver function to solve x=(G^-1)*b
 
@@ -121,6 +203,12 @@ public:
 	**/
 	void generateCFunctionAndExport(std::string filename, std::string solver_name = "solve",
 			std::string A_name = "inv_g", std::string b_func_name = "agg_b") const;
+
+private:
+
+	inline unsigned int solutionIndex(unsigned int r) const { return solution_indices.empty() ? r+1 : solution_indices[r]; }
+
+	inline bool isSolved(unsigned int r) const { return solved.empty() || (solutionIndex(r) < solved.size() && solved[solutionIndex(r)]); }
 };
 
 } //namespace lblmc
@@ -35,6 +35,8 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include <map>
 #include <string>
 
+#include "codegen/CodeGenDataTypes.hpp"
+
 namespace lblmc
 {
 
@@ -130,6 +132,26 @@ public:
 	**/
 	const std::vector<long>& getSourceNodesById(long source_id) const;
 
+	/**
+		\brief generates the incidence matrix A of the sources into the source vector, such that b = A*b_components
+
+		Element A(i,s) is +1 if source s contributes to b[i] positively, -1 if negatively, and 0 otherwise.
+
+		\return incidence matrix of dimension rows by number of sources columns
+	**/
+	MatrixRMXd asIncidenceMatrix() const;
+
+	/**
+		\brief reduces the source vector to the given retained solutions, renumbering them in order
+
+		This accompanies SystemConductanceGenerator::kronReduce() to keep the source vector consistent with
+		the reduced conductance matrix.  Nodes of the sources are renumbered as well.
+
+		\param retained original index of solution x[i] for each element of the reduced source vector
+		\throw std::invalid_argument if a solution that is not retained has sources contributing to it
+	**/
+	void reduceSolutions(const std::vector<unsigned int>& retained);
+
 	/**
 	 * inserts a contributing source's index into the source vector between given nodes
 	 * \param npos positive node of the source
@@ -205,6 +227,16 @@ public:
 	**/
 	std::string asCInlineCode() const;
 
+	/**
+		\brief generates compilable inlined C/C++ code to aggregate the source vector b from source contributions, with each sum split into a balanced adder tree
+		This method is similar to asCInlineCode() but sums the source contributions of each source vector element through
+		named partial sums of a balanced adder tree, shortening the adder chain latency.
+		\param adder_tree_fan_in maximum number of terms summed by each adder of the tree; <2 produces same code as asCInlineCode()
+		\return string that will store the source code that is inline-able.
+		\see AdderTreeGenerator
+	**/
+	std::string asCInlineCode(unsigned int adder_tree_fan_in) const;
+
 	/**
 	 * Generates the C/C++ source code for a function that aggregates/computes the source vector b from array of given source contributions
 	 * The generated function is created from the indices stored in this object.
@@ -0,0 +1,124 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef SYSTEMSPARSIFIER_HPP
+#define SYSTEMSPARSIFIER_HPP
+
+#include <vector>
+#include <string>
+
+#include "codegen/CodeGenDataTypes.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief Prunes elements of a dense solve matrix within a worst-case solution error budget
+
+	The solve x=M*v of a solver, with M being G^-1 (v=b) or the fused source gain matrix (G^-1)*A
+	(v=b_components), usually has few elements small enough for an absolute zero bound to discard.
+	Given the expected maximum magnitude |v[c]| of each input, dropping element M(r,c) changes
+	solution x[r] by at most |M(r,c)|*|v[c]|, so the worst-case error of x[r] is bounded by the sum
+	of these terms over the dropped elements of row r.
+
+	For each row, this class drops the elements with the smallest such terms, as many as fit in the
+	row's error budget, which maximizes the number of multiply-accumulates removed for the budget.
+	The budget is either absolute, in units of the solutions, or relative to the row's worst-case
+	solution magnitude sum(|M(r,c)|*|v[c]|).  Inputs with zero expected magnitude, such as elements
+	of b without sources, cost nothing to drop.
+
+	The bounds hold for each solve of the system.  Since component states are updated from the solutions,
+	the errors of successive time steps can accumulate in the states over a simulation.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class SystemSparsifier
+{
+private:
+	MatrixRMXd matrix; ///< solve matrix, pruned by sparsify()
+	std::vector<double> input_magnitudes; ///< expected maximum magnitude of each input v[c]
+	std::vector<double> row_error_bounds; ///< worst-case absolute error of each solution from pruning
+	std::vector<double> row_magnitudes; ///< worst-case magnitude of each solution, sum(|M(r,c)|*|v[c]|)
+	unsigned long num_original_nonzeros; ///< number of nonzero elements of matrix before pruning
+	unsigned long num_removed; ///< number of nonzero elements removed by pruning
+	double error_budget; ///< error budget of last sparsify()
+	bool relative; ///< whether error budget of last sparsify() is relative to row magnitudes
+
+public:
+
+	/**
+	 * parameter constructor
+	 * \param M dense solve matrix of x=M*v
+	 * \param input_magnitudes expected maximum magnitude of each element of v; must have as many elements as M has columns
+	 * \param zero_bound range from zero within which elements of M are already discarded by solver generators; defaults to 1e-12.
+	 * \throw std::invalid_argument if input_magnitudes does not match columns of M or has negative elements
+	 */
+	SystemSparsifier(const MatrixRMXd& M, const std::vector<double>& input_magnitudes, double zero_bound = 1.0e-12);
+	SystemSparsifier(const SystemSparsifier& base) = default;
+
+	/**
+		\brief prunes elements of the solve matrix within the given error budget of each solution
+		\param error_budget maximum worst-case error of each solution; must be non-negative
+		\param relative true if error_budget is relative to worst-case magnitude of each solution; false if absolute
+		\throw std::invalid_argument if error_budget is negative
+	**/
+	void sparsify(double error_budget, bool relative);
+
+	/**
+		\return solve matrix with the pruned elements set to zero
+	**/
+	inline const MatrixRMXd& getMatrix() const { return matrix; }
+
+	inline unsigned long getNumberOfOriginalNonzeros() const { return num_original_nonzeros; }
+	inline unsigned long getNumberOfRemovedElements() const { return num_removed; }
+
+	/**
+		\return worst-case absolute error of each solution due to pruning
+	**/
+	inline const std::vector<double>& getRowErrorBounds() const { return row_error_bounds; }
+
+	/**
+		\return largest worst-case absolute error over all solutions
+	**/
+	double getErrorBound() const;
+
+	/**
+		\return largest worst-case error over all solutions relative to their worst-case magnitudes
+	**/
+	double getRelativeErrorBound() const;
+
+	/**
+		\return printable report of the achieved sparsity and error bounds
+	**/
+	std::string generateReport() const;
+};
+
+} //namespace lblmc
+
+#endif //SYSTEMSPARSIFIER_HPP
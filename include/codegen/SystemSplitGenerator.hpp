@@ -0,0 +1,234 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef SYSTEMSPLITGENERATOR_HPP
+#define SYSTEMSPLITGENERATOR_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <unordered_set>
+
+namespace lblmc
+{
+
+/**
+	\brief Splits the step code of a generated solver into part functions of bounded size
+
+	Compilers take superlinear time on a function of tens of thousands of statements, and compile one
+	function on one core.  This generator instead deals the units of the step code (the update body
+	of each component, or single statements of the aggregation and solve) in order into parts of about
+	a given number of characters of code each, which become functions the step calls one after another,
+	each defined in its own source file so that the parts compile in parallel.
+
+	The parts share the persistent fields and temporaries of the step through a state structure (see
+	SystemStateGenerator::insertFields()), and the arguments of the step through an argument structure
+	of references to them, so that each part declares only the parameters and binds only the fields and
+	arguments its code refers to:
+
+	<pre>
+	const static real R_r0 = 1.0;              ->  copied into each part referring to R_r0
+	real& current_l0 = state->current_l0;      ->  copied into each part referring to current_l0
+	real x_out[N]                              ->  real* x_out;                        (argument structure)
+	                                               real* x_out = args->x_out;          (parts referring to x_out)
+	const static real inv_g[N][N] = {...};     ->  const static real inv_g[N][N];      (member of the parts class)
+	                                               const real parts::inv_g[N][N] = {...};  (defined once)
+	</pre>
+
+	The parts are static member functions of one class, which holds the literals as static members, so
+	that they are defined once rather than per part, and which may be templated on the real type.  Arrays
+	of binary matrices loaded on the first call of the solver are then loaded during static initialization.
+	Temporaries declared by the update body of a component and read by code of other units, such as its
+	outputs, are moved into the state structure by extractDeclarations().
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class SystemSplitGenerator
+{
+public:
+
+	static const std::string ARGUMENTS; ///< name of the argument structure pointer argument of the part functions
+
+private:
+
+	unsigned long function_size; ///< approximate number of characters of code of each part
+	std::vector<std::string> parts; ///< code of each part, in order of execution
+	std::vector<std::string> declarations; ///< declarations of the step the parts may refer to, in order of declaration
+	std::vector<std::pair<std::string, std::string>> literal_definitions; ///< definitions of the literals, split before the name
+	std::vector<std::string> literal_declarations; ///< static member declarations of the literals
+
+public:
+
+	SystemSplitGenerator();
+
+	/**
+		\brief parameter constructor
+		\param function_size approximate number of characters of code of each part; must be nonzero
+		\throw std::invalid_argument if function_size is zero
+	**/
+	explicit SystemSplitGenerator(unsigned long function_size);
+
+	SystemSplitGenerator(const SystemSplitGenerator& base) = default;
+
+	/**
+		\brief resets the generator to hold no parts, declarations, or literals
+		\param function_size approximate number of characters of code of each part; must be nonzero
+		\throw std::invalid_argument if function_size is zero
+	**/
+	void reset(unsigned long function_size);
+
+	inline unsigned long getFunctionSize() const { return function_size; }
+
+	/**
+		\brief appends a unit of code to the last part, or to a new part if the last would outgrow the function size
+		\param code code appended as a whole, such as the update body of a component
+	**/
+	void insertCode(const std::string& code);
+
+	/**
+		\brief appends each statement of the code as its own unit, see insertCode()
+
+		Only code of single statements sharing no temporaries, such as the unrolled rows of a solve with
+		linear sums, can be split this way.  Comments go with the statement following them.
+
+		\param code statements to append
+	**/
+	void insertStatements(const std::string& code);
+
+	/**
+		\brief inserts declarations of the step, such as parameters or bindings of fields, copied into
+		the parts that refer to them
+		\param code declarations to insert
+	**/
+	void insertDeclarations(const std::string& code);
+
+	/**
+		\brief inserts bindings of the arguments of the step to their members of the argument structure, copied into
+		the parts that refer to them
+		\param parameter_list parameter list of the step, without its state structure argument
+	**/
+	void insertArguments(const std::string& parameter_list);
+
+	/**
+		\brief inserts definitions of literals with static storage, moved to static members of the class holding the parts
+
+		Statements that only refer to a literal, as (void) M_loaded of the binary matrix loads, are dropped.
+
+		\param code definitions to insert
+		\throw std::runtime_error if the code has statements that are not definitions with static storage
+	**/
+	void insertLiterals(const std::string& code);
+
+	inline unsigned int getNumberOfParts() const { return parts.size(); }
+
+	/**
+		\param part index of the part
+		\return code of the part
+	**/
+	inline const std::string& getPartCode(unsigned int part) const { return parts.at(part); }
+
+	/**
+		\param part index of the part
+		\return declarations of the step the code of the part refers to, in order of declaration
+	**/
+	std::string generateDeclarationCode(unsigned int part) const;
+
+	/**
+		\return static member declarations of the literals, for the class holding the parts
+	**/
+	std::string generateLiteralMemberCode() const;
+
+	/**
+		\param template_head template head of the class holding the parts, such as "template< typename real >\n"; empty if
+		not a template
+		\param scope name of the class holding the parts, with its template arguments
+		\return definitions of the static members of the literals
+	**/
+	std::string generateLiteralDefinitionCode(const std::string& template_head, const std::string& scope) const;
+
+	/**
+		\brief generates the structure of references to the arguments of the step, passed to the parts by pointer
+
+		Array parameters, which are passed as pointers to their first element, are held as such pointers.
+
+		\param struct_name name of the structure
+		\param parameter_list parameter list of the step, without its state structure argument
+		\return string containing the structure definition
+	**/
+	static std::string generateArgumentsStruct(const std::string& struct_name, const std::string& parameter_list);
+
+	/**
+		\brief moves declarations of the given names at the top level of a unit of code out of it, keeping their initializers
+		as assignments
+
+		Only declarations without initializers or of scalars are moved, such as "real current_sw0;" of a component update body.
+
+		\param code unit of code, such as the update body of a component; set to the code without the declarations
+		\param names names of the declarations to move
+		\return moved declarations, without initializers
+	**/
+	static std::string extractDeclarations(std::string& code, const std::unordered_set<std::string>& names);
+
+	/**
+		\param parameter_list parameter list of a function
+		\return names of the parameters, in order, as the arguments of a call forwarding them
+	**/
+	static std::vector<std::string> findArgumentNames(const std::string& parameter_list);
+
+	/**
+		\return name declared by the given declaration, such as R_r0 of "const static real R_r0 = 1.0"
+	**/
+	static std::string findDeclaredName(const std::string& declaration);
+
+	/**
+		\return words of the given code, being identifiers and numbers
+	**/
+	static std::unordered_set<std::string> findWords(const std::string& code);
+
+private:
+
+	/**
+		\param parameter parameter of the step
+		\return declaration of the member of the argument structure referring to the parameter, such as "real* x_out" of
+		"real x_out[N]" or "bool& sw_s0" of "bool sw_s0"
+	**/
+	static std::string generateArgumentMember(const std::string& parameter);
+
+	/**
+		\brief selects the declarations the given code refers to, directly or through other selected declarations
+		\param candidates declarations to select from, in order of declaration
+		\param words words of the code, extended by the words of the selected declarations
+		\return flags of the selected declarations
+	**/
+	static std::vector<bool> selectDeclarations(const std::vector<std::string>& candidates, std::unordered_set<std::string>& words);
+};
+
+} //namespace lblmc
+
+#endif //SYSTEMSPLITGENERATOR_HPP
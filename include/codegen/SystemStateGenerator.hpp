@@ -0,0 +1,182 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef SYSTEMSTATEGENERATOR_HPP
+#define SYSTEMSTATEGENERATOR_HPP
+
+#include <string>
+#include <vector>
+
+namespace lblmc
+{
+
+/**
+	\brief Moves the persistent fields of a generated solver out of the solver function into a state structure
+
+	By default, the persistent fields of components and the solutions of a generated solver are static
+	variables of the solver function, so there is one instance of the model per template instance of the
+	solver.  This generator instead collects them into a structure passed to the solver by pointer, so any
+	number of instances can be created, reset, and stepped at runtime, from any thread:
+
+	<pre>
+	static real current_l0 = 0.0;         ->  struct model_state { real current_l0; ... };
+	                                           state->current_l0 = 0.0;            (init function)
+	                                           real& current_l0 = state->current_l0;  (step function)
+	</pre>
+
+	The step function binds each field by reference to its member of the structure, so the code of the
+	components is kept as is.  Fields without static storage, such as temporaries, stay local to the step
+	function.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class SystemStateGenerator
+{
+public:
+
+	static const std::string STATE; ///< name of the state structure pointer argument of generated functions
+
+	/**
+		\brief persistent field of the model, held by the state structure
+	**/
+	struct Field
+	{
+		std::string type; ///< type of the field
+		std::string name; ///< name of the field
+		std::vector<std::string> dimensions; ///< array dimensions of the field
+		std::string initializer; ///< initializer of the field; empty if zero initialized
+	};
+
+private:
+
+	std::vector<Field> fields; ///< persistent fields, in order of declaration
+	std::string local_code; ///< declarations of fields without static storage
+
+public:
+
+	SystemStateGenerator();
+
+	SystemStateGenerator(const SystemStateGenerator& base) = default;
+
+	/**
+		\brief resets the generator to hold no fields
+	**/
+	void reset();
+
+	/**
+		\brief inserts fields of components, as given to SolverEngineGenerator::insertComponentFieldsCode()
+
+		Declarations with static storage become persistent fields; all other declarations are kept as
+		local code, unless held as fields too.
+
+		\param code declarations of the fields
+		\param hold_locals true to also hold declarations without static storage as fields, such as when
+		the code of a step is split between functions sharing its temporaries through the structure
+		\throw std::runtime_error if the code has declarations that cannot be parsed
+	**/
+	void insertFields(const std::string& code, bool hold_locals = false);
+
+	/**
+		\brief inserts a zero initialized persistent field declared by the caller, such as the solution vector x
+		\param type type of the field
+		\param name name of the field
+		\param dimensions array dimensions of the field; empty if not an array
+	**/
+	void insertVariable(const std::string& type, const std::string& name, const std::vector<std::string>& dimensions);
+
+	/**
+		\return persistent fields, in order of declaration
+	**/
+	inline const std::vector<Field>& getFields() const { return fields; }
+
+	/**
+		\return code declaring the fields without static storage
+	**/
+	inline const std::string& getLocalFieldsCode() const { return local_code; }
+
+	/**
+		\brief generates the state structure holding the persistent fields
+		\param struct_name name of the structure
+		\param templated_real true if the structure is templated on the real type
+		\return string containing the structure definition
+	**/
+	std::string generateStateStruct(const std::string& struct_name, bool templated_real) const;
+
+	/**
+		\return code setting each persistent field of the state structure to its initial value
+	**/
+	std::string generateInitializationCode() const;
+
+	/**
+		\brief generates the aggregate initializer of the state structure, holding the initial value of each persistent field
+
+		Copying a constant structure of initial values compiles to a block copy, where setting thousands of
+		fields one by one takes the optimizer superlinear time.
+
+		\return braced initializer list of the state structure
+	**/
+	std::string generateInitializerList() const;
+
+	/**
+		\return code declaring each persistent field as a static variable with its initializer
+	**/
+	std::string generateStaticDeclarations() const;
+
+	/**
+		\return code binding a reference of the name of each persistent field to its member of the state structure
+	**/
+	std::string generateBindingCode() const;
+
+	/**
+		\return copy of the given string without leading and trailing whitespace
+	**/
+	static std::string trim(const std::string& str);
+
+	/**
+		\brief splits code at each delimiter outside of parentheses, brackets, and braces
+	**/
+	static std::vector<std::string> splitTopLevel(const std::string& code, char delimiter);
+
+	/**
+		\return copy of the given code without line and block comments
+	**/
+	static std::string stripComments(const std::string& code);
+
+	/**
+		\brief splits an array declarator, such as "real name[A][B]", into its head "real name" and its dimensions A, B
+		\param declarator declarator to split
+		\param dimensions set to the dimensions of the declarator; empty if not an array
+		\return head of the declarator
+	**/
+	static std::string stripDimensions(const std::string& declarator, std::vector<std::string>& dimensions);
+};
+
+} //namespace lblmc
+
+#endif //SYSTEMSTATEGENERATOR_HPP
@@ -0,0 +1,232 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef SYSTEMSWITCHBANKGENERATOR_HPP
+#define SYSTEMSWITCHBANKGENERATOR_HPP
+
+#include <vector>
+#include <string>
+#include <ostream>
+
+#include "codegen/CodeGenDataTypes.hpp"
+#include "codegen/SystemConductanceGenerator.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief Generates solver code for systems with switch-dependent conductances from a bank of inverted
+	conductance matrices indexed by switch state
+
+	Components that stamp switched conductances (see SystemConductanceGenerator::stampSwitchedConductance())
+	change the conductance matrix G with the states of their switches.  For S switches, this class
+	precomputes G^-1 of switch states, as many as fit in a memory budget, and generates code that packs
+	the switch states into an index, selects the matching inverse from the bank, and solves x=(G^-1)*b.
+
+	The bank always holds the base state, which is all switches on, or all off if all on is singular.
+	Further states are banked in order of the number of switches that differ from the base state.  The
+	generated code solves states missing from the bank by a low-rank (Woodbury) correction of the base
+	state solution x0 for the k switches that differ from the base state:
+
+	<pre>
+	x = x0 - Z*(D^-1 + U^T*Z)^-1 * U^T*x0,  Z = G0^-1*U
+	</pre>
+
+	where U holds the node incidence of the differing switches and D their change of conductance.  The
+	correction solves a k by k system at run time, so it is slower than a banked state, but it needs only
+	the dimension by S matrix Z and the S by S matrix U^T*Z beside the bank.
+
+	\note States that make G singular, such as ideal open switches leaving nodes floating, are not banked
+	and cannot be solved by the correction either.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class SystemSwitchBankGenerator
+{
+public:
+
+	const static unsigned int MAX_SWITCHES = 32; ///< largest number of switches; packed switch states are 32 bit unsigned integers in generated code
+
+private:
+	unsigned int dimension; ///< number of solutions in the system Gx=b
+	double zero_bound; ///< range from zero when determining whether elements of the banked inverses are close to zero to be ignored; defaults to 1e-12.
+	unsigned long memory_budget; ///< largest size in bytes of the bank of inverses, at 8 bytes per element; the base state is banked regardless
+	std::vector<SwitchedConductance> switches; ///< switched conductances of the system, in switch order
+	unsigned long base_state; ///< packed switch state of first bank entry, from which unbanked states are corrected
+	std::vector<unsigned long> bank_states; ///< packed switch state of each bank entry
+	std::vector<MatrixRMXd> bank_inverses; ///< inverted conductance matrix of each bank entry
+	MatrixRMXd bank_magnitudes; ///< largest magnitude of each element over the bank entries, for pruning terms of generated solve
+	MatrixRMXd correction_gains; ///< Z = G0^-1*U of base state, one column per switch
+	MatrixRMXd correction_coupling; ///< U^T*Z of base state
+	unsigned long num_singular_states; ///< number of switch states found singular while filling the bank
+	unsigned int adder_tree_fan_in; ///< fan-in of balanced adder trees summing each x[r] in generated code; <2 for linear sums; defaults to 0.
+	std::vector<bool> solved; ///< flags of solutions x[i] (index 0 is ground) solved in generated inline code; empty to solve all
+	std::vector<unsigned int> solution_indices; ///< index of solution x[i] computed by each row of the system; empty for x[r+1] of row r
+
+public:
+
+	SystemSwitchBankGenerator();
+
+	/**
+	 * parameter constructor
+	 * \param cond_gen conductance matrix generator of the system, with switched conductances stamped
+	 * \param memory_budget largest size in bytes of the bank of inverses, at 8 bytes per element; the base state is banked regardless
+	 * \param zero_bound range from zero when determining whether elements of the banked inverses are close to zero to be ignored; defaults to 1e-12.
+	 * \throw std::invalid_argument if the system has no switched conductances or more than MAX_SWITCHES
+	 * \throw std::runtime_error if the conductance matrices of both all switches on and all off are singular
+	 */
+	SystemSwitchBankGenerator(const SystemConductanceGenerator& cond_gen, unsigned long memory_budget, double zero_bound = 1.0e-12);
+	SystemSwitchBankGenerator(const SystemSwitchBankGenerator& base) = default;
+
+	void reset(const SystemConductanceGenerator& cond_gen, unsigned long memory_budget, double zero_bound = 1.0e-12);
+
+	/**
+		\brief sets fan-in of balanced adder trees that sum the terms of each solution x[r] in generated inline code
+		\param fan_in maximum number of terms summed by each adder of the tree; <2 keeps the linear left-to-right sums
+		\see AdderTreeGenerator
+	**/
+	inline void setAdderTreeFanIn(unsigned int fan_in) { adder_tree_fan_in = fan_in; }
+
+	/**
+		\brief sets which solutions x[i] are solved by generated inline code; rows of unsolved solutions are omitted
+
+		The solutions at the terminals of switched conductances must be solved for the correction of unbanked states.
+
+		\param solved flags indexed by solution x[i], with index 0 being ground; empty to solve all solutions
+	**/
+	inline void setSolvedSolutions(const std::vector<bool>& solved) { this->solved = solved; }
+
+	/**
+		\brief sets the index of solution x[i] computed by each row of the system, as for a Kron reduced system
+		\param indices index of solution x[i] for each row; empty for x[r+1] of row r
+		\see SystemConductanceGenerator::kronReduce()
+	**/
+	inline void setSolutionIndices(const std::vector<unsigned int>& indices) { solution_indices = indices; }
+
+	inline unsigned int getNumberOfSwitches() const { return switches.size(); }
+
+	/**
+		\return number of switch states of the system, 2^S
+	**/
+	inline unsigned long long getNumberOfStates() const { return 1ull << switches.size(); }
+
+	/**
+		\return number of switch states whose inverses are in the bank
+	**/
+	inline unsigned long getNumberOfBankedStates() const { return bank_states.size(); }
+
+	/**
+		\return number of switch states found singular while filling the bank
+	**/
+	inline unsigned long getNumberOfSingularStates() const { return num_singular_states; }
+
+	/**
+		\return packed switch state of the base state
+	**/
+	inline unsigned long getBaseState() const { return base_state; }
+
+	/**
+		\return size in bytes of the bank of inverses, at 8 bytes per element
+	**/
+	inline unsigned long getBankMemory() const { return bank_states.size()*dimension*dimension*sizeof(double); }
+
+	/**
+		\return true if every switch state is banked, so that no correction code is generated
+	**/
+	inline bool isComplete() const { return bank_states.size() + num_singular_states == getNumberOfStates(); }
+
+	/**
+		\return number of multiply-accumulates the generated solver x=(G^-1)*b performs per solve of a banked state,
+		excluding the elements discarded by zero_bound in all banked inverses
+	**/
+	unsigned long getNumberOfMultiplyAccumulates() const;
+
+	/**
+		\return largest magnitude of each element over the banked inverses
+	**/
+	inline const MatrixRMXd& getBankMagnitudes() const { return bank_magnitudes; }
+
+	/**
+		\return largest magnitude of the coefficients in generated code: the banked inverses and, if the bank is
+		incomplete, the matrices of the correction of unbanked states
+	**/
+	double getLargestCoefficientMagnitude() const;
+
+	/**
+		\brief generates C/C++ code definitions of the literal (const static) bank of inverses and the matrices of
+		the correction of unbanked states
+		\param bank_name C/C++ compatible name for the bank array; the correction arrays are suffixed by _z, _w, _p, _n, _dg_inv and _x
+		\return string containing the definitions
+	**/
+	std::string generateCLiteral(std::string bank_name) const;
+
+	/**
+		\brief writes C/C++ code definitions of the literal (const static) bank of inverses and the matrices of
+		the correction of unbanked states to a stream
+		\param out stream the definitions are written to
+		\param bank_name C/C++ compatible name for the bank array; the correction arrays are suffixed by _z, _w, _p, _n, _dg_inv and _x
+		\param type_name C/C++ type of the real valued array elements; default is real
+		\param num_threads number of threads formatting the banked inverses; 0 uses the number of hardware threads
+	**/
+	void generateCLiteral(std::ostream& out, std::string bank_name, std::string type_name = "real", unsigned int num_threads = 0) const;
+
+	/**
+		\brief generates C/C++ inline-able code that selects the banked inverse of the switch state and solves x=(G^-1)*b
+
+		Input of the inline code is NumType b[<dimension>] and the switch states, and the output is
+		NumType x[<num_nodes>+1] with x[0] being ground, as with SystemSolverGenerator.
+
+		\param bank_name name of the bank array in generated code
+		\return string containing the generated code
+	**/
+	std::string generateCInlineCode(std::string bank_name) const;
+
+	/**
+		\return printable report of the bank size and coverage of switch states
+	**/
+	std::string generateReport() const;
+
+private:
+
+	inline unsigned int solutionIndex(unsigned int r) const { return solution_indices.empty() ? r+1 : solution_indices[r]; }
+
+	inline bool isSolved(unsigned int r) const
+	{
+		return solved.empty() || (solutionIndex(r) < solved.size() && solved[solutionIndex(r)]);
+	}
+
+	/**
+		\return true if the state was banked; false if singular
+	**/
+	bool bankState(const SystemConductanceGenerator& cond_gen, unsigned long state);
+};
+
+} //namespace lblmc
+
+#endif //SYSTEMSWITCHBANKGENERATOR_HPP
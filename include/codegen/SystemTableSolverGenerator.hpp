@@ -0,0 +1,200 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef LBLMC_SYSTEMTABLESOLVERGENERATOR_HPP
+#define LBLMC_SYSTEMTABLESOLVERGENERATOR_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace lblmc
+{
+
+/**
+	\brief Generates table-driven CPU solver code for the sparse matrix-vector product x=M*v
+
+	SystemSolverGenerator unrolls x=(G^-1)*b into one multiply-accumulate statement per kept element of
+	the matrix, so the code of a large system outgrows the instruction cache, and each step streams the
+	whole unrolled code through it.  This generator instead compresses the kept elements of the matrix M
+	(typically G^-1, or the fused source gain matrix (G^-1)*A) into tables of values and column indices,
+	and emits a compact loop over the tables, whose code size does not depend on the size of the system.
+
+	The tables are stored in one of two formats, picked by getFormat():
+
+	- compressed sparse row (CSR): the kept elements of each solved row one after another, with the
+	  offset of each row into the tables, so rows of any length take no padding.
+	- ELLPACK (ELL): every solved row padded with zeros to the length of the longest row, stored slot by
+	  slot, so the loop over the rows within a slot has a fixed trip count over contiguous elements that
+	  compilers vectorize.  Used when the padding adds at most ELL_MAX_PADDING_PERCENT to the tables.
+
+	Each row accumulates its elements in column order, as the unrolled sums of SystemSolverGenerator do.
+	Column and row indices are stored as unsigned short when they fit, to halve the table traffic.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class SystemTableSolverGenerator
+{
+public:
+
+	/**
+		\brief storage formats of the tables
+	**/
+	enum Format
+	{
+		CSR = 0, ///< compressed sparse rows
+		ELL ///< rows padded to equal length, stored slot by slot
+	};
+
+	const static unsigned int ELL_MAX_PADDING_PERCENT = 25; ///< largest padding of ELL tables relative to the kept elements
+
+private:
+	unsigned int rows; ///< number of rows of M; number of solutions in x
+	unsigned int cols; ///< number of columns of M; number of elements in v
+	double zero_bound; ///< range from zero when determining whether elements of M are close to zero to be discarded; defaults to 1e-12.
+	std::vector<double> values; ///< kept elements of the solved rows of M, row after row
+	std::vector<unsigned int> columns; ///< column of each kept element
+	std::vector<unsigned int> row_offsets; ///< offset of the first kept element of each solved row, followed by the number of kept elements
+	std::vector<unsigned int> row_solutions; ///< index of solution x[i] computed by each solved row
+
+public:
+
+	SystemTableSolverGenerator();
+
+	/**
+	 * parameter constructor
+	 *
+	 * Compresses the kept elements of the solved rows of M.
+	 *
+	 * \param M dense matrix of x=M*v in row-major order
+	 * \param rows number of rows of M
+	 * \param cols number of columns of M
+	 * \param zero_bound range from zero when determining whether elements of M are close to zero to be discarded; defaults to 1e-12.
+	 * \param solved flags indexed by solution x[i], with index 0 being ground; empty to solve all solutions
+	 * \param solution_indices index of solution x[i] computed by each row of M; empty for x[r+1] of row r
+	 */
+	SystemTableSolverGenerator(const double* M, unsigned int rows, unsigned int cols, double zero_bound = 1.0e-12,
+		const std::vector<bool>& solved = std::vector<bool>(), const std::vector<unsigned int>& solution_indices = std::vector<unsigned int>());
+
+	SystemTableSolverGenerator(const SystemTableSolverGenerator& base) = default;
+
+	/**
+	 * compresses the kept elements of the solved rows of M, replacing any previous tables
+	 * \see SystemTableSolverGenerator(const double*, unsigned int, unsigned int, double, const std::vector<bool>&, const std::vector<unsigned int>&)
+	 */
+	void reset(const double* M, unsigned int rows, unsigned int cols, double zero_bound = 1.0e-12,
+		const std::vector<bool>& solved = std::vector<bool>(), const std::vector<unsigned int>& solution_indices = std::vector<unsigned int>());
+
+	/**
+		\return number of kept elements of the solved rows; the multiply-accumulates of the product per solve
+	**/
+	inline unsigned long getNumberOfNonzeros() const { return values.size(); }
+
+	/**
+		\return number of solved rows
+	**/
+	inline unsigned int getNumberOfSolvedRows() const { return row_solutions.size(); }
+
+	/**
+		\return number of kept elements of the longest solved row
+	**/
+	unsigned int getLongestRowLength() const;
+
+	/**
+		\return format of the tables: ELL if padding the rows adds at most ELL_MAX_PADDING_PERCENT to the tables, else CSR
+	**/
+	Format getFormat() const;
+
+	/**
+		\return elements of the value table in the order of getFormat(), with the padding of ELL tables as zeros
+	**/
+	std::vector<double> getValueTable() const;
+
+	/**
+		\brief writes C/C++ code definition of the literal (const static) value table <M_name>_val to a stream
+		\param out stream the definition is written to; nothing is written if no elements are kept
+		\param M_name C/C++ compatible name prefix of the tables
+		\param type_name C/C++ type of the table elements; default is real
+	**/
+	void generateValueCLiteral(std::ostream& out, std::string M_name, std::string type_name = "real") const;
+
+	/**
+		\brief writes C/C++ code definitions of the literal (const static) index tables of <M_name> to a stream
+
+		The tables are <M_name>_col of the column of each element, <M_name>_row of the solution index of each
+		solved row, and for CSR, <M_name>_ptr of the offset of each row into the tables.
+
+		\param out stream the definitions are written to; nothing is written if no elements are kept
+		\param M_name C/C++ compatible name prefix of the tables
+	**/
+	void generateIndexCLiteral(std::ostream& out, std::string M_name) const;
+
+	/**
+		\brief generates C/C++ inline-able code that solves x=M*v by looping over the tables
+
+		Input of the inline code is NumType <v_name>[cols] and the output is NumType x[rows+1] with x[0] being
+		ground, as with SystemSolverGenerator.  The generated code declares its own temporaries table_sum,
+		and loop indices table_r and table_k.
+
+		\param M_name name prefix of the tables in generated code
+		\param v_name name of the input vector in generated code; b for G^-1, or b_components for (G^-1)*A
+		\return string containing the generated code
+	**/
+	std::string generateCInlineCode(std::string M_name, std::string v_name) const;
+
+	/**
+		\brief writes C/C++ code definition of a literal (const static) table of values to a stream
+		\param out stream the definition is written to
+		\param name C/C++ compatible name of the table
+		\param values elements of the table; must not be empty
+		\param type_name C/C++ type of the table elements
+	**/
+	static void writeValueTable(std::ostream& out, std::string name, const std::vector<double>& values, std::string type_name);
+
+	/**
+		\brief writes C/C++ code definition of a literal (const static) table of indices to a stream
+		\param out stream the definition is written to
+		\param name C/C++ compatible name of the table
+		\param indices elements of the table; must not be empty
+	**/
+	static void writeIndexTable(std::ostream& out, std::string name, const std::vector<unsigned int>& indices);
+
+private:
+
+	inline unsigned int getRowLength(unsigned int i) const { return row_offsets[i+1] - row_offsets[i]; }
+
+	/**
+		\return table of indices in the order of getFormat(), with the padding of ELL tables pointing to column 0
+	**/
+	std::vector<unsigned int> getColumnTable() const;
+};
+
+} //namespace lblmc
+
+#endif //LBLMC_SYSTEMTABLESOLVERGENERATOR_HPP
@@ -0,0 +1,230 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef SYSTEMWORDLENGTHANALYZER_HPP
+#define SYSTEMWORDLENGTHANALYZER_HPP
+
+#include <vector>
+#include <string>
+
+#include "codegen/CodeGenDataTypes.hpp"
+
+namespace lblmc
+{
+
+/**
+	\brief Picks fixed point word lengths for each class of signal of a solver from worst-case range analysis
+
+	The signals of a generated solver fall in classes of very different range:
+
+	<pre>
+	COEFFICIENT -- real_coef: literal solve matrix M, such as G^-1 or (G^-1)*A, scaled by 1/divider if rescaled
+	SOURCE      -- real_src:  source vector b and component sources b_components
+	SOLUTION    -- real_sol:  solution vector x
+	STATE       -- real:      component fields and temporaries, and coefficients computed in code
+	PARAMETER   -- real_param: literal parameters of components, such as time steps and companion conductances
+	</pre>
+
+	Given the expected maximum magnitude |v[c]| of each input of the solve x=M*v, solution x[r] is bounded by
+	sum(|M(r,c)|*|v[c]|).  The integral width of each class is the fewest bits, sign included, that hold
+	its worst-case magnitude.  The fractional width of the source, solution, and state classes is the fewest
+	bits that resolve the target resolution.  Rounding the coefficients to F fractional bits changes x[r] by
+	at most divider*2^-(F+1)*sum(|v[c]|) over the kept elements of row r, so the coefficient class gets the
+	fewest fractional bits that keep this error within half of the resolution.  Component parameters span many
+	decades, from time steps to conductances stamped into the conductance matrix the solve matrix is computed from,
+	so the parameter class holds the largest parameter with the fewest fractional bits that round the smallest
+	nonzero parameter to within the target resolution relative to its magnitude.
+
+	Word widths are capped at a maximum word width by dropping fractional bits, which coarsens the achieved
+	resolution of the class.  The widths follow the ap_fixed<W, I> convention, where W is the word width and
+	I the integral width including the sign bit.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class SystemWordLengthAnalyzer
+{
+public:
+
+	/**
+		\brief classes of signals of a generated solver that get their own fixed point format
+	**/
+	enum SignalClass
+	{
+		COEFFICIENT = 0,
+		SOURCE,
+		SOLUTION,
+		STATE,
+		PARAMETER,
+		NUM_SIGNAL_CLASSES
+	};
+
+	/**
+		\brief fixed point format of a class of signals
+	**/
+	struct Format
+	{
+		unsigned int word_width; ///< width in bits of the words, including the sign bit
+		unsigned int int_width; ///< integral width in bits of the words, including the sign bit
+		double magnitude; ///< worst-case magnitude of the signals of the class
+
+		Format() : word_width(0), int_width(0), magnitude(0.0) {}
+
+		/**
+			\return weight of the least significant bit of the words
+		**/
+		double getResolution() const;
+	};
+
+private:
+	std::vector<double> solution_magnitudes; ///< worst-case magnitude of each solution, sum(|M(r,c)|*|v[c]|)
+	std::vector<double> row_input_sums; ///< sum of |v[c]| over kept elements M(r,c) of each row, bounding the coefficient rounding error
+	double matrix_magnitude; ///< largest magnitude of the kept elements of M
+	double coefficient_magnitude; ///< largest magnitude of the literal coefficients of generated code; negative to use matrix_magnitude/coefficient_divider
+	double coefficient_divider; ///< power of 2 divider the literal coefficients are scaled by
+	double inline_coefficient_magnitude; ///< largest magnitude of coefficients computed in the state class, as by sparse LU substitution
+	double source_magnitude; ///< worst-case magnitude of the source vector b and the component sources
+	double state_magnitude; ///< expected maximum magnitude of component states
+	double parameter_magnitude; ///< largest magnitude of the literal component parameters
+	double parameter_min_magnitude; ///< smallest nonzero magnitude of the literal component parameters; 0 if none
+	double resolution; ///< target resolution of last analyze()
+	unsigned int max_word_width; ///< maximum word width of last analyze()
+	Format formats[NUM_SIGNAL_CLASSES]; ///< formats picked by last analyze()
+
+public:
+
+	/**
+	 * parameter constructor
+	 * \param M dense solve matrix of x=M*v, unscaled; for inverse banks, the largest magnitude of each element over the bank
+	 * \param input_magnitudes expected maximum magnitude of each element of v; must have as many elements as M has columns
+	 * \param zero_bound range from zero within which elements of M are discarded by solver generators; defaults to 1e-12.
+	 * \throw std::invalid_argument if input_magnitudes does not match columns of M or has negative elements
+	 */
+	SystemWordLengthAnalyzer(const MatrixRMXd& M, const std::vector<double>& input_magnitudes, double zero_bound = 1.0e-12);
+	SystemWordLengthAnalyzer(const SystemWordLengthAnalyzer& base) = default;
+
+	/**
+		\brief sets the largest magnitude of the literal coefficients of generated code, when they are not M itself
+		\param magnitude largest coefficient magnitude, after scaling by the divider; negative to use M
+	**/
+	inline void setCoefficientMagnitude(double magnitude) { coefficient_magnitude = magnitude; }
+
+	/**
+		\brief sets the power of 2 divider the literal coefficients are scaled by, with the solutions multiplied back
+		\param divider power of 2 divider; 1 if the coefficients are unscaled
+		\throw std::invalid_argument if divider is not a positive power of 2
+	**/
+	void setCoefficientDivider(double divider);
+
+	/**
+		\brief sets the largest magnitude of coefficients computed in the state class instead of being literals
+		of the coefficient class, as with sparse LU substitution or the correction of unbanked switch states
+	**/
+	inline void setInlineCoefficientMagnitude(double magnitude) { inline_coefficient_magnitude = magnitude; }
+
+	/**
+		\brief sets the worst-case magnitude of the source vector b and the component sources
+	**/
+	inline void setSourceMagnitude(double magnitude) { source_magnitude = magnitude; }
+
+	/**
+		\brief sets the expected maximum magnitude of component states, such as fields and temporaries
+	**/
+	inline void setStateMagnitude(double magnitude) { state_magnitude = magnitude; }
+
+	/**
+		\brief records the magnitudes of the literal parameters declared in the given component parameter code
+		\param code declarations of component parameters, such as "const static real DT_ind = 1e-6;"; declarations of
+		other types or not initialized by a number literal are ignored
+	**/
+	void insertParameters(const std::string& code);
+
+	/**
+		\brief picks the fixed point format of each signal class
+		\param resolution target weight of the least significant bit of sources, solutions, and states; must be positive
+		\param max_word_width maximum word width of any signal class
+		\throw std::invalid_argument if resolution is not positive
+		\throw std::runtime_error if the integral width of a signal class exceeds max_word_width
+	**/
+	void analyze(double resolution, unsigned int max_word_width);
+
+	inline const Format& getFormat(SignalClass signal_class) const { return formats[signal_class]; }
+
+	/**
+		\return worst-case magnitude of each solution
+	**/
+	inline const std::vector<double>& getSolutionMagnitudes() const { return solution_magnitudes; }
+
+	/**
+		\return name of the C/C++ type of the given signal class in generated code
+	**/
+	static std::string getTypeName(SignalClass signal_class);
+
+	/**
+		\brief finds the largest magnitude of the literal parameters of given names, such as the source parameters of components
+		\param code declarations of component parameters, as given to insertParameters()
+		\param names names of the parameters to consider
+		\return largest magnitude of the named literal parameters declared in the code; 0 if none
+	**/
+	static double findParameterMagnitude(const std::string& code, const std::vector<std::string>& names);
+
+	/**
+		\brief declares the literal parameters of given component parameter code with the type of the parameter class
+		\param code declarations of component parameters, as given to insertParameters()
+		\return the code with the real type of each literal parameter replaced by real_param
+	**/
+	static std::string generateParameterCode(const std::string& code);
+
+	/**
+		\brief generates C/C++ typedefs of the type of each signal class
+		\param fixed_template name of the fixed point class template taking word and integral widths, such as ap_fixed or lblmc_fixed
+		\param extra_template_arguments arguments appended after the widths, such as ", AP_RND, AP_SAT"; may be empty
+		\return string containing the typedefs
+	**/
+	std::string generateCTypedefs(std::string fixed_template, std::string extra_template_arguments) const;
+
+	/**
+		\return printable report of the format, magnitude, and resolution of each signal class
+	**/
+	std::string generateReport() const;
+
+private:
+
+	static unsigned int integralWidth(double magnitude);
+	static int fractionalWidth(double resolution);
+
+	/**
+		\return true if the declaration is of a real parameter initialized by a number literal, whose name and value
+		are stored in name and value
+	**/
+	static bool parseLiteralParameter(const std::string& declaration, std::string& name, double& value);
+};
+
+} //namespace lblmc
+
+#endif //SYSTEMWORDLENGTHANALYZER_HPP
@@ -0,0 +1,115 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef LBLMC_WORDRENAMER_HPP
+#define LBLMC_WORDRENAMER_HPP
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+namespace lblmc
+{
+
+/**
+	\brief Replaces many words of a code template in a single pass
+
+	Specializing a code template with StringProcessor::replaceWordAll() rescans and rebuilds the
+	whole template once per word, which grows with the number of words times the template length.
+	This renamer instead splits the template into words and the delimiters between them (as defined
+	by StringProcessor::isWordDelimiter()) in one scan, looks each word up in a hash map of the words
+	to replace, and writes the result into one output buffer, so renaming takes time linear in the
+	length of the template regardless of the number of words.
+
+	A word to replace may be prefixed by delimiter characters, such as "*bpos" for a dereferenced
+	pointer, in which case only instances preceded by the prefix are replaced, prefix included.
+
+	Unlike a sequence of StringProcessor::replaceWordAll() calls, the replacements are not searched
+	for words again, so a replacement is never replaced by a later word.  If a word is added more
+	than once, its first replacement is kept, as with a sequence of calls.
+
+	\note This class is NOT intended for RTL Synthesis.
+**/
+class WordRenamer
+{
+private:
+
+	/**
+		\brief replacement of a word that is preceded by the given prefix of delimiter characters
+	**/
+	struct Replacement
+	{
+		std::string prefix; ///< delimiter characters that must precede the word; empty if none
+		std::string replacement; ///< string replacing the prefix and word
+	};
+
+	std::unordered_map< std::string, std::vector<Replacement> > replacements; ///< replacements of each word, in order added
+
+public:
+
+	WordRenamer() : replacements() {}
+
+	/**
+		\brief adds a word to replace
+		\param word word to replace, optionally prefixed by delimiter characters; cannot be empty
+		\param replacement string replacing each instance of the word
+		\throw std::invalid_argument if the word is empty or has a delimiter character after its first word character
+	**/
+	void addWord(const std::string& word, const std::string& replacement);
+
+	/**
+		\brief adds words to replace
+		\param words words to replace
+		\param new_words replacements of the words, with new_words[i] replacing words[i]
+		\throw std::invalid_argument if the numbers of words and new words differ, or a word is invalid
+	**/
+	void addWords(const std::vector<std::string>& words, const std::vector<std::string>& new_words);
+
+	inline void clear() { replacements.clear(); }
+
+	inline bool isEmpty() const { return replacements.empty(); }
+
+	/**
+		\brief replaces the added words in given body string
+		\param body string whose words are replaced
+		\return reference to body string after its words have been replaced
+	**/
+	std::string& replaceWords(std::string& body) const;
+
+	/**
+		\brief replaces the added words in copy of given body string
+		\param body string whose words are replaced in the returned copy
+		\return copy of body string with its words replaced
+	**/
+	std::string renamed(const std::string& body) const;
+
+};
+
+} //namespace lblmc
+
+#endif // LBLMC_WORDRENAMER_HPP
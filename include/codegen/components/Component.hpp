@@ -35,6 +35,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include <functional>
 
 #include "codegen/ResistiveCompanionElements.hpp"
+#include "codegen/WordRenamer.hpp"
 
 //==============================================================================================================================
 //==============================================================================================================================
@@ -340,6 +341,24 @@ public:
 	**/
 	inline virtual std::string getIntegrationMethod() const { return INTEGRATION_NONE; }
 
+	/**
+		\brief enables stamping of switch-dependent conductances by the generated component, instead of
+		modeling its switching with companion model sources only
+
+		Components that support switched conductances stamp them with
+		SystemConductanceGenerator::stampSwitchedConductance(), so that their solver is generated with a
+		bank of inverted conductance matrices indexed by switch state (see SystemSwitchBankGenerator).
+		Components that do not support it ignore this setting.  Must be set before the component is stamped.
+
+		\param enable true to stamp switched conductances if supported; false for the default models
+	**/
+	inline virtual void setSwitchedConductanceEnable(bool enable) {}
+
+	/**
+		\return true if the generated component stamps switch-dependent conductances
+	**/
+	inline virtual bool isSwitchedConductanceEnabled() const { return false; }
+
 	/**
 		\return vector storing names of supported inputs to generated component
 	**/
@@ -350,6 +369,13 @@ public:
 	**/
 	inline virtual std::vector<std::string> getSupportedOutputs() const { return std::vector<std::string>(); }
 
+	/**
+		\return vector storing names of the literal parameters of generated component that only set source or control
+		values, and are neither stamped into the conductance matrix nor derived from parameters that are; only these
+		may differ between the instances of a batched solver (see SystemBatchGenerator)
+	**/
+	inline virtual std::vector<std::string> getSourceParameters() const { return std::vector<std::string>(); }
+
 //==============================================================================================================================
 
 	/**
@@ -478,6 +504,37 @@ protected:
 	std::string&
 	replaceSourceNames(std::string& body, const std::vector<Component::Source>& sources);
 
+	/**
+		\brief adds given words to given renamer, to be appended with component name
+
+		Adding all words of a code template to one renamer, and replacing them with
+		WordRenamer::replaceWords(), specializes the template in a single pass.
+
+		\param renamer renamer to which the words are added
+		\param words words that will have component name appended to
+	**/
+	void addNameToWords(WordRenamer& renamer, const std::vector<std::string>& words) const;
+
+	/**
+		\brief adds labels of given fields to given renamer, to be appended with component name
+	**/
+	void addNameToFields(WordRenamer& renamer, const std::vector<Component::Field>& fields) const;
+
+	/**
+		\brief adds source name to given renamer, to be replaced with source contribution vector b_components[id]
+	**/
+	void addSourceNameWithSourceContributionVector(WordRenamer& renamer, const std::string& src_name, unsigned int source_id) const;
+
+	/**
+		\brief adds labels of given terminals to given renamer, to be replaced with their node indices
+	**/
+	void addTerminalConnectionNames(WordRenamer& renamer, const std::vector<Component::Terminal>& terminals) const;
+
+	/**
+		\brief adds labels of given sources to given renamer, to be replaced with source contribution vector b_components[id]
+	**/
+	void addSourceNames(WordRenamer& renamer, const std::vector<Component::Source>& sources) const;
+
 //==============================================================================================================================
 
 	inline
@@ -59,6 +59,7 @@ public:
 
 	inline void setParameters(double i) { CURRENT=i; }
 	inline const double& getCurrent() const { return CURRENT; }
+	inline std::vector<std::string> getSourceParameters() const { return std::vector<std::string>(1, appendName("SRC_CURRENT")); }
 
 	void getSourceIds(std::vector<unsigned int>& ids) const;
 	void getResistiveCompanionElements(std::vector<ResistiveCompanionElement>& elements) const;
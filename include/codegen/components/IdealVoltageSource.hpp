@@ -62,6 +62,7 @@ public:
 
 	inline void setParameters(double v) { VOLTAGE = v; }
 	inline const double& getVoltage() const { return VOLTAGE; }
+	inline std::vector<std::string> getSourceParameters() const { return std::vector<std::string>(1, appendName("VOLTAGE")); }
 
 	inline unsigned int getNumberOfIdealVoltageSources() const { return 1; }
 
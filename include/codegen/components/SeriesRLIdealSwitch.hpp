@@ -41,6 +41,8 @@ private:
 	double DT;
 	double L;
 	double R;
+	double GOFF; ///< conductance of open switch when stamping switched conductances
+	bool switched_conductance_enable; ///< stamp switched conductance with Euler Backward companion model instead of explicit model
 
 	unsigned int P, N;
 	unsigned int source_id;
@@ -83,6 +85,20 @@ public:
 	inline const double& getInductance() const { return L; }
 	inline const double& getResistance() const { return R; }
 
+	/**
+		\brief sets conductance of the open switch, used only when stamping switched conductances
+		\param goff non-negative off conductance; 0 for an ideal open switch, which leaves nodes only connected
+		through the switch floating
+	**/
+	inline void setOffConductance(double goff)
+	{
+		if(goff < 0.0)
+			throw std::invalid_argument("SeriesRLIdealSwitch::setOffConductance(double) -- off conductance cannot be negative");
+
+		GOFF = goff;
+	}
+	inline const double& getOffConductance() const { return GOFF; }
+
 	inline void setIntegrationMethod(std::string method)
 	{
 		if(method == INTEGRATION_EULER_FORWARD || method == INTEGRATION_RUNGE_KUTTA_4)
@@ -91,9 +107,16 @@ public:
 	}
 	inline std::string getIntegrationMethod() const
 	{
+		if(switched_conductance_enable) return INTEGRATION_EULER_BACKWARD;
+
 		return integration_method;
 	}
 
+		//when enabled, the switch branch is stamped as conductance 1/(R+L/DT) when on and GOFF when off,
+		//with an Euler Backward (implicit) companion model that stays stable for time steps beyond L/R
+	inline void setSwitchedConductanceEnable(bool enable) { switched_conductance_enable = enable; }
+	inline bool isSwitchedConductanceEnabled() const { return switched_conductance_enable; }
+
 	inline std::vector<std::string> getSupportedInputs() const { return std::vector<std::string>{"sw"}; }
 
 	inline std::vector<std::string> getSupportedOutputs() const
@@ -118,6 +141,7 @@ public:
 private:
 	std::string generateUpdateBodyEulerForward();
 	std::string generateUpdateBodyRungeKutta4();
+	std::string generateUpdateBodySwitchedConductance();
 };
 
 } //namespace lblmc
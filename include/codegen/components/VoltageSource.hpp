@@ -62,6 +62,7 @@ public:
 	inline const double& getVoltage() const { return VOLTAGE; }
 	inline const double& getResistance() const { return RES; }
 	inline const double getConductance() const { return 1.0/RES; }
+	inline std::vector<std::string> getSourceParameters() const { return std::vector<std::string>(1, appendName("SRC_CURRENT")); }
 
 	void getSourceIds(std::vector<unsigned int>& ids) const;
 	void getResistiveCompanionElements(std::vector<ResistiveCompanionElement>& elements) const;
@@ -0,0 +1,606 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+/**
+
+	\author Matthew Milton
+	\date 2023
+
+ **/
+#ifndef LBLMC_FIXED_HPP
+#define LBLMC_FIXED_HPP
+
+/**
+	\file lblmc_fixed.hpp
+
+	\brief Header-only fixed point emulation, bit-accurate with Xilinx ap_fixed, for running the numerics of
+	generated fixed point solvers on CPUs
+
+	lblmc_fixed<W, I, Q, O> is a W bit (1 to 64) signed fixed point word with I integral bits, sign included,
+	quantization mode Q, and overflow mode O, which follow ap_fixed<W, I, Q, O>:
+
+	<pre>
+	LBLMC_RND          round to nearest, ties towards positive infinity
+	LBLMC_RND_ZERO     round to nearest, ties towards zero
+	LBLMC_RND_MIN_INF  round to nearest, ties towards negative infinity
+	LBLMC_RND_INF      round to nearest, ties away from zero
+	LBLMC_RND_CONV     round to nearest, ties to even
+	LBLMC_TRN          truncate towards negative infinity (default)
+	LBLMC_TRN_ZERO     truncate towards zero
+
+	LBLMC_SAT          saturate to the most positive or negative value
+	LBLMC_SAT_ZERO     set to zero on overflow
+	LBLMC_SAT_SYM      saturate symmetrically to the most positive value or its negative
+	LBLMC_WRAP         keep the W least significant bits (default)
+	</pre>
+
+	As with ap_fixed, addition, subtraction, and multiplication are exact: they yield lblmc_fixed_wide<F>
+	intermediates, which hold exact values with F fractional bits, and quantization and overflow handling
+	apply only when a result is stored into a lblmc_fixed.  Intermediates are 128 bit integers (__int128
+	where the compiler has it, otherwise a portable two-word integer), so results are bit-accurate as long
+	as the exact intermediates fit in 128 bits, as for sums of up to 2^(127-W1-W2) products of W1 and W2
+	bit words.  Division truncates towards zero to the fractional bits of the dividend, exactly as long as
+	the quotient fits in 128 bits, which is not bit-accurate with ap_fixed; division by zero yields zero.
+
+	Floating point operands of arithmetic are first converted to the format of the fixed point operand, or
+	truncated to the fractional bits of an intermediate, while comparisons with them are evaluated in double
+	as with ap_fixed.  Integer operands are exact.  Conversions to double are explicit, so that expressions
+	never silently fall back to floating point.
+
+	Define LBLMC_FIXED_PORTABLE to use the portable two-word integer even where __int128 is available.
+
+	Unlike the rest of the generated code, which is C++03, this header requires C++11.
+**/
+
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+enum lblmc_q_mode
+{
+	LBLMC_RND = 0,
+	LBLMC_RND_ZERO,
+	LBLMC_RND_MIN_INF,
+	LBLMC_RND_INF,
+	LBLMC_RND_CONV,
+	LBLMC_TRN,
+	LBLMC_TRN_ZERO
+};
+
+enum lblmc_o_mode
+{
+	LBLMC_SAT = 0,
+	LBLMC_SAT_ZERO,
+	LBLMC_SAT_SYM,
+	LBLMC_WRAP
+};
+
+//==================================================================================================
+// 128 BIT INTEGERS
+
+#if defined(__SIZEOF_INT128__) && !defined(LBLMC_FIXED_PORTABLE)
+
+__extension__ typedef __int128 lblmc_int128;
+__extension__ typedef unsigned __int128 lblmc_uint128;
+
+inline lblmc_int128 lblmc_shl(lblmc_int128 v, int s) { return (lblmc_int128)((lblmc_uint128)v << s); }
+inline lblmc_int128 lblmc_shr(lblmc_int128 v, int s) { return v >> s; }
+inline double lblmc_to_double(lblmc_int128 v) { return (double)v; }
+
+#else
+
+/**
+	\brief portable two's complement 128 bit integer, for compilers without __int128
+**/
+class lblmc_int128
+{
+public:
+
+	std::uint64_t lo;
+	std::int64_t hi;
+
+	lblmc_int128() : lo(0), hi(0) {}
+	lblmc_int128(long long v) : lo((std::uint64_t)v), hi(v < 0 ? -1 : 0) {}
+	lblmc_int128(std::uint64_t lo, std::int64_t hi) : lo(lo), hi(hi) {}
+
+	friend lblmc_int128 operator+(lblmc_int128 a, lblmc_int128 b)
+	{
+		const std::uint64_t lo = a.lo + b.lo;
+		return lblmc_int128(lo, (std::int64_t)((std::uint64_t)a.hi + (std::uint64_t)b.hi + (lo < a.lo)));
+	}
+
+	friend lblmc_int128 operator-(lblmc_int128 a) { return lblmc_int128(~a.lo, ~a.hi) + lblmc_int128(1); }
+	friend lblmc_int128 operator-(lblmc_int128 a, lblmc_int128 b) { return a + (-b); }
+
+	friend lblmc_int128 operator*(lblmc_int128 a, lblmc_int128 b)
+	{
+			//low 128 bits of the product, from 32 bit limbs of the low words plus the cross terms of the high words
+
+		const std::uint64_t a0 = a.lo & 0xFFFFFFFFu, a1 = a.lo >> 32;
+		const std::uint64_t b0 = b.lo & 0xFFFFFFFFu, b1 = b.lo >> 32;
+
+		const std::uint64_t p00 = a0*b0, p01 = a0*b1, p10 = a1*b0, p11 = a1*b1;
+		const std::uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFFu) + (p10 & 0xFFFFFFFFu);
+
+		const std::uint64_t lo = (p00 & 0xFFFFFFFFu) | (mid << 32);
+		const std::uint64_t hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32) +
+			a.lo*(std::uint64_t)b.hi + (std::uint64_t)a.hi*b.lo;
+
+		return lblmc_int128(lo, (std::int64_t)hi);
+	}
+
+	friend bool operator==(lblmc_int128 a, lblmc_int128 b) { return a.hi == b.hi && a.lo == b.lo; }
+	friend bool operator!=(lblmc_int128 a, lblmc_int128 b) { return !(a == b); }
+	friend bool operator<(lblmc_int128 a, lblmc_int128 b) { return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo); }
+	friend bool operator>(lblmc_int128 a, lblmc_int128 b) { return b < a; }
+	friend bool operator<=(lblmc_int128 a, lblmc_int128 b) { return !(b < a); }
+	friend bool operator>=(lblmc_int128 a, lblmc_int128 b) { return !(a < b); }
+
+	explicit operator long long() const { return (long long)lo; }
+};
+
+inline lblmc_int128 lblmc_shl(lblmc_int128 v, int s)
+{
+	if(s == 0) return v;
+	if(s >= 64) return lblmc_int128(0, (std::int64_t)(v.lo << (s-64)));
+
+	return lblmc_int128(v.lo << s, (std::int64_t)(((std::uint64_t)v.hi << s) | (v.lo >> (64-s))));
+}
+
+inline lblmc_int128 lblmc_shr(lblmc_int128 v, int s)
+{
+	if(s == 0) return v;
+	if(s >= 64) return lblmc_int128((std::uint64_t)(v.hi >> (s-64 < 63 ? s-64 : 63)), v.hi < 0 ? -1 : 0);
+
+	return lblmc_int128((v.lo >> s) | ((std::uint64_t)v.hi << (64-s)), v.hi >> s);
+}
+
+inline double lblmc_to_double(lblmc_int128 v)
+{
+	return std::ldexp((double)v.hi, 64) + (double)v.lo;
+}
+
+#endif
+
+/**
+	\return v*2^s/d truncated towards zero, or zero if d is zero
+**/
+inline lblmc_int128 lblmc_div(lblmc_int128 v, int s, lblmc_int128 d)
+{
+	const lblmc_int128 zero(0);
+
+	if(d == zero) return zero;
+
+	const bool neg = (v < zero) != (d < zero);
+	const lblmc_int128 n = v < zero ? -v : v;
+	const lblmc_int128 m = d < zero ? -d : d;
+
+#if defined(__SIZEOF_INT128__) && !defined(LBLMC_FIXED_PORTABLE)
+	if(s < 126 && lblmc_shr(n, 126-s) == zero)
+	{
+		const lblmc_int128 q = lblmc_shl(n, s)/m;
+		return neg ? -q : q;
+	}
+#endif
+
+		//long division over the 127 magnitude bits of v followed by s zero bits, comparing the remainder r
+		//against m-r rather than forming 2r, which may not fit
+
+	lblmc_int128 q(0);
+	lblmc_int128 r(0);
+
+	for(int i = 126 + s; i >= 0; i--)
+	{
+		const lblmc_int128 bit(i >= s ? (long long)lblmc_shr(n, i-s) & 1 : 0);
+		const lblmc_int128 t = m - r;
+
+		q = lblmc_shl(q, 1);
+
+		if(r + bit >= t)
+		{
+			r = r + bit - t;
+			q = q + lblmc_int128(1);
+		}
+		else
+		{
+			r = r + r + bit;
+		}
+	}
+
+	return neg ? -q : q;
+}
+
+//==================================================================================================
+// QUANTIZATION AND OVERFLOW
+
+/**
+	\return raw word of a value beyond the range of a W bit word with overflow mode O, other than wrapping
+**/
+template<int W, lblmc_o_mode O>
+inline long long lblmc_overflow(bool neg)
+{
+	const long long max = (long long)(((unsigned long long)1 << (W-1)) - 1);
+
+	switch(O)
+	{
+		case LBLMC_SAT:      return neg ? -max-1 : max;
+		case LBLMC_SAT_SYM:  return neg ? -max : max;
+		default:             return 0;
+	}
+}
+
+/**
+	\brief quantizes value v with F_src fractional bits into a W bit word with F fractional bits
+	\return raw word of the quantized value
+**/
+template<int W, int F, lblmc_q_mode Q, lblmc_o_mode O>
+inline long long lblmc_quantize(lblmc_int128 v, int F_src)
+{
+	const int d = F_src - F;
+
+	lblmc_int128 q;
+
+	if(d > 0)
+	{
+			//values of fewer than 64 significant bits classify alike for any shift beyond their width
+
+		const int s = d < 126 ? d : 126;
+
+			//rounding as a bias added before the flooring shift, so that ties and truncation need no branches
+
+		if(Q != LBLMC_TRN)
+		{
+			const lblmc_int128 half = lblmc_shl(lblmc_int128(1), s-1);
+			const lblmc_int128 neg = v < lblmc_int128(0) ? lblmc_int128(1) : lblmc_int128(0);
+			lblmc_int128 bias;
+
+			switch(Q)
+			{
+				case LBLMC_RND:         bias = half; break;
+				case LBLMC_RND_ZERO:    bias = half - lblmc_int128(1) + neg; break;
+				case LBLMC_RND_MIN_INF: bias = half - lblmc_int128(1); break;
+				case LBLMC_RND_INF:     bias = half - neg; break;
+				case LBLMC_RND_CONV:    bias = half - lblmc_int128(1) + lblmc_int128((long long)lblmc_shr(v, s) & 1); break;
+				default:                bias = v < lblmc_int128(0) ? lblmc_shl(lblmc_int128(1), s) - lblmc_int128(1) : lblmc_int128(0); break;
+			}
+
+			v = v + bias;
+		}
+
+		q = lblmc_shr(v, s);
+	}
+	else
+	{
+		q = lblmc_shl(v, -d);
+	}
+
+	const long long low = (long long)q;
+
+	if(O != LBLMC_WRAP)
+	{
+			//in range when the bits above the sign bit all equal the sign bit
+
+		const lblmc_int128 top = lblmc_shr(q, W-1);
+
+		if(top != lblmc_int128(0) && top != lblmc_int128(-1))
+			return lblmc_overflow<W, O>(q < lblmc_int128(0));
+
+		if(O == LBLMC_SAT_SYM && low == (long long)(~(unsigned long long)0 << (W-1)))
+			return lblmc_overflow<W, O>(true);
+
+		return low;
+	}
+
+		//keep the W least significant bits, sign extended
+
+	const int u = W < 64 ? 64-W : 0;
+
+	return (long long)((unsigned long long)low << u) >> u;
+}
+
+/**
+	\brief quantizes double v into a W bit word with F fractional bits
+	\return raw word of the quantized value
+**/
+template<int W, int F, lblmc_q_mode Q, lblmc_o_mode O>
+inline long long lblmc_quantize(double v)
+{
+	if(v == 0.0 || v != v) return 0;
+
+		//v = m*2^(e-53) exactly, with |m| < 2^53
+
+	int e;
+	const double f = std::frexp(v, &e);
+	const long long m = (long long)std::ldexp(f, 53);
+
+		//far beyond the range of the word, where its W least significant bits are zero
+
+	if(e - 53 + F >= W)
+		return lblmc_overflow<W, O>(m < 0);
+
+	return lblmc_quantize<W, F, Q, O>(lblmc_int128(m), 53 - e);
+}
+
+//==================================================================================================
+// FIXED POINT TYPES
+
+/**
+	\brief exact fixed point intermediate with F fractional bits, as yielded by arithmetic of fixed point words
+**/
+template<int F>
+class lblmc_fixed_wide
+{
+public:
+
+	lblmc_int128 raw;
+
+	static const int frac_width = F;
+
+	lblmc_fixed_wide() : raw(0) {}
+
+	template<typename S, typename std::enable_if<std::is_integral<S>::value, int>::type = 0>
+	lblmc_fixed_wide(S v) : raw(F >= 0 ? lblmc_shl(lblmc_int128((long long)v), F) : lblmc_shr(lblmc_int128((long long)v), -F)) {}
+
+	template<typename S, typename std::enable_if<std::is_floating_point<S>::value, int>::type = 0>
+	lblmc_fixed_wide(S v) : raw(fromDouble((double)v)) {}
+
+	static lblmc_fixed_wide fromRaw(lblmc_int128 r) { lblmc_fixed_wide w; w.raw = r; return w; }
+
+	const lblmc_fixed_wide& wide() const { return *this; }
+
+	explicit operator double() const { return lblmc_to_double(raw)*std::ldexp(1.0, -F); }
+	explicit operator bool() const { return raw != lblmc_int128(0); }
+
+	double to_double() const { return (double)*this; }
+
+private:
+
+	static lblmc_int128 fromDouble(double v)
+	{
+		if(v == 0.0 || v != v) return lblmc_int128(0);
+
+			//v = m*2^(e-53) exactly, truncated towards negative infinity to F fractional bits
+
+		int e;
+		const long long m = (long long)std::ldexp(std::frexp(v, &e), 53);
+		const int s = e - 53 + F;
+
+		if(s >= 0) return lblmc_shl(lblmc_int128(m), s < 127 ? s : 127);
+
+		return lblmc_shr(lblmc_int128(m), -s < 127 ? -s : 127);
+	}
+};
+
+/**
+	\brief W bit fixed point word with I integral bits, quantization mode Q, and overflow mode O, as ap_fixed<W, I, Q, O>
+**/
+template<int W, int I, lblmc_q_mode Q = LBLMC_TRN, lblmc_o_mode O = LBLMC_WRAP>
+class lblmc_fixed
+{
+public:
+
+	static_assert(W > 0 && W <= 64, "lblmc_fixed word width must be 1 to 64 bits");
+
+	static const int width = W;
+	static const int iwidth = I;
+	static const int frac_width = W - I;
+
+	long long raw;
+
+	lblmc_fixed() : raw(0) {}
+
+	template<typename S, typename std::enable_if<std::is_arithmetic<S>::value, int>::type = 0>
+	lblmc_fixed(S v) : raw(fromScalar(v, std::is_integral<S>())) {}
+
+	template<int F>
+	lblmc_fixed(const lblmc_fixed_wide<F>& v) : raw(lblmc_quantize<W, W-I, Q, O>(v.raw, F)) {}
+
+	template<int W2, int I2, lblmc_q_mode Q2, lblmc_o_mode O2>
+	lblmc_fixed(const lblmc_fixed<W2, I2, Q2, O2>& v) : raw(lblmc_quantize<W, W-I, Q, O>(lblmc_int128(v.raw), W2-I2)) {}
+
+	lblmc_fixed_wide<W-I> wide() const { return lblmc_fixed_wide<W-I>::fromRaw(lblmc_int128(raw)); }
+
+	explicit operator double() const { return (double)raw*std::ldexp(1.0, I-W); }
+	explicit operator bool() const { return raw != 0; }
+
+	double to_double() const { return (double)*this; }
+
+	template<typename T> lblmc_fixed& operator+=(const T& v) { return *this = *this + v; }
+	template<typename T> lblmc_fixed& operator-=(const T& v) { return *this = *this - v; }
+	template<typename T> lblmc_fixed& operator*=(const T& v) { return *this = *this * v; }
+	template<typename T> lblmc_fixed& operator/=(const T& v) { return *this = *this / v; }
+
+private:
+
+	template<typename S>
+	static long long fromScalar(S v, std::true_type)
+	{
+		return lblmc_quantize<W, W-I, Q, O>(lblmc_int128((long long)v), 0);
+	}
+
+	template<typename S>
+	static long long fromScalar(S v, std::false_type)
+	{
+		return lblmc_quantize<W, W-I, Q, O>((double)v);
+	}
+};
+
+//==================================================================================================
+// ARITHMETIC
+
+template<typename T> struct lblmc_is_fixed : std::false_type {};
+template<int F> struct lblmc_is_fixed< lblmc_fixed_wide<F> > : std::true_type {};
+template<int W, int I, lblmc_q_mode Q, lblmc_o_mode O> struct lblmc_is_fixed< lblmc_fixed<W, I, Q, O> > : std::true_type {};
+
+template<typename A, typename B> struct lblmc_fixed_binary
+{
+	static const int FA = A::frac_width;
+	static const int FB = B::frac_width;
+	static const int F = FA > FB ? FA : FB;
+
+	typedef lblmc_fixed_wide<F> sum_type;
+	typedef lblmc_fixed_wide<FA+FB> product_type;
+	typedef lblmc_fixed_wide<FA> quotient_type;
+
+	static lblmc_int128 alignA(const A& a) { return lblmc_shl(a.wide().raw, F-FA); }
+	static lblmc_int128 alignB(const B& b) { return lblmc_shl(b.wide().raw, F-FB); }
+};
+
+	//result types of fixed point operands only, so that other operands drop out of overload resolution instead of
+	//instantiating lblmc_fixed_binary
+
+template<typename A, typename B, bool = lblmc_is_fixed<A>::value && lblmc_is_fixed<B>::value>
+struct lblmc_fixed_result {};
+
+template<typename A, typename B>
+struct lblmc_fixed_result<A, B, true>
+{
+	typedef typename lblmc_fixed_binary<A, B>::sum_type sum_type;
+	typedef typename lblmc_fixed_binary<A, B>::product_type product_type;
+	typedef typename lblmc_fixed_binary<A, B>::quotient_type quotient_type;
+	typedef bool compare_type;
+};
+
+template<typename A, typename B>
+inline typename lblmc_fixed_result<A, B>::sum_type
+operator+(const A& a, const B& b)
+{
+	typedef lblmc_fixed_binary<A, B> op;
+	return op::sum_type::fromRaw(op::alignA(a) + op::alignB(b));
+}
+
+template<typename A, typename B>
+inline typename lblmc_fixed_result<A, B>::sum_type
+operator-(const A& a, const B& b)
+{
+	typedef lblmc_fixed_binary<A, B> op;
+	return op::sum_type::fromRaw(op::alignA(a) - op::alignB(b));
+}
+
+template<typename A, typename B>
+inline typename lblmc_fixed_result<A, B>::product_type
+operator*(const A& a, const B& b)
+{
+	return lblmc_fixed_binary<A, B>::product_type::fromRaw(a.wide().raw * b.wide().raw);
+}
+
+template<typename A, typename B>
+inline typename lblmc_fixed_result<A, B>::quotient_type
+operator/(const A& a, const B& b)
+{
+	typedef lblmc_fixed_binary<A, B> op;
+
+		//(a*2^FB)/b truncated towards zero, exact in 128 bits
+
+	return op::quotient_type::fromRaw(lblmc_div(a.wide().raw, op::FB, b.wide().raw));
+}
+
+template<typename A>
+inline typename std::enable_if<lblmc_is_fixed<A>::value, lblmc_fixed_wide<A::frac_width> >::type
+operator-(const A& a)
+{
+	return lblmc_fixed_wide<A::frac_width>::fromRaw(-a.wide().raw);
+}
+
+template<typename A>
+inline typename std::enable_if<lblmc_is_fixed<A>::value, const A&>::type
+operator+(const A& a)
+{
+	return a;
+}
+
+#define LBLMC_FIXED_COMPARE(OP) \
+	template<typename A, typename B> \
+	inline typename lblmc_fixed_result<A, B>::compare_type \
+	operator OP(const A& a, const B& b) \
+	{ \
+		typedef lblmc_fixed_binary<A, B> op; \
+		return op::alignA(a) OP op::alignB(b); \
+	}
+
+LBLMC_FIXED_COMPARE(==)
+LBLMC_FIXED_COMPARE(!=)
+LBLMC_FIXED_COMPARE(<)
+LBLMC_FIXED_COMPARE(>)
+LBLMC_FIXED_COMPARE(<=)
+LBLMC_FIXED_COMPARE(>=)
+
+#undef LBLMC_FIXED_COMPARE
+
+	//scalar operands of arithmetic are converted to the type of the fixed point operand; integers are exact
+
+template<typename A, typename S>
+inline typename std::enable_if<std::is_integral<S>::value, lblmc_fixed_wide<0> >::type
+lblmc_fixed_scalar(const A&, S v)
+{
+	return lblmc_fixed_wide<0>(v);
+}
+
+template<typename A, typename S>
+inline typename std::enable_if<std::is_floating_point<S>::value, A>::type
+lblmc_fixed_scalar(const A&, S v)
+{
+	return A(v);
+}
+
+#define LBLMC_FIXED_SCALAR_OP(OP) \
+	template<typename A, typename S, typename std::enable_if<lblmc_is_fixed<A>::value && std::is_arithmetic<S>::value, int>::type = 0> \
+	inline auto operator OP(const A& a, S s) -> decltype(a OP lblmc_fixed_scalar(a, s)) \
+	{ \
+		return a OP lblmc_fixed_scalar(a, s); \
+	} \
+	template<typename S, typename A, typename std::enable_if<lblmc_is_fixed<A>::value && std::is_arithmetic<S>::value, int>::type = 0> \
+	inline auto operator OP(S s, const A& a) -> decltype(lblmc_fixed_scalar(a, s) OP a) \
+	{ \
+		return lblmc_fixed_scalar(a, s) OP a; \
+	}
+
+LBLMC_FIXED_SCALAR_OP(+)
+LBLMC_FIXED_SCALAR_OP(-)
+LBLMC_FIXED_SCALAR_OP(*)
+LBLMC_FIXED_SCALAR_OP(/)
+
+#undef LBLMC_FIXED_SCALAR_OP
+
+	//fixed point operands are compared with integers exactly and with floating point values in double, as with ap_fixed
+
+#define LBLMC_FIXED_SCALAR_COMPARE(OP) \
+	template<typename A, typename S, typename std::enable_if<lblmc_is_fixed<A>::value && std::is_integral<S>::value, int>::type = 0> \
+	inline bool operator OP(const A& a, S s) { return a OP lblmc_fixed_wide<0>(s); } \
+	template<typename S, typename A, typename std::enable_if<lblmc_is_fixed<A>::value && std::is_integral<S>::value, int>::type = 0> \
+	inline bool operator OP(S s, const A& a) { return lblmc_fixed_wide<0>(s) OP a; } \
+	template<typename A, typename S, typename std::enable_if<lblmc_is_fixed<A>::value && std::is_floating_point<S>::value, int>::type = 0> \
+	inline bool operator OP(const A& a, S s) { return (double)a OP (double)s; } \
+	template<typename S, typename A, typename std::enable_if<lblmc_is_fixed<A>::value && std::is_floating_point<S>::value, int>::type = 0> \
+	inline bool operator OP(S s, const A& a) { return (double)s OP (double)a; }
+
+LBLMC_FIXED_SCALAR_COMPARE(==)
+LBLMC_FIXED_SCALAR_COMPARE(!=)
+LBLMC_FIXED_SCALAR_COMPARE(<)
+LBLMC_FIXED_SCALAR_COMPARE(>)
+LBLMC_FIXED_SCALAR_COMPARE(<=)
+LBLMC_FIXED_SCALAR_COMPARE(>=)
+
+#undef LBLMC_FIXED_SCALAR_COMPARE
+
+#endif //LBLMC_FIXED_HPP
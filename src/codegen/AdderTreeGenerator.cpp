@@ -0,0 +1,112 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include "codegen/AdderTreeGenerator.hpp"
+
+#include <vector>
+#include <string>
+#include <sstream>
+
+namespace lblmc
+{
+
+static std::string joinSum(std::vector<std::string>::const_iterator begin, std::vector<std::string>::const_iterator end)
+{
+	std::string sum = *begin;
+
+	for(auto iter = begin+1; iter != end; iter++)
+	{
+		sum += " + ";
+		sum += *iter;
+	}
+
+	return sum;
+}
+
+std::string AdderTreeGenerator::generatePartialSums
+(
+	std::string& code,
+	const std::vector<std::string>& terms,
+	const std::string& partial_prefix
+) const
+{
+	if(terms.empty()) return std::string("real(0.0)");
+
+	if(!isEnabled() || terms.size() <= fan_in)
+	{
+		return joinSum(terms.begin(), terms.end());
+	}
+
+	std::stringstream sstrm;
+	std::vector<std::string> operands = terms;
+	unsigned int level = 0;
+
+	while(operands.size() > fan_in)
+	{
+		std::vector<std::string> partials;
+
+		for(unsigned int i = 0; i < operands.size(); i += fan_in)
+		{
+			auto group_end = (i+fan_in < operands.size()) ? operands.begin()+i+fan_in : operands.end();
+
+			if(group_end - (operands.begin()+i) == 1) //lone operand is carried up to next level
+			{
+				partials.push_back(operands[i]);
+				continue;
+			}
+
+			std::stringstream name;
+			name << partial_prefix << "_" << level << "_" << partials.size();
+
+			sstrm << "real " << name.str() << " = " << joinSum(operands.begin()+i, group_end) << ";\n";
+
+			partials.push_back(name.str());
+		}
+
+		operands.swap(partials);
+		level++;
+	}
+
+	code += sstrm.str();
+
+	return joinSum(operands.begin(), operands.end());
+}
+
+std::string AdderTreeGenerator::generateAssignment
+(
+	const std::string& target,
+	const std::vector<std::string>& terms,
+	const std::string& partial_prefix
+) const
+{
+	std::string code;
+	std::string sum = generatePartialSums(code, terms, partial_prefix);
+
+	code += target;
+	code += " = ";
+	code += sum;
+	code += ";\n";
+
+	return code;
+}
+
+} //namespace lblmc
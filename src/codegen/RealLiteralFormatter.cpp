@@ -0,0 +1,157 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/RealLiteralFormatter.hpp"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+	//floating point std::to_chars() is C++17; C++14 builds format with snprintf()
+
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+
+namespace lblmc
+{
+
+char* RealLiteralFormatter::format(char* first, double value)
+{
+		//scientific notation keeps every literal a floating point literal, even for integral values
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+	return std::to_chars(first, first + MAX_LENGTH, value, std::chars_format::scientific).ptr;
+#else
+		//15 significant digits hold any decimal of up to 15 digits exactly, so when they round trip, the shortest
+		//literal is theirs without trailing zeros; otherwise 16 or 17 digits
+
+	int length = 0;
+
+	for(int precision = 14; precision <= 16; precision++)
+	{
+		length = std::snprintf(first, MAX_LENGTH, "%.*e", precision, value);
+
+		if(std::strtod(first, nullptr) == value || value != value) break;
+	}
+
+	char* exponent = std::strchr(first, 'e');
+	if(exponent == nullptr) return first + length;
+
+	char* mantissa_end = exponent;
+	while(mantissa_end[-1] == '0') mantissa_end--;
+	if(mantissa_end[-1] == '.') mantissa_end--;
+
+	const std::size_t exponent_length = first + length - exponent;
+	std::memmove(mantissa_end, exponent, exponent_length);
+
+	return mantissa_end + exponent_length;
+#endif
+}
+
+std::string RealLiteralFormatter::format(double value)
+{
+	char buf[MAX_LENGTH];
+
+	return std::string(buf, format(buf, value));
+}
+
+void RealLiteralFormatter::writeMatrixRows(std::ostream& out, const double* M, unsigned int rows, unsigned int cols, unsigned int num_threads)
+{
+	if(M == nullptr || rows == 0) return;
+
+	if(num_threads == 0) num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+	const unsigned int chunk_rows = std::max(1u, CHUNK_SIZE/std::max(1u, cols));
+	const unsigned int num_chunks = (rows + chunk_rows - 1)/chunk_rows;
+
+	num_threads = std::min(num_threads, num_chunks);
+
+	std::vector<std::string> chunks(num_threads);
+
+	auto formatChunk = [&](unsigned int chunk, std::string& buf)
+	{
+		const unsigned int first_row = chunk*chunk_rows;
+		const unsigned int last_row = std::min(rows, first_row + chunk_rows);
+
+			//each element takes at most MAX_LENGTH characters and a separator, and each row two braces, a comma and a newline
+
+		buf.resize( std::size_t(last_row - first_row)*(std::size_t(cols)*(MAX_LENGTH + 1) + 4) );
+
+		char* p = &buf[0];
+
+		for(unsigned int r = first_row; r < last_row; r++)
+		{
+			const double* row = M + std::size_t(r)*cols;
+
+			*p++ = '{';
+
+			for(unsigned int c = 0; c < cols; c++)
+			{
+				if(c != 0) *p++ = ',';
+				p = format(p, row[c]);
+			}
+
+			*p++ = '}';
+
+			if(r != rows-1) *p++ = ',';
+
+			*p++ = '\n';
+		}
+
+		buf.resize(p - &buf[0]);
+	};
+
+		//chunks are formatted a wave of num_threads at a time, so at most one wave of text is held in memory
+
+	for(unsigned int wave = 0; wave < num_chunks; wave += num_threads)
+	{
+		const unsigned int wave_size = std::min(num_threads, num_chunks - wave);
+
+		std::vector<std::thread> threads;
+
+		for(unsigned int t = 1; t < wave_size; t++)
+		{
+			threads.emplace_back(formatChunk, wave + t, std::ref(chunks[t]));
+		}
+
+		formatChunk(wave, chunks[0]);
+
+		for(auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		for(unsigned int t = 0; t < wave_size; t++)
+		{
+			out.write(chunks[t].data(), chunks[t].size());
+		}
+	}
+}
+
+} //namespace lblmc
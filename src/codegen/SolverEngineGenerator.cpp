@@ -25,6 +25,10 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include <stdexcept>
 #include <sstream>
 #include <fstream>
+#include <cctype>
+#include <cmath>
+#include <algorithm>
+#include <unordered_set>
 
 #include "codegen/ArrayObject.hpp"
 
@@ -39,6 +43,7 @@ SolverEngineGenerator::SolverEngineGenerator
 	model_name(model_name),
 	num_solutions(num_solutions),
 	comp_parameters(),
+	comp_source_parameters(),
 	comp_fields(),
 	comp_inputs(),
 	comp_outputs(),
@@ -46,7 +51,35 @@ SolverEngineGenerator::SolverEngineGenerator
 	comp_update_bodies(),
 	conductance_matrix_gen(num_solutions),
 	source_vector_gen(num_solutions),
-	parameters()
+	parameters(),
+	probed_solutions()
+{
+	if(model_name == "")
+		throw std::runtime_error("SimulationEngineGenerator::constructor(): model_name cannot be null or empty");
+
+	if(num_solutions == 0)
+		throw std::runtime_error("SimulationEngineGenerator::constructor(): num_solutions must be positive nonzero value");
+}
+
+SolverEngineGenerator::SolverEngineGenerator
+(
+	std::string model_name,
+	unsigned int num_solutions,
+	const SolverEngineGeneratorParameters& parameters
+) :
+	model_name(model_name),
+	num_solutions(num_solutions),
+	comp_parameters(),
+	comp_source_parameters(),
+	comp_fields(),
+	comp_inputs(),
+	comp_outputs(),
+	comp_outputs_update_bodies(),
+	comp_update_bodies(),
+	conductance_matrix_gen(num_solutions, parameters.solve_sparse_assembly_enable),
+	source_vector_gen(num_solutions),
+	parameters(parameters),
+	probed_solutions()
 {
 	if(model_name == "")
 		throw std::runtime_error("SimulationEngineGenerator::constructor(): model_name cannot be null or empty");
@@ -59,6 +92,7 @@ SolverEngineGenerator::SolverEngineGenerator(const SolverEngineGenerator& base)
 	model_name(base.model_name),
 	num_solutions(base.num_solutions),
 	comp_parameters(base.comp_parameters),
+	comp_source_parameters(base.comp_source_parameters),
 	comp_fields(base.comp_fields),
 	comp_inputs(base.comp_inputs),
 	comp_outputs(base.comp_outputs),
@@ -66,7 +100,8 @@ SolverEngineGenerator::SolverEngineGenerator(const SolverEngineGenerator& base)
 	comp_update_bodies(base.comp_update_bodies),
 	conductance_matrix_gen(base.conductance_matrix_gen),
 	source_vector_gen(base.source_vector_gen),
-	parameters(base.parameters)
+	parameters(base.parameters),
+	probed_solutions(base.probed_solutions)
 {}
 
 void SolverEngineGenerator::reset(std::string model_name, unsigned int num_solutions)
@@ -80,13 +115,15 @@ void SolverEngineGenerator::reset(std::string model_name, unsigned int num_solut
 	this->model_name = model_name;
 	this->num_solutions = num_solutions;
 	this->comp_parameters.clear();
+	this->comp_source_parameters.clear();
 	this->comp_fields.clear();
 	this->comp_inputs.clear();
 	this->comp_outputs.clear();
 	this->comp_outputs_update_bodies.clear();
 	this->comp_update_bodies.clear();
-	this->conductance_matrix_gen = SystemConductanceGenerator(num_solutions);
+	this->conductance_matrix_gen = SystemConductanceGenerator(num_solutions, parameters.solve_sparse_assembly_enable);
 	this->source_vector_gen = SystemSourceVectorGenerator(num_solutions);
+	this->probed_solutions.clear();
 }
 
 void SolverEngineGenerator::setModelName(std::string model_name)
@@ -102,352 +139,2137 @@ std::string SolverEngineGenerator::getModelName() const
 	return model_name;
 }
 
-SystemConductanceGenerator&  SolverEngineGenerator::getConductanceGenerator()
+void SolverEngineGenerator::setProbedSolutions(const std::vector<unsigned int>& probes)
 {
-	return conductance_matrix_gen;
-}
+	for(auto i : probes)
+	{
+		if(i == 0 || i > num_solutions)
+			throw std::out_of_range("SolverEngineGenerator::setProbedSolutions(): probed solution index is out of range of solutions");
+	}
 
-SystemSourceVectorGenerator& SolverEngineGenerator::getSourceVectorGenerator()
-{
-	return source_vector_gen;
+	probed_solutions = probes;
 }
 
-void SolverEngineGenerator::insertComponentParametersCode(std::string& code)
+bool SolverEngineGenerator::markSolutionReferences(const std::string& code, std::vector<bool>& referenced)
 {
-	if(code.empty()) return;
-	comp_parameters.push_back(code);
-}
+	const std::size_t len = code.size();
 
-void SolverEngineGenerator::insertComponentFieldsCode(std::string& code)
-{
-	if(code.empty()) return;
-	comp_fields.push_back(code);
-}
+	auto is_word = [](char c) { return std::isalnum((unsigned char)c) || c == '_'; };
 
-void SolverEngineGenerator::insertComponentInputsCode(std::string& code)
-{
-	if(code.empty()) return;
-	comp_inputs.push_back(code);
-}
+	for(std::size_t i = 0; i < len; i++)
+	{
+			//skip comments and literals
 
-void SolverEngineGenerator::insertComponentOutputsCode(std::string& code)
-{
-	if(code.empty()) return;
-	comp_outputs.push_back(code);
-}
+		if(code.compare(i, 2, "//") == 0)
+		{
+			i = code.find('\n', i);
+			if(i == std::string::npos) break;
+			continue;
+		}
 
-void SolverEngineGenerator::insertComponentOutputsUpdateBody(std::string& code)
-{
-	if(code.empty()) return;
-	comp_outputs_update_bodies.push_back(code);
-}
+		if(code.compare(i, 2, "/*") == 0)
+		{
+			i = code.find("*/", i+2);
+			if(i == std::string::npos) break;
+			i++;
+			continue;
+		}
 
-void SolverEngineGenerator::insertComponentUpdateBody(std::string& code)
-{
-	if(code.empty()) return;
-	comp_update_bodies.push_back(code);
-}
+		if(code[i] == '"' || code[i] == '\'')
+		{
+			const char quote = code[i];
+			for(i++; i < len && code[i] != quote; i++)
+			{
+				if(code[i] == '\\') i++;
+			}
+			continue;
+		}
 
-std::string SolverEngineGenerator::generateCFunctionParameterList() const
-{
-	std::stringstream sstrm;
+		if(is_word(code[i]))
+		{
+			std::size_t end = i;
+			while(end < len && is_word(code[end])) end++;
 
-	lblmc::ArrayObject x_out("real", "x_out", "", {num_solutions});
-	sstrm << x_out.generateArgument();
+			const bool member = (i > 0 && code[i-1] == '.') || (i > 1 && code.compare(i-2, 2, "->") == 0);
 
-	if( parameters.io_signal_output_enable && !comp_outputs.empty())
-	{
-		sstrm << ",\n";
+			if(end == i+1 && code[i] == 'x' && !member)
+			{
+					//expect x[<constant index>]
 
-		auto iter = comp_outputs.begin();
+				std::size_t j = end;
+				while(j < len && std::isspace((unsigned char)code[j])) j++;
+				if(j >= len || code[j] != '[') return false;
 
-		sstrm << *iter;
+				j++;
+				while(j < len && std::isspace((unsigned char)code[j])) j++;
 
-		for(iter = iter+1; iter != comp_outputs.end(); iter++)
-		{
-            sstrm << ",\n"
-                  << *iter;
+				std::size_t digits = j;
+				while(j < len && std::isdigit((unsigned char)code[j])) j++;
+				if(j == digits) return false;
+
+				const unsigned long index = std::stoul(code.substr(digits, j-digits));
+
+				while(j < len && std::isspace((unsigned char)code[j])) j++;
+				if(j >= len || code[j] != ']') return false;
+
+				if(index < referenced.size()) referenced[index] = true;
+			}
+
+			i = end-1;
 		}
 	}
 
-	if(!comp_inputs.empty())
-	{
-		sstrm << ",\n";
+	return true;
+}
 
-		auto iter = comp_inputs.begin();
+std::vector<bool> SolverEngineGenerator::findObservedSolutions() const
+{
+	std::vector<bool> observed(num_solutions+1, false);
+	bool resolved = true;
 
-		sstrm << *iter;
+	for(const auto& body : comp_update_bodies)
+	{
+		resolved = resolved && markSolutionReferences(body, observed);
+	}
 
-		for(iter = iter+1; iter != comp_inputs.end(); iter++)
+	if(parameters.io_signal_output_enable)
+	{
+		for(const auto& body : comp_outputs_update_bodies)
 		{
-            sstrm << ",\n"
-                  << *iter;
+			resolved = resolved && markSolutionReferences(body, observed);
 		}
 	}
 
-	if(parameters.io_source_vector_output_enable == true)
+	if(!resolved)
 	{
-		sstrm << ",\n";
-
-		lblmc::ArrayObject b_out("real", "b_out", "", {num_solutions});
-		sstrm << b_out.generateArgument();
-
+		return std::vector<bool>(num_solutions+1, true);
 	}
 
-	if(parameters.io_component_sources_output_enable == true)
+	for(auto i : probed_solutions)
 	{
-		sstrm << ",\n";
+		observed[i] = true;
+	}
 
-		lblmc::ArrayObject src_out("real", "sources_out", "", {source_vector_gen.getNumSources()});
-		sstrm << src_out.generateArgument();
+		//switch-state bank solve reads solutions at switched conductances to correct unbanked states
+
+	for(const auto& sw : conductance_matrix_gen.getSwitchedConductances())
+	{
+		observed[sw.p] = true;
+		observed[sw.n] = true;
 	}
 
-	return sstrm.str();
+	observed[0] = true;
+
+	return observed;
 }
 
-std::string SolverEngineGenerator::generateCInlineCode(double zero_bound) const
+std::vector<bool> SolverEngineGenerator::findSolvedSolutions() const
 {
-	std::stringstream sstrm;
-
-	SystemConductanceGenerator invg_gen(conductance_matrix_gen);
-	invg_gen.invertSelf();
-	const double * invg = invg_gen.asArray();
+	if(!parameters.solve_dead_solution_elimination_enable) return std::vector<bool>();
 
-	unsigned int num_components = source_vector_gen.getNumSources();
+	return findObservedSolutions();
+}
 
-	SystemSolverGenerator solver_gen(invg, num_solutions, num_components, zero_bound);
+std::vector<unsigned int> SolverEngineGenerator::reduceSystem(SystemConductanceGenerator& cond_gen, SystemSourceVectorGenerator& src_gen) const
+{
+	const std::vector<bool> observed = findObservedSolutions();
+	const MatrixRMXd incidence = src_gen.asIncidenceMatrix();
 
-	std::string buf;
+	std::vector<bool> eliminated(num_solutions+1, false);
 
-	//codegen xilinx HLS features
-	if(parameters.xilinx_hls_enable)
+	for(unsigned int i = 1; i <= num_solutions; i++)
 	{
-		sstrm << "//clock period=" << parameters.xilinx_hls_clock_period << "\n\n";
+		if(!observed[i] && (incidence.cols() == 0 || incidence.row(i-1).isZero(0.0))) eliminated[i] = true;
+	}
 
-		sstrm
-		<< "//#port_interface //set port interface (and partitioning) directives here\n\n";
+	std::vector<unsigned int> retained;
 
-		if(parameters.xilinx_hls_inline)
-		{
-			sstrm << "#pragma HLS inline\n\n";
-		}
+	try
+	{
+		retained = cond_gen.kronReduce(eliminated);
+	}
+	catch(const std::exception&)
+	{
+			//nothing can be eliminated, or the eliminated solutions cannot be solved on their own; keep full system
 
-		if(parameters.xilinx_hls_latency_enable)
+		retained.clear();
+
+		for(unsigned int i = 1; i <= num_solutions; i++)
 		{
-			sstrm << "#pragma HLS latency min="<<parameters.xilinx_hls_latency_min<<
-			         " max="<<parameters.xilinx_hls_latency_max<<"\n\n";
+			retained.push_back(i);
 		}
 
-		sstrm
-		<< "//#init_interval(cycles) //set pipeline initiation interval cycle directive(s) here\n\n";
-
+		return retained;
 	}
-	else
-	{
-		sstrm
-		<< "//#port_interface //set port interface (and partitioning) directives here\n\n"
 
-		<< "//#inline //set code inline directive(s) here\n\n"
+	src_gen.reduceSolutions(retained);
 
-		<< "//#latency(min_cycles,max_cycles) //set execution cycle latency directive(s) here\n\n"
+	return retained;
+}
 
-		<< "//#init_interval(cycles) //set pipeline initiation interval cycle directive(s) here\n\n"
-		;
+void SolverEngineGenerator::invertSolveMatrix
+(
+	SystemConductanceGenerator& invg_gen,
+	const SystemSourceVectorGenerator& src_gen,
+	const std::vector<bool>& solved,
+	const std::vector<unsigned int>& solution_indices
+) const
+{
+	if(!parameters.inv_conduct_matrix_selected_enable)
+	{
+		invg_gen.invertSelf();
+		return;
 	}
 
-	sstrm << "//MODEL PARAMETERS\n\n";
+	const unsigned int dimension = invg_gen.getDimension();
+	const MatrixRMXd incidence = src_gen.asIncidenceMatrix();
 
-	for(auto i : comp_parameters)
+	std::vector<bool> rows(dimension, true);
+	std::vector<bool> cols(dimension, true);
+
+	for(unsigned int r = 0; r < dimension; r++)
 	{
-		sstrm << i << "\n";
+		const unsigned int index = solution_indices.empty() ? r+1 : solution_indices[r];
+
+		if(!solved.empty()) rows[r] = index < solved.size() && solved[index];
+
+		cols[r] = incidence.cols() != 0 && !incidence.row(r).isZero(0.0);
 	}
-	sstrm << "\n";
 
-	sstrm << "//COMPONENT FIELDS AND STATES\n\n";
+	invg_gen.invertSelectedSelf(rows, cols, parameters.inv_conduct_matrix_num_threads);
+}
+
+SystemSparsifier SolverEngineGenerator::sparsifySolveMatrix(const MatrixRMXd& M, const SystemSourceVectorGenerator& src_gen, bool fused, double zero_bound) const
+{
+	const MatrixRMXd incidence = src_gen.asIncidenceMatrix();
+	std::vector<double> input_magnitudes;
 
-	for(auto i : comp_fields)
+	if(fused)
 	{
-		sstrm << i << "\n";
+		input_magnitudes.assign(incidence.cols(), parameters.sparsify_source_magnitude);
+	}
+	else
+	{
+			//each element of b is bounded by the sum of the magnitudes of its contributing sources
+
+		for(unsigned int i = 0; i < incidence.rows(); i++)
+		{
+			input_magnitudes.push_back(incidence.row(i).cwiseAbs().sum() * parameters.sparsify_source_magnitude);
+		}
 	}
-	sstrm << "\n";
 
-	sstrm << "//MODEL SOLUTIONS\n\n";
+	SystemSparsifier sparsifier(M, input_magnitudes, zero_bound);
+	sparsifier.sparsify(parameters.sparsify_error_budget, parameters.sparsify_relative_enable);
 
-	sstrm
-	<< "static real b["<<num_solutions<<"];\n"
-	<< "static real x["<<num_solutions+1<<"];\n"
-	<< "real b_components["<<num_components<<"];\n\n";
+	return sparsifier;
+}
+
+std::string SolverEngineGenerator::generateSparsificationReport(double zero_bound) const
+{
+	const bool fused_enable = parameters.solve_fused_source_gain_enable;
 
-	sstrm << "//INVERTED CONDUCTANCE MATRIX\n\n";
+	if(parameters.sparsify_error_budget <= 0.0 || (parameters.solve_sparse_lu_enable && !fused_enable))
+		return std::string();
 
-	buf = invg_gen.asCLiteral("inv_g");
-	sstrm << buf << "\n\n";
+	if(conductance_matrix_gen.getNumberOfSwitches() > 0)
+		return std::string();
 
-	sstrm << "//COMPONENT SOURCE CONTRIBUTION UPDATES\n\n";
+	SystemConductanceGenerator cond_gen(conductance_matrix_gen);
+	SystemSourceVectorGenerator src_gen(source_vector_gen);
 
-	for(auto i : comp_update_bodies)
+	if(parameters.solve_kron_reduction_enable)
 	{
-		sstrm << i << "\n";
+		reduceSystem(cond_gen, src_gen);
 	}
-	sstrm << "\n";
 
-	if(parameters.io_signal_output_enable)
-	{
-		sstrm << "//MODEL OUTPUT SIGNAL UPDATES\n\n";
+	cond_gen.invertSelf();
 
-		for(auto i : comp_outputs_update_bodies)
-		{
-			sstrm << i << "\n";
-		}
-		sstrm << "\n";
+	if(fused_enable)
+	{
+		MatrixRMXd src_gain = cond_gen.asEigen3Matrix() * src_gen.asIncidenceMatrix();
+		return sparsifySolveMatrix(src_gain, src_gen, true, zero_bound).generateReport();
 	}
 
-	sstrm << "//AGGREGRATE COMPONENT SOURCE CONTRIBUTIONS\n\n";
+	return sparsifySolveMatrix(cond_gen.asEigen3Matrix(), src_gen, false, zero_bound).generateReport();
+}
 
-	source_vector_gen.asCInlineCode(buf);
-	sstrm << buf << "\n\n";
+double SolverEngineGenerator::findSolveMatrixDivider() const
+{
+	if(!parameters.inv_conduct_matrix_rescale_enable) return 1.0;
 
-	sstrm << "//MODEL UPDATE SOLUTIONS\n\n";
+	const unsigned int divider = parameters.inv_conduct_matrix_divider;
 
-	solver_gen.generateCInlineCode(buf, "inv_g");
-	sstrm << buf << "\n\n";
+	if(divider == 0 || (divider & (divider-1)) != 0)
+		throw std::invalid_argument("SolverEngineGenerator::findSolveMatrixDivider(): inv_conduct_matrix_divider must be a power of 2");
 
-	return sstrm.str();
+	return (double)divider;
 }
 
-std::string SolverEngineGenerator::generateCFunction(double zero_bound) const
+bool SolverEngineGenerator::isBatchEnabled() const
 {
-	std::stringstream sstrm;
+	return parameters.codegen_batch_width > 1;
+}
 
-	if(parameters.codegen_solver_templated_function_enable == true)
-	{
-        sstrm
-        << "template< int instance";
+bool SolverEngineGenerator::isSIMDSolveEnabled() const
+{
+		//batched solvers vectorize across instances instead
 
-        if(parameters.codegen_solver_templated_real_type_enable == true)
-		{
-			sstrm
-			<< ", typename real";
-		}
+	return parameters.solve_simd_enable && !isBatchEnabled();
+}
 
-		sstrm
-		<< " >\n";
-	}
+bool SolverEngineGenerator::isTableSolveEnabled(unsigned long num_macs) const
+{
+		//loops suit CPU targets; adder trees and fixed point types keep the rounding of their unrolled sums
 
-	sstrm
-	<< "void "<<model_name<<"_solver\n"
-	<< "(\n";
+	return parameters.solve_table_mac_threshold > 0 && num_macs >= parameters.solve_table_mac_threshold &&
+		!parameters.xilinx_hls_enable && !parameters.fixed_point_enable && parameters.solve_adder_tree_fan_in < 2 &&
+		!isBatchEnabled();
+}
 
-	sstrm
-	<< generateCFunctionParameterList()
-	<< "\n)\n"
-	<< "{\n";
+bool SolverEngineGenerator::isBinaryMatrixEnabled() const
+{
+		//synthesis needs the matrix as a literal to map it into ROM
 
-	std::string buf;
-	buf = generateCInlineCode(zero_bound);
-	sstrm << buf;
+	return parameters.codegen_binary_matrix_enable && !parameters.xilinx_hls_enable;
+}
 
-	if(parameters.io_source_vector_output_enable == true)
-	{
-		for(unsigned int i = 0; i < num_solutions; i++)
-		{
-			sstrm << "b_out["<<i<<"] = b["<<i<<"];\n";
-		}
-	}
+void SolverEngineGenerator::generateBinaryMatrixCode(std::ostream& out, std::string M_name, const std::vector<unsigned long>& dimensions,
+	const double* M, std::string prefix) const
+{
+	const std::string filename = model_name + "_" + M_name + ".bin";
 
-	sstrm << "\n";
+	std::string directory = parameters.codegen_binary_matrix_directory;
 
-	if(parameters.io_component_sources_output_enable == true)
-	{
-		for(unsigned int i = 0; i < source_vector_gen.getNumSources(); i++)
-		{
-			sstrm << "sources_out["<<i<<"] = b_components["<<i<<"];\n";
-		}
-	}
+	if(!directory.empty() && directory.back() != '/') directory += "/";
 
-	sstrm << "\n";
+	unsigned long count = 1;
 
-	for(unsigned int i = 0; i < num_solutions; i++)
+	for(auto d : dimensions)
 	{
-		sstrm << "x_out["<<i<<"] = x["<<i+1<<"];\n";
+		count *= d;
 	}
 
-	sstrm
-	<< "\n}";
+	SystemBinaryMatrixGenerator::exportBinary(directory + filename, M, count);
 
-	return sstrm.str();
+	out << SystemBinaryMatrixGenerator::generateLoadCode(M_name, dimensions, filename, getSignalTypeName(SystemWordLengthAnalyzer::COEFFICIENT), prefix);
 }
 
-void SolverEngineGenerator::generateCFunctionAndExport(std::string filename, double zero_bound) const
+bool SolverEngineGenerator::isStateStructEnabled() const
 {
-	if(filename == "")
-		throw std::invalid_argument("SimulationEngineGenerator::generateCFunctionAndExport(): filename cannot be null or empty");
+	return parameters.codegen_state_struct_enable;
+}
 
-	std::fstream file;
+bool SolverEngineGenerator::isSplitEnabled() const
+{
+		//synthesis tools take the solver as one function
 
-	std::string fname = filename;
+	return parameters.codegen_split_function_size > 0 && !parameters.xilinx_hls_enable;
+}
 
-	try
+bool SolverEngineGenerator::isMultiStepEnabled() const
+{
+	return parameters.codegen_multi_step_count > 0;
+}
+
+bool SolverEngineGenerator::isWordLengthAnalysisEnabled() const
+{
+	return parameters.fixed_point_enable && parameters.fixed_point_word_length_analysis_enable &&
+		!( parameters.codegen_solver_templated_real_type_enable && parameters.codegen_solver_templated_function_enable );
+}
+
+SystemWordLengthAnalyzer SolverEngineGenerator::analyzeWordLengths(double zero_bound) const
+{
+	const bool switch_bank_enable = conductance_matrix_gen.getNumberOfSwitches() > 0;
+	const bool fused_enable = parameters.solve_fused_source_gain_enable && !switch_bank_enable;
+	const bool lu_enable = parameters.solve_sparse_lu_enable && !fused_enable && !switch_bank_enable;
+
+	SystemConductanceGenerator cond_gen(conductance_matrix_gen);
+	SystemSourceVectorGenerator src_gen(source_vector_gen);
+
+	if(parameters.solve_kron_reduction_enable)
 	{
-		file.open(fname.c_str(), std::fstream::out | std::fstream::trunc);
+		reduceSystem(cond_gen, src_gen);
 	}
-	catch(...)
+
+	const MatrixRMXd incidence = src_gen.asIncidenceMatrix();
+
+		//each component source is bounded by the expected source magnitude, or by the literal source parameters
+		//of the netlist where larger, and each element of b by the sum of the bounds of its contributing sources
+
+	double literal_source_magnitude = 0.0;
+
+	for(const auto& code : comp_parameters)
 	{
-		throw std::runtime_error("SimulationEngineGenerator::generateCFunctionAndExport(): failed to open or create source files");
+		literal_source_magnitude = std::max(literal_source_magnitude,
+			SystemWordLengthAnalyzer::findParameterMagnitude(code, comp_source_parameters));
 	}
 
-	file <<
-			"/**\n"
-			" *\n"
+	const double component_source_magnitude = std::max(parameters.fixed_point_source_magnitude, literal_source_magnitude);
+
+	std::vector<double> input_magnitudes;
+	double source_magnitude = component_source_magnitude;
+
+	for(unsigned int i = 0; i < incidence.rows(); i++)
+	{
+		input_magnitudes.push_back(incidence.row(i).cwiseAbs().sum() * component_source_magnitude);
+		source_magnitude = std::max(source_magnitude, input_magnitudes.back());
+	}
+
+	MatrixRMXd M;
+	double coefficient_magnitude = -1.0;
+	double inline_coefficient_magnitude = 0.0;
+	double divider = 1.0;
+
+	if(switch_bank_enable)
+	{
+		SystemSwitchBankGenerator switch_bank_gen(cond_gen, parameters.switch_bank_memory_budget, zero_bound);
+
+		M = switch_bank_gen.getBankMagnitudes();
+		coefficient_magnitude = switch_bank_gen.getLargestCoefficientMagnitude();
+
+		if(!switch_bank_gen.isComplete()) inline_coefficient_magnitude = coefficient_magnitude;
+	}
+	else
+	{
+		if(lu_enable)
+		{
+			SystemLUSolverGenerator lu_solver_gen(cond_gen.asSparseMatrix(), zero_bound);
+
+			coefficient_magnitude = 0.0;
+			inline_coefficient_magnitude = lu_solver_gen.getLargestCoefficientMagnitude();
+		}
+		else
+		{
+			divider = findSolveMatrixDivider();
+		}
+
+		cond_gen.invertSelf();
+		M = cond_gen.asEigen3Matrix();
+
+		if(fused_enable)
+		{
+			M = M * incidence;
+			input_magnitudes.assign(incidence.cols(), component_source_magnitude);
+		}
+	}
+
+	SystemWordLengthAnalyzer analyzer(M, input_magnitudes, zero_bound);
+
+	for(const auto& code : comp_parameters)
+	{
+		analyzer.insertParameters(code);
+	}
+
+	analyzer.setCoefficientMagnitude(coefficient_magnitude);
+	analyzer.setCoefficientDivider(divider);
+	analyzer.setInlineCoefficientMagnitude(inline_coefficient_magnitude);
+	analyzer.setSourceMagnitude(source_magnitude);
+	analyzer.setStateMagnitude(parameters.fixed_point_state_magnitude);
+	analyzer.analyze(parameters.fixed_point_resolution, parameters.fixed_point_word_width);
+
+		//a literal source beyond the range of the source format would wrap silently in the generated solver
+
+	const SystemWordLengthAnalyzer::Format& src_format = analyzer.getFormat(SystemWordLengthAnalyzer::SOURCE);
+
+	if(literal_source_magnitude >= std::ldexp(1.0, (int)src_format.int_width - 1))
+	{
+		std::stringstream sstrm;
+		sstrm << "SolverEngineGenerator::analyzeWordLengths(): literal source parameter of magnitude " << literal_source_magnitude
+		<< " exceeds the range of " << SystemWordLengthAnalyzer::getTypeName(SystemWordLengthAnalyzer::SOURCE);
+
+		throw std::runtime_error(sstrm.str());
+	}
+
+	return analyzer;
+}
+
+std::string SolverEngineGenerator::generateWordLengthReport(double zero_bound) const
+{
+	if(!isWordLengthAnalysisEnabled()) return std::string();
+
+	return analyzeWordLengths(zero_bound).generateReport();
+}
+
+std::string SolverEngineGenerator::getSignalTypeName(SystemWordLengthAnalyzer::SignalClass signal_class) const
+{
+	if(!isWordLengthAnalysisEnabled()) return "real";
+
+	return SystemWordLengthAnalyzer::getTypeName(signal_class);
+}
+
+std::string SolverEngineGenerator::generateParameterCode(const std::string& code) const
+{
+	if(!isWordLengthAnalysisEnabled()) return code;
+
+	return SystemWordLengthAnalyzer::generateParameterCode(code);
+}
+
+std::string SolverEngineGenerator::generateRealTypeCode(double zero_bound) const
+{
+	if( parameters.codegen_solver_templated_real_type_enable == true &&
+		parameters.codegen_solver_templated_function_enable == true )
+	{
+		return std::string();
+	}
+
+	std::stringstream sstrm;
+
+	if(!parameters.fixed_point_enable)
+	{
+		sstrm << "typedef double real;\n\n";
+	}
+	else
+	{
+			//ap_fixed in HLS, otherwise its bit-accurate emulation lblmc_fixed, both rounding to nearest
+
+		const std::string fixed_template = parameters.xilinx_hls_enable ? "ap_fixed" : "lblmc_fixed";
+		const std::string mode_prefix = parameters.xilinx_hls_enable ? "AP_" : "LBLMC_";
+
+		std::string modes = ", " + mode_prefix + "RND";
+		if(parameters.fixed_point_saturation_enable) modes += ", " + mode_prefix + "SAT";
+
+		if(parameters.xilinx_hls_enable)
+			sstrm << "#include <ap_fixed.h>\n";
+		else
+			sstrm << "#include \"lblmc_fixed.hpp\"\n";
+
+		if(parameters.fixed_point_word_length_analysis_enable)
+		{
+			sstrm << analyzeWordLengths(zero_bound).generateCTypedefs(fixed_template, modes) << "\n";
+		}
+		else
+		{
+			sstrm << "typedef " << fixed_template << "<"<<parameters.fixed_point_word_width<<", "<<
+			parameters.fixed_point_int_width<<modes<<"> real;\n\n";
+		}
+	}
+
+	return sstrm.str();
+}
+
+std::string SolverEngineGenerator::generateSolutionRescaleCode(unsigned int dimension, const std::vector<bool>& solved,
+	const std::vector<unsigned int>& solution_indices, double divider) const
+{
+	std::stringstream sstrm;
+
+		//multiplying by a power of 2 is exact, and a shift in fixed point hardware
+
+	const std::string sol_type = getSignalTypeName(SystemWordLengthAnalyzer::SOLUTION);
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		const unsigned int i = solution_indices.empty() ? r+1 : solution_indices[r];
+
+		if(!solved.empty() && !solved[i]) continue;
+
+		sstrm << "x[" << i << "] = x[" << i << "]*" << sol_type << "(" << (unsigned long)divider << ");\n";
+	}
+
+	return sstrm.str();
+}
+
+std::vector<unsigned int> SolverEngineGenerator::findRetainedSolutions() const
+{
+	if(parameters.solve_kron_reduction_enable)
+	{
+		SystemConductanceGenerator cond_gen(conductance_matrix_gen);
+		SystemSourceVectorGenerator src_gen(source_vector_gen);
+
+		return reduceSystem(cond_gen, src_gen);
+	}
+
+	std::vector<unsigned int> retained;
+
+	for(unsigned int i = 1; i <= num_solutions; i++)
+	{
+		retained.push_back(i);
+	}
+
+	return retained;
+}
+
+unsigned int SolverEngineGenerator::getNumberOfKronReducibleSolutions() const
+{
+	SystemConductanceGenerator cond_gen(conductance_matrix_gen);
+	SystemSourceVectorGenerator src_gen(source_vector_gen);
+
+	return num_solutions - reduceSystem(cond_gen, src_gen).size();
+}
+
+SystemConductanceGenerator&  SolverEngineGenerator::getConductanceGenerator()
+{
+	return conductance_matrix_gen;
+}
+
+SystemSourceVectorGenerator& SolverEngineGenerator::getSourceVectorGenerator()
+{
+	return source_vector_gen;
+}
+
+void SolverEngineGenerator::insertComponentParametersCode(std::string& code)
+{
+	if(code.empty()) return;
+	comp_parameters.push_back(code);
+}
+
+void SolverEngineGenerator::insertComponentSourceParameters(const std::vector<std::string>& names)
+{
+	comp_source_parameters.insert(comp_source_parameters.end(), names.begin(), names.end());
+}
+
+void SolverEngineGenerator::insertComponentFieldsCode(std::string& code)
+{
+	if(code.empty()) return;
+	comp_fields.push_back(code);
+}
+
+void SolverEngineGenerator::insertComponentInputsCode(std::string& code)
+{
+	if(code.empty()) return;
+	comp_inputs.push_back(code);
+}
+
+void SolverEngineGenerator::insertComponentOutputsCode(std::string& code)
+{
+	if(code.empty()) return;
+	comp_outputs.push_back(code);
+}
+
+void SolverEngineGenerator::insertComponentOutputsUpdateBody(std::string& code)
+{
+	if(code.empty()) return;
+	comp_outputs_update_bodies.push_back(code);
+}
+
+void SolverEngineGenerator::insertComponentUpdateBody(std::string& code)
+{
+	if(code.empty()) return;
+	comp_update_bodies.push_back(code);
+}
+
+std::string SolverEngineGenerator::generateCFunctionParameterList() const
+{
+	std::stringstream sstrm;
+
+	lblmc::ArrayObject x_out("real", "x_out", "", {num_solutions});
+	sstrm << x_out.generateArgument();
+
+	if( parameters.io_signal_output_enable && !comp_outputs.empty())
+	{
+		sstrm << ",\n";
+
+		auto iter = comp_outputs.begin();
+
+		sstrm << *iter;
+
+		for(iter = iter+1; iter != comp_outputs.end(); iter++)
+		{
+            sstrm << ",\n"
+                  << *iter;
+		}
+	}
+
+	if(!comp_inputs.empty())
+	{
+		sstrm << ",\n";
+
+		auto iter = comp_inputs.begin();
+
+		sstrm << *iter;
+
+		for(iter = iter+1; iter != comp_inputs.end(); iter++)
+		{
+            sstrm << ",\n"
+                  << *iter;
+		}
+	}
+
+	if(parameters.io_source_vector_output_enable == true)
+	{
+		sstrm << ",\n";
+
+		lblmc::ArrayObject b_out("real", "b_out", "", {num_solutions});
+		sstrm << b_out.generateArgument();
+
+	}
+
+	if(parameters.io_component_sources_output_enable == true)
+	{
+		sstrm << ",\n";
+
+		lblmc::ArrayObject src_out("real", "sources_out", "", {source_vector_gen.getNumSources()});
+		sstrm << src_out.generateArgument();
+	}
+
+	return sstrm.str();
+}
+
+std::string SolverEngineGenerator::generateSolveStrategyReport(double zero_bound) const
+{
+	std::stringstream sstrm;
+
+	if(conductance_matrix_gen.getNumberOfSwitches() > 0)
+	{
+		SystemSwitchBankGenerator switch_bank_gen(conductance_matrix_gen, parameters.switch_bank_memory_budget, zero_bound);
+
+		sstrm
+		<< "solve strategies of model " << model_name << " (" << num_solutions << " solutions):\n"
+		<< "  switched conductances are solved with the switch-state inverse bank only\n"
+		<< switch_bank_gen.generateReport();
+
+		return sstrm.str();
+	}
+
+	const MatrixRMXd& invg = conductance_matrix_gen.getInverse();
+
+	SystemSolverGenerator solver_gen(invg.data(), num_solutions, source_vector_gen.getNumSources(), zero_bound);
+	SystemLUSolverGenerator lu_solver_gen(conductance_matrix_gen.asSparseMatrix(), zero_bound);
+	MatrixRMXd src_gain = invg * source_vector_gen.asIncidenceMatrix();
+	SystemSIMDSolverGenerator simd_solver_gen(invg.data(), num_solutions, num_solutions, zero_bound);
+	SystemTableSolverGenerator table_gen(invg.data(), num_solutions, num_solutions, zero_bound);
+
+	sstrm
+	<< "solve strategies of model " << model_name << " (" << num_solutions << " solutions):\n"
+	<< "  dense inverse x=(G^-1)*b:      " << solver_gen.getNumberOfMultiplyAccumulates() << " MACs per step\n"
+	<< "  sparse LU substitution:        " << lu_solver_gen.getNumberOfMultiplyAccumulates() << " MACs per step"
+	<< " (nnz L=" << lu_solver_gen.getNumberOfLowerNonzeros()
+	<< ", nnz U=" << lu_solver_gen.getNumberOfUpperNonzeros() << ")\n"
+	<< "  fused source gain x=K*b_comp:  " << solver_gen.getNumberOfSourceGainMultiplyAccumulates(src_gain.data()) << " MACs per step"
+	<< " (no source aggregation stage)\n"
+	<< "  SIMD dense inverse x=(G^-1)*b: " << (unsigned long)simd_solver_gen.getPaddedRows()*num_solutions << " MACs per step"
+	<< " (" << simd_solver_gen.getNumberOfPanels() << " panels of " << SystemSIMDSolverGenerator::PANEL_HEIGHT
+	<< " rows, no zero pruning)\n"
+	<< "  table-driven x=(G^-1)*b:       " << table_gen.getNumberOfNonzeros() << " MACs per step"
+	<< " (" << (table_gen.getFormat() == SystemTableSolverGenerator::ELL ? "ELL" : "CSR") << " tables, rows of up to "
+	<< table_gen.getLongestRowLength() << " elements; ";
+
+	if(parameters.solve_table_mac_threshold > 0)
+		sstrm << "solves of " << parameters.solve_table_mac_threshold << " or more MACs loop over tables)\n";
+	else
+		sstrm << "solves are always unrolled)\n";
+
+	std::vector<bool> observed = findObservedSolutions();
+	unsigned int num_unobserved = 0;
+
+	for(unsigned int i = 1; i <= num_solutions; i++)
+	{
+		if(!observed[i]) num_unobserved++;
+	}
+
+	sstrm
+	<< "  unobserved solutions:          " << num_unobserved << " of " << num_solutions
+	<< " (removable by dead solution elimination)\n";
+
+	sstrm
+	<< "  Kron reducible solutions:      " << getNumberOfKronReducibleSolutions() << " of " << num_solutions
+	<< " (unobserved without sources)\n";
+
+	sstrm << generateSparsificationReport(zero_bound);
+
+	return sstrm.str();
+}
+
+std::string SolverEngineGenerator::generateDirectiveCode(const std::string& parameter_list, unsigned int steps) const
+{
+	std::stringstream sstrm;
+
+	//codegen xilinx HLS features
+	if(parameters.xilinx_hls_enable)
+	{
+		const SystemDirectiveGenerator directive_gen(parameters.xilinx_hls_init_interval);
+
+		sstrm << "//clock period=" << parameters.xilinx_hls_clock_period << "\n\n";
+
+			//an inlined solver has no ports nor pipeline of its own, as it takes those of the function it is inlined into
+
+		if(parameters.xilinx_hls_inline)
+		{
+			sstrm << "#pragma HLS inline\n\n";
+		}
+		else
+		{
+			sstrm << directive_gen.generateInterfaceCode(parameter_list, steps) << "\n";
+		}
+
+		if(parameters.xilinx_hls_latency_enable)
+		{
+			sstrm << "#pragma HLS latency min="<<parameters.xilinx_hls_latency_min<<
+			         " max="<<parameters.xilinx_hls_latency_max<<"\n\n";
+		}
+
+		if(steps <= 1 && directive_gen.getInitInterval() > 0 && !parameters.xilinx_hls_inline)
+		{
+			sstrm << directive_gen.generatePipelineCode() << "\n";
+		}
+	}
+	else
+	{
+		sstrm
+		<< "//#port_interface //set port interface (and partitioning) directives here\n\n"
+
+		<< "//#inline //set code inline directive(s) here\n\n"
+
+		<< "//#latency(min_cycles,max_cycles) //set execution cycle latency directive(s) here\n\n"
+
+		<< "//#init_interval(cycles) //set pipeline initiation interval cycle directive(s) here\n\n"
+		;
+	}
+
+	return sstrm.str();
+}
+
+std::string SolverEngineGenerator::generateSolveDirectiveCode(const std::string& matrix_name, const std::vector<unsigned long>& matrix_dimensions,
+	unsigned long num_macs, bool fused_enable, unsigned int dimension, unsigned int num_components, bool vectors_enable) const
+{
+	const SystemDirectiveGenerator directive_gen(parameters.xilinx_hls_init_interval);
+
+	if(!parameters.xilinx_hls_enable || directive_gen.getInitInterval() == 0) return "";
+
+	std::stringstream sstrm;
+
+	sstrm << "//SOLVE ARRAY PARTITIONS FOR INITIATION INTERVAL " << directive_gen.getInitInterval() << "\n\n";
+
+	if(!matrix_name.empty() && num_macs > 0)
+	{
+		sstrm << directive_gen.generateArrayPartitionCode(matrix_name, matrix_dimensions, num_macs);
+	}
+
+	sstrm << directive_gen.generateArrayPartitionCode("b", {dimension}, 2ul*dimension + (fused_enable ? 0 : num_macs));
+
+	if(vectors_enable)
+	{
+		sstrm << directive_gen.generateArrayPartitionCode("x", {num_solutions+1ul}, 2ul*(num_solutions+1));
+
+		if(num_components > 0)
+			sstrm << directive_gen.generateArrayPartitionCode("b_components", {num_components}, 2ul*num_components + (fused_enable ? num_macs : 0));
+	}
+
+	sstrm << "\n";
+
+	return sstrm.str();
+}
+
+SolverEngineGenerator::SolveCode SolverEngineGenerator::generateSolveCode(double zero_bound) const
+{
+	std::stringstream sstrm;
+	SolveCode code;
+
+	const bool switch_bank_enable = conductance_matrix_gen.getNumberOfSwitches() > 0;
+	const bool fused_enable = parameters.solve_fused_source_gain_enable && !switch_bank_enable;
+	const bool lu_enable = parameters.solve_sparse_lu_enable && !fused_enable && !switch_bank_enable;
+
+	const std::vector<bool> solved = findSolvedSolutions();
+
+		//conductance matrix and source vector of the system actually solved, Kron reduced if enabled
+
+	SystemConductanceGenerator cond_gen(conductance_matrix_gen);
+	SystemSourceVectorGenerator src_gen(source_vector_gen);
+	std::vector<unsigned int> solution_indices;
+
+	if(parameters.solve_kron_reduction_enable)
+	{
+		solution_indices = reduceSystem(cond_gen, src_gen);
+	}
+
+	const unsigned int dimension = cond_gen.getDimension();
+
+	SystemConductanceGenerator invg_gen(cond_gen);
+	SystemLUSolverGenerator lu_solver_gen;
+	SystemSwitchBankGenerator switch_bank_gen;
+	MatrixRMXd src_gain;
+
+	if(switch_bank_enable)
+	{
+		switch_bank_gen.reset(cond_gen, parameters.switch_bank_memory_budget, zero_bound);
+		switch_bank_gen.setAdderTreeFanIn(parameters.solve_adder_tree_fan_in);
+		switch_bank_gen.setSolvedSolutions(solved);
+		switch_bank_gen.setSolutionIndices(solution_indices);
+	}
+	else if(lu_enable)
+	{
+		lu_solver_gen.reset(cond_gen.asSparseMatrix(), zero_bound);
+		lu_solver_gen.setAdderTreeFanIn(parameters.solve_adder_tree_fan_in);
+		lu_solver_gen.setSolvedSolutions(solved);
+		lu_solver_gen.setSolutionIndices(solution_indices);
+	}
+	else
+	{
+		invertSolveMatrix(invg_gen, src_gen, solved, solution_indices);
+	}
+
+	const bool sparsify_enable = parameters.sparsify_error_budget > 0.0 && !lu_enable && !switch_bank_enable;
+
+	if(sparsify_enable && !fused_enable)
+	{
+		invg_gen.asEigen3Matrix() = sparsifySolveMatrix(invg_gen.asEigen3Matrix(), src_gen, false, zero_bound).getMatrix();
+	}
+
+		//sparse LU solves from factors of G, which is not made dense here
+
+	const double * invg = lu_enable ? nullptr : invg_gen.asArray();
+
+	unsigned int num_components = src_gen.getNumSources();
+
+		//rescaled solve matrix discards the same elements as unscaled
+
+	const bool rescale_enable = parameters.inv_conduct_matrix_rescale_enable && !lu_enable && !switch_bank_enable;
+	const double divider = rescale_enable ? findSolveMatrixDivider() : 1.0;
+	const double solve_zero_bound = zero_bound/divider;
+
+	SystemSolverGenerator solver_gen(invg, dimension, num_components, solve_zero_bound);
+	solver_gen.setAdderTreeFanIn(parameters.solve_adder_tree_fan_in);
+	solver_gen.setSolvedSolutions(solved);
+	solver_gen.setSolutionIndices(solution_indices);
+
+	if(fused_enable)
+	{
+		src_gain = invg_gen.asEigen3Matrix() * src_gen.asIncidenceMatrix();
+
+		if(sparsify_enable)
+		{
+			src_gain = sparsifySolveMatrix(src_gain, src_gen, true, zero_bound).getMatrix();
+		}
+	}
+
+	if(rescale_enable)
+	{
+		invg_gen.asEigen3Matrix() /= divider;
+		src_gain /= divider;
+	}
+
+	const bool simd_enable = isSIMDSolveEnabled() && !lu_enable && !switch_bank_enable && !(fused_enable && num_components == 0);
+
+	SystemSIMDSolverGenerator simd_solver_gen;
+
+	if(simd_enable)
+	{
+		if(fused_enable)
+			simd_solver_gen.reset(src_gain.data(), dimension, num_components, solve_zero_bound);
+		else
+			simd_solver_gen.reset(invg, dimension, dimension, solve_zero_bound);
+
+		simd_solver_gen.setSolvedSolutions(solved);
+		simd_solver_gen.setSolutionIndices(solution_indices);
+	}
+
+		//large solves loop over compressed tables, instead of unrolling a statement per element
+
+	unsigned long num_macs = solver_gen.getNumberOfMultiplyAccumulates();
+
+	if(lu_enable)
+		num_macs = lu_solver_gen.getNumberOfMultiplyAccumulates();
+	else if(fused_enable)
+		num_macs = num_components > 0 ? solver_gen.getNumberOfSourceGainMultiplyAccumulates(src_gain.data()) : 0;
+
+	const bool table_enable = isTableSolveEnabled(num_macs) && !switch_bank_enable && !simd_enable;
+
+	SystemTableSolverGenerator table_gen;
+
+	if(table_enable && !lu_enable)
+	{
+		if(fused_enable)
+			table_gen.reset(src_gain.data(), dimension, num_components, solve_zero_bound, solved, solution_indices);
+		else
+			table_gen.reset(invg, dimension, dimension, solve_zero_bound, solved, solution_indices);
+	}
+
+	const std::string table_name = fused_enable ? "src_gain" : "inv_g";
+
+		//literals and solve code are written straight into their sections, with no intermediate copies
+
+	const std::string coefficient_type = getSignalTypeName(SystemWordLengthAnalyzer::COEFFICIENT);
+	std::string buf;
+
+	code.dimension = dimension;
+	code.num_components = num_components;
+	code.unrolled_rows = !switch_bank_enable && !simd_enable && !table_enable && !lu_enable && parameters.solve_adder_tree_fan_in < 2;
+
+		//unrolled sparse LU has its factors as constants in the code, so no matrix to partition
+
+	if(switch_bank_enable)
+	{
+		code.directives = generateSolveDirectiveCode("inv_g_bank", {switch_bank_gen.getNumberOfBankedStates(), dimension, dimension},
+			switch_bank_gen.getNumberOfMultiplyAccumulates(), false, dimension, num_components, !isStateStructEnabled());
+	}
+	else if(fused_enable && !simd_enable && !table_enable)
+	{
+		code.directives = generateSolveDirectiveCode("src_gain", {dimension, num_components}, num_macs, true, dimension, num_components, !isStateStructEnabled());
+	}
+	else if(!lu_enable && !simd_enable && !table_enable)
+	{
+		code.directives = generateSolveDirectiveCode("inv_g", {dimension, dimension}, num_macs, false, dimension, num_components, !isStateStructEnabled());
+	}
+	else
+	{
+		code.directives = generateSolveDirectiveCode("", {}, num_macs, fused_enable, dimension, num_components, !isStateStructEnabled());
+	}
+
+	if(switch_bank_enable)
+	{
+		sstrm << "//INVERTED CONDUCTANCE MATRIX BANK INDEXED BY SWITCH STATE\n\n";
+
+		switch_bank_gen.generateCLiteral(sstrm, "inv_g_bank", coefficient_type, parameters.inv_conduct_matrix_num_threads);
+		sstrm << "\n\n";
+	}
+	else if(simd_enable)
+	{
+		if(fused_enable)
+		{
+			sstrm << "//SOURCE GAIN MATRIX G^-1 * A (COLUMN-BLOCKED)\n\n";
+		}
+		else
+		{
+			sstrm << "//INVERTED CONDUCTANCE MATRIX G^-1 (COLUMN-BLOCKED)\n\n";
+		}
+
+		const std::string M_name = fused_enable ? "src_gain_simd" : "inv_g_simd";
+
+		if(isBinaryMatrixEnabled())
+		{
+			const std::vector<double> blocked = simd_solver_gen.getBlockedMatrix();
+
+			if(!blocked.empty())
+				generateBinaryMatrixCode(sstrm, M_name, {static_cast<unsigned long>(blocked.size())}, blocked.data(), "LBLMC_SIMD_ALIGN ");
+		}
+		else
+		{
+			simd_solver_gen.generateCLiteral(sstrm, M_name, coefficient_type);
+		}
+		sstrm << "\n\n";
+	}
+	else if(table_enable && lu_enable)
+	{
+		sstrm << "//SPARSE LU FACTOR TABLES\n\n";
+
+		lu_solver_gen.generateTableCLiteral(sstrm, coefficient_type);
+		sstrm << "\n\n";
+	}
+	else if(table_enable)
+	{
+		if(fused_enable)
+		{
+			sstrm << "//SOURCE GAIN MATRIX G^-1 * A";
+		}
+		else
+		{
+			sstrm << "//INVERTED CONDUCTANCE MATRIX G^-1";
+		}
+		sstrm << (table_gen.getFormat() == SystemTableSolverGenerator::ELL ? " (ELL TABLES)\n\n" : " (CSR TABLES)\n\n");
+
+		if(isBinaryMatrixEnabled())
+		{
+			const std::vector<double> table = table_gen.getValueTable();
+
+			if(!table.empty())
+				generateBinaryMatrixCode(sstrm, table_name + "_val", {static_cast<unsigned long>(table.size())}, table.data());
+		}
+		else
+		{
+			table_gen.generateValueCLiteral(sstrm, table_name, coefficient_type);
+		}
+
+		table_gen.generateIndexCLiteral(sstrm, table_name);
+		sstrm << "\n\n";
+	}
+	else if(fused_enable)
+	{
+		sstrm << "//SOURCE GAIN MATRIX G^-1 * A\n\n";
+
+		if(isBinaryMatrixEnabled())
+		{
+			if(num_components > 0)
+				generateBinaryMatrixCode(sstrm, "src_gain", {dimension, num_components}, src_gain.data());
+		}
+		else
+		{
+			solver_gen.generateSourceGainCLiteral(sstrm, src_gain.data(), "src_gain", coefficient_type, parameters.inv_conduct_matrix_num_threads);
+		}
+		sstrm << "\n\n";
+	}
+	else if(!lu_enable)
+	{
+		sstrm << "//INVERTED CONDUCTANCE MATRIX\n\n";
+
+		if(isBinaryMatrixEnabled())
+			generateBinaryMatrixCode(sstrm, "inv_g", {dimension, dimension}, invg);
+		else
+			invg_gen.asCLiteral(sstrm, "inv_g", coefficient_type, parameters.inv_conduct_matrix_num_threads);
+		sstrm << "\n\n";
+	}
+
+	code.literals = sstrm.str();
+	sstrm.str(std::string());
+
+	if(!fused_enable || parameters.io_source_vector_output_enable)
+	{
+		sstrm << "//AGGREGRATE COMPONENT SOURCE CONTRIBUTIONS\n\n";
+
+		buf = src_gen.asCInlineCode(parameters.solve_adder_tree_fan_in);
+		sstrm << buf << "\n\n";
+	}
+
+	code.aggregation = sstrm.str();
+	sstrm.str(std::string());
+
+	sstrm << "//MODEL UPDATE SOLUTIONS\n\n";
+
+	if(switch_bank_enable)
+	{
+		sstrm << switch_bank_gen.generateCInlineCode("inv_g_bank");
+	}
+	else if(simd_enable)
+	{
+		if(fused_enable)
+			sstrm << simd_solver_gen.generateCInlineCode("src_gain_simd", "b_components");
+		else
+			sstrm << simd_solver_gen.generateCInlineCode("inv_g_simd", "b");
+	}
+	else if(table_enable && lu_enable)
+	{
+		sstrm << lu_solver_gen.generateTableCInlineCode();
+	}
+	else if(table_enable)
+	{
+		sstrm << table_gen.generateCInlineCode(table_name, fused_enable ? "b_components" : "b");
+	}
+	else if(fused_enable)
+	{
+		sstrm << solver_gen.generateSourceGainCInlineCode(src_gain.data(), "src_gain");
+	}
+	else if(lu_enable)
+	{
+		sstrm << lu_solver_gen.generateCInlineCode();
+	}
+	else
+	{
+		solver_gen.generateCInlineCode(sstrm, "inv_g");
+	}
+	sstrm << "\n\n";
+
+	if(rescale_enable)
+	{
+		sstrm << "//RESCALE SOLUTIONS BY INVERTED CONDUCTANCE MATRIX DIVIDER\n\n";
+
+		buf = generateSolutionRescaleCode(dimension, solved, solution_indices, divider);
+		sstrm << buf << "\n\n";
+	}
+
+	code.solve = sstrm.str();
+
+	return code;
+}
+
+std::string SolverEngineGenerator::generateCInlineCode(double zero_bound) const
+{
+	std::stringstream sstrm;
+
+	generateCInlineCode(sstrm, zero_bound);
+
+	return sstrm.str();
+}
+
+void SolverEngineGenerator::generateCInlineCode(std::ostream& out, double zero_bound) const
+{
+	const SolveCode code = generateSolveCode(zero_bound);
+	const unsigned int dimension = code.dimension;
+	const unsigned int num_components = code.num_components;
+	const SystemDirectiveGenerator directive_gen(parameters.xilinx_hls_init_interval);
+
+	out << generateDirectiveCode(generateCFunctionParameterList());
+
+	out << "//MODEL PARAMETERS\n\n";
+
+	for(auto i : comp_parameters)
+	{
+		out << generateParameterCode(i) << "\n";
+	}
+	out << "\n";
+
+	if(isStateStructEnabled())
+	{
+		const SystemStateGenerator state_gen = createStateGenerator();
+
+		out << "//COMPONENT FIELDS AND STATES, AND MODEL SOLUTIONS, HELD BY STATE STRUCTURE\n\n";
+
+		out << state_gen.generateBindingCode() << "\n";
+
+		out << state_gen.getLocalFieldsCode() << "\n";
+
+		out << "//MODEL SOURCE VECTOR\n\n";
+
+		out
+		<< getSignalTypeName(SystemWordLengthAnalyzer::SOURCE) << " b["<<dimension<<"];\n\n";
+	}
+	else
+	{
+		out << "//COMPONENT FIELDS AND STATES\n\n";
+
+		for(auto i : comp_fields)
+		{
+			out << i << "\n";
+		}
+		out << "\n";
+
+		out << "//MODEL SOLUTIONS\n\n";
+
+		out
+		<< "static " << getSignalTypeName(SystemWordLengthAnalyzer::SOURCE) << " b["<<dimension<<"];\n"
+		<< "static " << getSignalTypeName(SystemWordLengthAnalyzer::SOLUTION) << " x["<<num_solutions+1<<"];\n"
+		<< "" << getSignalTypeName(SystemWordLengthAnalyzer::SOURCE) << " b_components["<<num_components<<"];\n\n";
+	}
+
+	out << code.literals;
+
+	out << code.directives;
+
+	out << "//COMPONENT SOURCE CONTRIBUTION UPDATES\n\n";
+
+	for(auto i : comp_update_bodies)
+	{
+		out << (parameters.xilinx_hls_enable ? directive_gen.generateLoopCode(i) : i) << "\n";
+	}
+	out << "\n";
+
+	if(parameters.io_signal_output_enable)
+	{
+		out << "//MODEL OUTPUT SIGNAL UPDATES\n\n";
+
+		for(auto i : comp_outputs_update_bodies)
+		{
+			out << (parameters.xilinx_hls_enable ? directive_gen.generateLoopCode(i) : i) << "\n";
+		}
+		out << "\n";
+	}
+
+	out << code.aggregation;
+
+	out << code.solve;
+}
+
+std::string SolverEngineGenerator::generateOutputCode() const
+{
+	std::stringstream sstrm;
+
+	if(parameters.io_source_vector_output_enable == true)
+	{
+		const std::vector<unsigned int> retained = findRetainedSolutions();
+		std::vector<long> reduced_row(num_solutions+1, -1);
+
+		for(unsigned int r = 0; r < retained.size(); r++)
+		{
+			reduced_row[retained[r]] = r;
+		}
+
+		for(unsigned int i = 0; i < num_solutions; i++)
+		{
+			if(reduced_row[i+1] < 0)
+				sstrm << "b_out["<<i<<"] = 0.0;\n";
+			else
+				sstrm << "b_out["<<i<<"] = b["<<reduced_row[i+1]<<"];\n";
+		}
+	}
+
+	sstrm << "\n";
+
+	if(parameters.io_component_sources_output_enable == true)
+	{
+		for(unsigned int i = 0; i < source_vector_gen.getNumSources(); i++)
+		{
+			sstrm << "sources_out["<<i<<"] = b_components["<<i<<"];\n";
+		}
+	}
+
+	sstrm << "\n";
+
+	const std::vector<bool> solved = findSolvedSolutions();
+	const std::vector<unsigned int> retained = findRetainedSolutions();
+	std::vector<bool> is_retained(num_solutions+1, false);
+
+	for(auto i : retained)
+	{
+		is_retained[i] = true;
+	}
+
+	for(unsigned int i = 0; i < num_solutions; i++)
+	{
+		if(!solved.empty() && !solved[i+1]) continue;
+		if(!is_retained[i+1]) continue;
+
+		sstrm << "x_out["<<i<<"] = x["<<i+1<<"];\n";
+	}
+
+	return sstrm.str();
+}
+
+SystemStateGenerator SolverEngineGenerator::createStateGenerator(bool hold_locals) const
+{
+	SystemStateGenerator state_gen;
+
+	for(const auto& code : comp_fields)
+	{
+		state_gen.insertFields(code, hold_locals);
+	}
+
+	state_gen.insertVariable(getSignalTypeName(SystemWordLengthAnalyzer::SOLUTION), "x", {std::to_string(num_solutions+1)});
+	state_gen.insertVariable(getSignalTypeName(SystemWordLengthAnalyzer::SOURCE), "b_components",
+		{std::to_string(source_vector_gen.getNumSources())});
+
+	return state_gen;
+}
+
+std::string SolverEngineGenerator::generateStateInitCFunction() const
+{
+	std::stringstream sstrm;
+
+	const bool templated_real = parameters.codegen_solver_templated_function_enable && parameters.codegen_solver_templated_real_type_enable;
+
+	if(templated_real)
+	{
+		sstrm
+		<< "template< typename real >\n";
+	}
+	else
+	{
+		sstrm
+		<< "inline\n";
+	}
+
+	sstrm
+	<< "void "<<model_name<<"_init("<<model_name<<"_state"<<(templated_real ? "<real>" : "")<<"* "<<SystemStateGenerator::STATE<<")\n"
+	<< "{\n";
+
+	sstrm << "//INITIALIZE COMPONENT FIELDS AND STATES, AND MODEL SOLUTIONS\n\n";
+
+	sstrm << createStateGenerator().generateInitializationCode();
+
+	sstrm
+	<< "}";
+
+	return sstrm.str();
+}
+
+SystemBatchGenerator SolverEngineGenerator::createBatchGenerator(std::string& parameter_list) const
+{
+	SystemBatchGenerator batch_gen(parameters.codegen_batch_width);
+
+	batch_gen.insertSourceParameters(comp_source_parameters);
+
+	for(const auto& code : comp_parameters)
+	{
+		batch_gen.insertParameters(code);
+	}
+
+	for(const auto& code : comp_fields)
+	{
+		batch_gen.insertFields(code);
+	}
+
+	batch_gen.insertVariable("b");
+	batch_gen.insertVariable("x");
+	batch_gen.insertVariable("b_components");
+
+	parameter_list = batch_gen.insertArguments(generateCFunctionParameterList());
+
+	return batch_gen;
+}
+
+void SolverEngineGenerator::generateBatchedCFunction(std::ostream& out, double zero_bound) const
+{
+	const bool templated_real = parameters.codegen_solver_templated_real_type_enable == true &&
+		parameters.codegen_solver_templated_function_enable == true;
+
+	if(parameters.codegen_solver_templated_function_enable == true)
+	{
+		out
+		<< "template< int instance";
+
+		if(templated_real)
+		{
+			out
+			<< ", typename real";
+		}
+
+		out
+		<< " >\n";
+	}
+
+	std::string parameter_list;
+	const SystemBatchGenerator batch_gen = createBatchGenerator(parameter_list);
+	const SolveCode code = generateSolveCode(zero_bound);
+	const unsigned int width = batch_gen.getWidth();
+
+	out
+	<< "void "<<model_name<<"_solver\n"
+	<< "(\n"
+	<< "const " << model_name << "_parameters" << (templated_real ? "<real>" : "") << "& " << SystemBatchGenerator::PARAMETERS << ",\n"
+	<< parameter_list
+	<< "\n)\n"
+	<< "{\n";
+
+	out << generateDirectiveCode(parameter_list);
+
+	out << "//MODEL PARAMETERS SHARED BY ALL INSTANCES\n\n";
+
+	out << batch_gen.getSharedParametersCode() << "\n";
+
+	out << "//COMPONENT FIELDS AND STATES OF EACH INSTANCE\n\n";
+
+	out << batch_gen.generateFieldDeclarations() << "\n";
+
+	out << "//MODEL SOLUTIONS OF EACH INSTANCE\n\n";
+
+	out
+	<< "static " << getSignalTypeName(SystemWordLengthAnalyzer::SOURCE) << " b["<<code.dimension<<"]["<<width<<"];\n"
+	<< "static " << getSignalTypeName(SystemWordLengthAnalyzer::SOLUTION) << " x["<<num_solutions+1<<"]["<<width<<"];\n"
+	<< "static " << getSignalTypeName(SystemWordLengthAnalyzer::SOURCE) << " b_components["<<code.num_components<<"]["<<width<<"];\n\n";
+
+	out << code.literals;
+
+	std::string buf = batch_gen.generateFieldInitializationCode();
+
+	if(!buf.empty())
+	{
+		out << "//INITIALIZE FIELDS OF EACH INSTANCE ON FIRST CALL\n\n";
+
+		out << buf << "\n";
+	}
+
+		//component updates branch per instance, so they are kept apart from the branch-free solve
+
+	std::stringstream instance;
+
+	instance << batch_gen.getLocalFieldsCode() << "\n";
+
+	for(auto i : comp_update_bodies)
+	{
+		instance << i << "\n";
+	}
+	instance << "\n";
+
+	if(parameters.io_signal_output_enable)
+	{
+		for(auto i : comp_outputs_update_bodies)
+		{
+			instance << i << "\n";
+		}
+		instance << "\n";
+	}
+
+	out << "//COMPONENT SOURCE CONTRIBUTION AND OUTPUT SIGNAL UPDATES OF EACH INSTANCE\n\n";
+
+	out << batch_gen.generateLoop(batch_gen.batchCode(instance.str())) << "\n";
+
+	out << "//SOLVE EACH INSTANCE, BROADCASTING EACH SOLVE MATRIX ELEMENT OVER THE INSTANCES\n\n";
+
+	out << batch_gen.generateLoop(batch_gen.batchCode(code.aggregation + code.solve)) << "\n";
+
+		//outputs are copied in a loop of their own, as stores to the output arguments within the solve loop could
+		//alias the solutions, which keeps compilers from vectorizing it
+
+	out << "//OUTPUT SOLUTIONS OF EACH INSTANCE\n\n";
+
+	out << batch_gen.generateLoop(batch_gen.batchCode(generateOutputCode()));
+
+	out
+	<< "\n}";
+}
+
+void SolverEngineGenerator::generateMultiStepCFunction(std::ostream& out, double zero_bound) const
+{
+	const unsigned int steps = parameters.codegen_multi_step_count;
+	const unsigned int decimation = parameters.codegen_multi_step_decimation;
+
+	if(decimation == 0 || steps % decimation != 0)
+		throw std::invalid_argument("SolverEngineGenerator::generateMultiStepCFunction(): codegen_multi_step_decimation must be nonzero and divide codegen_multi_step_count");
+
+	const bool templated_real = parameters.codegen_solver_templated_real_type_enable == true &&
+		parameters.codegen_solver_templated_function_enable == true;
+
+	if(isStateStructEnabled())
+	{
+		if(templated_real)
+		{
+			out
+			<< "template< typename real >\n";
+		}
+		else
+		{
+			out
+			<< "inline\n";
+		}
+	}
+	else if(parameters.codegen_solver_templated_function_enable == true)
+	{
+		out
+		<< "template< int instance";
+
+		if(templated_real)
+		{
+			out
+			<< ", typename real";
+		}
+
+		out
+		<< " >\n";
+	}
+	else
+	{
+		out
+		<< "inline\n";
+	}
+
+		//inputs are read every step and outputs written every step, into the output of its decimated step, so the
+		//arrays hold the outputs of the last step of every D steps
+
+	const std::string index = "k_step";
+	const std::string output_index = decimation > 1 ? index + "/" + std::to_string(decimation) : index;
+
+	SystemBatchGenerator step_gen;
+	std::stringstream parameter_list;
+
+	parameter_list << step_gen.insertArguments(ArrayObject("real", "x_out", "", {num_solutions}).generateArgument(), steps/decimation, output_index);
+
+	if(parameters.io_signal_output_enable)
+	{
+		for(const auto& output : comp_outputs)
+		{
+			parameter_list << ",\n" << step_gen.insertArguments(output, steps/decimation, output_index);
+		}
+	}
+
+	for(const auto& input : comp_inputs)
+	{
+		parameter_list << ",\n" << step_gen.insertArguments(input, steps, index);
+	}
+
+	if(parameters.io_source_vector_output_enable == true)
+	{
+		parameter_list << ",\n" << step_gen.insertArguments(ArrayObject("real", "b_out", "", {num_solutions}).generateArgument(),
+			steps/decimation, output_index);
+	}
+
+	if(parameters.io_component_sources_output_enable == true)
+	{
+		parameter_list << ",\n" << step_gen.insertArguments(ArrayObject("real", "sources_out", "", {source_vector_gen.getNumSources()}).generateArgument(),
+			steps/decimation, output_index);
+	}
+
+	if(isStateStructEnabled())
+	{
+		out
+		<< "void "<<model_name<<"_step_n\n"
+		<< "(\n"
+		<< model_name<<"_state"<<(templated_real ? "<real>" : "")<<"* "<<SystemStateGenerator::STATE<<",\n";
+	}
+	else
+	{
+		out
+		<< "void "<<model_name<<"_solver_n\n"
+		<< "(\n";
+	}
+
+	out
+	<< parameter_list.str()
+	<< "\n)\n"
+	<< "{\n";
+
+	const SolveCode code = generateSolveCode(zero_bound);
+	const SystemDirectiveGenerator directive_gen(parameters.xilinx_hls_init_interval);
+
+		//steps depend on the ones before, so the step loop is pipelined rather than the solver
+
+	out << generateDirectiveCode(parameter_list.str(), steps);
+
+	out << "//MODEL PARAMETERS\n\n";
+
+	for(auto i : comp_parameters)
+	{
+		out << generateParameterCode(i) << "\n";
+	}
+	out << "\n";
+
+		//persistent fields are declared once, while temporaries are made each step
+
+	SystemStateGenerator field_gen;
+
+	for(const auto& i : comp_fields)
+	{
+		field_gen.insertFields(i);
+	}
+
+	if(isStateStructEnabled())
+	{
+		out << "//COMPONENT FIELDS AND STATES, AND MODEL SOLUTIONS, HELD BY STATE STRUCTURE\n\n";
+
+		out << createStateGenerator().generateBindingCode() << "\n";
+
+		out << "//MODEL SOURCE VECTOR\n\n";
+
+		out
+		<< getSignalTypeName(SystemWordLengthAnalyzer::SOURCE) << " b["<<code.dimension<<"];\n\n";
+	}
+	else
+	{
+		out << "//COMPONENT FIELDS AND STATES\n\n";
+
+		out << field_gen.generateStaticDeclarations() << "\n";
+
+		out << "//MODEL SOLUTIONS\n\n";
+
+		out
+		<< "static " << getSignalTypeName(SystemWordLengthAnalyzer::SOURCE) << " b["<<code.dimension<<"];\n"
+		<< "static " << getSignalTypeName(SystemWordLengthAnalyzer::SOLUTION) << " x["<<num_solutions+1<<"];\n"
+		<< "" << getSignalTypeName(SystemWordLengthAnalyzer::SOURCE) << " b_components["<<code.num_components<<"];\n\n";
+	}
+
+	out << code.literals;
+
+	out << code.directives;
+
+	std::stringstream step;
+
+	if(parameters.xilinx_hls_enable)
+	{
+		if(directive_gen.getInitInterval() > 0)
+			step << directive_gen.generatePipelineCode() << "\n";
+	}
+	else
+	{
+		step << "//#pipeline //set step loop pipeline directive(s) here\n\n";
+	}
+
+	step << field_gen.getLocalFieldsCode() << "\n";
+
+	step << "//COMPONENT SOURCE CONTRIBUTION UPDATES\n\n";
+
+	for(auto i : comp_update_bodies)
+	{
+		step << (parameters.xilinx_hls_enable ? directive_gen.generateLoopCode(i) : i) << "\n";
+	}
+	step << "\n";
+
+	if(parameters.io_signal_output_enable)
+	{
+		step << "//MODEL OUTPUT SIGNAL UPDATES\n\n";
+
+		for(auto i : comp_outputs_update_bodies)
+		{
+			step << (parameters.xilinx_hls_enable ? directive_gen.generateLoopCode(i) : i) << "\n";
+		}
+		step << "\n";
+	}
+
+	step << code.aggregation;
+
+	step << code.solve;
+
+	step << generateOutputCode();
+
+	out << "//STEP MODEL " << steps << " TIME STEPS\n\n";
+
+	out << step_gen.generateLoop(step_gen.batchCode(step.str()), steps, index);
+
+	out
+	<< "\n}";
+}
+
+std::string SolverEngineGenerator::generateCFunction(double zero_bound) const
+{
+	std::stringstream sstrm;
+
+	generateCFunction(sstrm, zero_bound);
+
+	return sstrm.str();
+}
+
+void SolverEngineGenerator::generateCFunction(std::ostream& out, double zero_bound) const
+{
+	if(isStateStructEnabled() && isBatchEnabled())
+		throw std::runtime_error("SolverEngineGenerator::generateCFunction(): state structure is not supported with batched solvers");
+
+	if(isBatchEnabled())
+	{
+		generateBatchedCFunction(out, zero_bound);
+		return;
+	}
+
+	if(isStateStructEnabled())
+	{
+			//instances are made by the caller as state structures, so only the real type can be templated
+
+		const bool templated_real = parameters.codegen_solver_templated_function_enable && parameters.codegen_solver_templated_real_type_enable;
+
+		if(templated_real)
+		{
+			out
+			<< "template< typename real >\n";
+		}
+
+		const std::string parameter_list = generateCFunctionParameterList();
+
+		out
+		<< "void "<<model_name<<"_step\n"
+		<< "(\n"
+		<< model_name<<"_state"<<(templated_real ? "<real>" : "")<<"* "<<SystemStateGenerator::STATE
+		<< (parameter_list.empty() ? "" : ",\n") << parameter_list
+		<< "\n)\n"
+		<< "{\n";
+	}
+	else
+	{
+		if(parameters.codegen_solver_templated_function_enable == true)
+		{
+			out
+			<< "template< int instance";
+
+			if(parameters.codegen_solver_templated_real_type_enable == true)
+			{
+				out
+				<< ", typename real";
+			}
+
+			out
+			<< " >\n";
+		}
+
+		out
+		<< "void "<<model_name<<"_solver\n"
+		<< "(\n";
+
+		out
+		<< generateCFunctionParameterList()
+		<< "\n)\n"
+		<< "{\n";
+	}
+
+	generateCInlineCode(out, zero_bound);
+
+	out << generateOutputCode();
+
+	out
+	<< "\n}";
+}
+
+void SolverEngineGenerator::generateSplitCFunctionAndExport(std::string filename, double zero_bound) const
+{
+	if(filename == "")
+		throw std::invalid_argument("SolverEngineGenerator::generateSplitCFunctionAndExport(): filename cannot be null or empty");
+
+	if(isBatchEnabled() || isMultiStepEnabled())
+		throw std::runtime_error("SolverEngineGenerator::generateSplitCFunctionAndExport(): split solver is not supported with batched or multi-step solvers");
+
+	const bool templated_real = parameters.codegen_solver_templated_function_enable && parameters.codegen_solver_templated_real_type_enable;
+
+		//sources are named after the header, next to it
+
+	const std::size_t name_begin = filename.find_last_of('/') == std::string::npos ? 0 : filename.find_last_of('/') + 1;
+	const std::size_t extension = filename.rfind('.');
+	const std::string base = extension == std::string::npos || extension < name_begin ? filename : filename.substr(0, extension);
+	const std::string header_name = filename.substr(name_begin);
+	const std::string split_namespace = model_name + "_split";
+
+	const std::string banner =
+			"/**\n"
+			" *\n"
 			" * LB-LMC based Circuit Solver Engine\n"
 			" *\n"
 			" * Auto-generated by SolverEngineGenerator Object of the ORTiS Circuit Solver Codegen Tools\n"
 			" *\n"
 			" */\n\n";
 
+	auto open_file = [](std::ofstream& file, const std::string& name)
+	{
+		file.open(name, std::ofstream::out | std::ofstream::trunc);
+
+		if(!file)
+			throw std::runtime_error("SolverEngineGenerator::generateSplitCFunctionAndExport(): failed to open or create " + name);
+	};
+
+	const SolveCode code = generateSolveCode(zero_bound);
+
+		//the parts share the fields, solutions, source vector, and temporaries of the components through the state
+
+	SystemStateGenerator state_gen = createStateGenerator(true);
+	state_gen.insertVariable(getSignalTypeName(SystemWordLengthAnalyzer::SOURCE), "b", {std::to_string(code.dimension)});
+
+	SystemStateGenerator temporaries_gen;
+	temporaries_gen.insertFields(createStateGenerator().getLocalFieldsCode(), true);
+
+		//temporaries declared by update bodies and read by output code, which may land in another part, are held by the state
+
+	std::vector<std::string> update_bodies = comp_update_bodies;
+	std::unordered_set<std::string> output_words;
+
+	if(parameters.io_signal_output_enable)
+	{
+		for(const auto& i : comp_outputs_update_bodies)
+		{
+			const std::unordered_set<std::string> words = SystemSplitGenerator::findWords(i);
+			output_words.insert(words.begin(), words.end());
+		}
+	}
+
+	for(auto& i : update_bodies)
+	{
+		state_gen.insertFields(SystemSplitGenerator::extractDeclarations(i, output_words), true);
+	}
+
+	SystemSplitGenerator split_gen(parameters.codegen_split_function_size);
+
+	for(const auto& i : comp_parameters)
+	{
+		split_gen.insertDeclarations(generateParameterCode(i));
+	}
+
+	const std::string parameter_list = generateCFunctionParameterList();
+
+	split_gen.insertDeclarations(state_gen.generateBindingCode());
+
+	split_gen.insertArguments(parameter_list);
+
+	split_gen.insertLiterals(code.literals);
+
+		//temporaries are reset by the parts too, so that the step itself only calls the parts
+
+	split_gen.insertStatements(temporaries_gen.generateInitializationCode());
+
+	for(const auto& i : update_bodies)
+	{
+		split_gen.insertCode(i);
+	}
+
+	if(parameters.io_signal_output_enable)
+	{
+		for(const auto& i : comp_outputs_update_bodies)
+		{
+			split_gen.insertCode(i);
+		}
+	}
+
+	if(code.unrolled_rows)
+	{
+		split_gen.insertStatements(code.aggregation);
+		split_gen.insertStatements(code.solve);
+	}
+	else
+	{
+		split_gen.insertCode(code.aggregation);
+		split_gen.insertCode(code.solve);
+	}
+
+	split_gen.insertStatements(generateOutputCode());
+
+		//the parts are static members of a class holding the literals, templated on the real type as the solver is,
+		//and instantiated by the sources for real type LBLMC_SPLIT_REAL
+
+	const std::string template_head = templated_real ? "template< typename real >\n" : "";
+	const std::string real_argument = templated_real ? "<real>" : "";
+	const std::string instance_argument = "<LBLMC_SPLIT_REAL>";
+
+	const std::string state_struct = model_name + "_state";
+	const std::string arguments_struct = model_name + "_arguments";
+	const std::string parts_class = model_name + "_parts";
+
+	const std::string state_parameter = state_struct + real_argument + "* " + SystemStateGenerator::STATE;
+
+	const std::string step_parameters = "(\n" + state_parameter + (parameter_list.empty() ? "" : ",\n") + parameter_list + "\n)";
+	const std::string part_parameters = "(\n" + state_parameter + ",\n" + arguments_struct + real_argument + "* " + SystemSplitGenerator::ARGUMENTS + "\n)";
+	const std::string part_instance_parameters = "(" + state_struct + instance_argument + "*, " + arguments_struct + instance_argument + "*)";
+
+	std::string arguments;
+
+	for(const auto& name : SystemSplitGenerator::findArgumentNames(parameter_list))
+	{
+		arguments += (arguments.empty() ? "" : ", ") + name;
+	}
+
+	std::ofstream file;
+
+		//header declaring the state structure and the parts, and defining the functions stepping the state through the parts
+
+	open_file(file, filename);
+
+	file << banner;
+
 	file << "#ifndef " << model_name << "_SIMULATIONENGINE_HPP" << "\n";
 	file << "#define " << model_name << "_SIMULATIONENGINE_HPP" << "\n";
 
 	file << "\n\n";
 
-	if( !( parameters.codegen_solver_templated_real_type_enable == true &&
-		parameters.codegen_solver_templated_function_enable == true ) )
+	file << generateRealTypeCode(zero_bound);
+
+	if(templated_real)
 	{
-		if(parameters.fixed_point_enable)
-		{
-			if(parameters.xilinx_hls_enable)
-			{
-				file <<
-				"#include <ap_fixed.h>\n" <<
-				"typedef ap_fixed<"<<parameters.fixed_point_word_width<<", "<<
-				parameters.fixed_point_int_width<<", AP_RND> real;\n\n";
+		file
+		<< "#ifndef LBLMC_SPLIT_REAL\n"
+		<< "#define LBLMC_SPLIT_REAL double\n"
+		<< "#endif\n\n";
+	}
 
-			}
-			else
-			{
-				file << "//platform-agnostic fixed point not supported yet. Using double real values\n"<<
-				"typedef double real;\n\n";
-			}
-		}
-		else
+	if(isSIMDSolveEnabled())
+	{
+		file << SystemSIMDSolverGenerator::generateKernelCode() << "\n\n";
+	}
+
+	if(isBinaryMatrixEnabled())
+	{
+		file << SystemBinaryMatrixGenerator::generateLoaderCode() << "\n\n";
+	}
+
+	file << state_gen.generateStateStruct(state_struct, templated_real) << "\n";
+
+		//the arguments are passed to the parts at once, as references held by a structure
+
+	file
+	<< "namespace " << split_namespace << "\n"
+	<< "{\n\n";
+
+	file << template_head << SystemSplitGenerator::generateArgumentsStruct(arguments_struct, parameter_list) << "\n";
+
+	file
+	<< template_head
+	<< "struct " << parts_class << "\n"
+	<< "{\n";
+
+	file << "//SOLVE MATRICES AND TABLES SHARED BY THE STEP PARTS\n\n";
+
+	file << split_gen.generateLiteralMemberCode() << "\n";
+
+	file << "//INITIAL COMPONENT FIELDS AND STATES, MODEL SOLUTIONS, AND COMPONENT TEMPORARIES\n\n";
+
+	file << "static const " << state_struct << real_argument << " initial_state;\n\n";
+
+	file << "//STEP PARTS, EACH DEFINED IN ITS OWN SOURCE FILE\n\n";
+
+	for(unsigned int k = 0; k < split_gen.getNumberOfParts(); k++)
+	{
+		file
+		<< "static void step_part"<<k<<"\n"
+		<< part_parameters << ";\n\n";
+	}
+
+	file << "};\n\n";
+
+	file << "} //namespace " << split_namespace << "\n\n";
+
+	file
+	<< (templated_real ? template_head : "inline\n")
+	<< "void "<<model_name<<"_init("<<state_parameter<<")\n"
+	<< "{\n"
+	<< "*" << SystemStateGenerator::STATE << " = " << split_namespace << "::" << parts_class << real_argument << "::initial_state;\n"
+	<< "}\n\n";
+
+	file
+	<< (templated_real ? template_head : "inline\n")
+	<< "void "<<model_name<<"_step\n"
+	<< step_parameters << "\n"
+	<< "{\n";
+
+	file << split_namespace << "::" << arguments_struct << real_argument << " " << SystemSplitGenerator::ARGUMENTS << " = {" << arguments << "};\n\n";
+
+	file << "//STEP PARTS\n\n";
+
+	for(unsigned int k = 0; k < split_gen.getNumberOfParts(); k++)
+	{
+		file << split_namespace << "::" << parts_class << real_argument << "::step_part" << k << "(" << SystemStateGenerator::STATE << ", &"
+		<< SystemSplitGenerator::ARGUMENTS << ");\n";
+	}
+
+	file
+	<< "}\n";
+
+	file << "\n#endif";
+
+	file.close();
+
+		//source defining the literals and the initial state
+
+	std::ofstream sources;
+
+	open_file(sources, base + "_sources.txt");
+
+	open_file(file, base + ".cpp");
+
+	sources << base.substr(name_begin) << ".cpp\n";
+
+	file << banner;
+
+	file << "#include \"" << header_name << "\"\n\n";
+
+	file
+	<< "namespace " << split_namespace << "\n"
+	<< "{\n\n";
+
+	file << "//SOLVE MATRICES AND TABLES SHARED BY THE STEP PARTS\n\n";
+
+	file << split_gen.generateLiteralDefinitionCode(template_head, parts_class + real_argument) << "\n";
+
+	file << "//INITIAL COMPONENT FIELDS AND STATES, MODEL SOLUTIONS, AND COMPONENT TEMPORARIES\n\n";
+
+	file
+	<< template_head
+	<< "const " << state_struct << real_argument << " " << parts_class << real_argument << "::initial_state =\n"
+	<< state_gen.generateInitializerList() << ";\n\n";
+
+	if(templated_real)
+	{
+		file << "template struct " << parts_class << instance_argument << ";\n\n";
+	}
+
+	file << "} //namespace " << split_namespace << "\n";
+
+	file.close();
+
+		//sources of the parts, each declaring only what its code refers to
+
+	for(unsigned int k = 0; k < split_gen.getNumberOfParts(); k++)
+	{
+		const std::string part_name = base + "_part" + std::to_string(k) + ".cpp";
+
+		open_file(file, part_name);
+
+		sources << part_name.substr(name_begin) << "\n";
+
+		file << banner;
+
+		file << "#include \"" << header_name << "\"\n\n";
+
+		file
+		<< "namespace " << split_namespace << "\n"
+		<< "{\n\n";
+
+		file
+		<< template_head
+		<< "void "<<parts_class<<real_argument<<"::step_part"<<k<<"\n"
+		<< part_parameters << "\n"
+		<< "{\n";
+
+		file << "//MODEL PARAMETERS, AND COMPONENT FIELDS AND STATES, MODEL SOLUTIONS, AND ARGUMENTS READ BY THIS PART\n\n";
+
+		file << split_gen.generateDeclarationCode(k) << "\n";
+
+		file << split_gen.getPartCode(k);
+
+		file
+		<< "}\n\n";
+
+		if(templated_real)
 		{
-			file << "typedef double real;\n\n";
+			file << "template void " << parts_class << instance_argument << "::step_part" << k << part_instance_parameters << ";\n\n";
 		}
+
+		file << "} //namespace " << split_namespace << "\n";
+
+		file.close();
 	}
 
-	if(parameters.codegen_solver_templated_function_enable == false)
+	if(!sources)
+		throw std::runtime_error("SolverEngineGenerator::generateSplitCFunctionAndExport(): failed to write " + base + "_sources.txt");
+}
+
+void SolverEngineGenerator::generateCFunctionAndExport(std::string filename, double zero_bound) const
+{
+	if(filename == "")
+		throw std::invalid_argument("SimulationEngineGenerator::generateCFunctionAndExport(): filename cannot be null or empty");
+
+	if(isSplitEnabled())
 	{
-		file << "inline\n";
+		generateSplitCFunctionAndExport(filename, zero_bound);
+		return;
 	}
 
-    std::string buf;
-    buf = generateCFunction(zero_bound);
-    file << buf << "\n\n";
+	std::fstream file;
 
-	file << "\n#endif";
+	std::string fname = filename;
+
+	try
+	{
+		file.open(fname.c_str(), std::fstream::out | std::fstream::trunc);
+	}
+	catch(...)
+	{
+		throw std::runtime_error("SimulationEngineGenerator::generateCFunctionAndExport(): failed to open or create source files");
+	}
+
+	generateCFunctionAndExport(file, zero_bound);
 
 	file.close();
 
 }
 
+void SolverEngineGenerator::generateCFunctionAndExport(std::ostream& out, double zero_bound) const
+{
+	if(isSplitEnabled())
+		throw std::runtime_error("SolverEngineGenerator::generateCFunctionAndExport(): split solver is written to several files, so is only exported by filename");
+
+	if(isStateStructEnabled() && isBatchEnabled())
+		throw std::runtime_error("SolverEngineGenerator::generateCFunctionAndExport(): state structure is not supported with batched solvers");
+
+	if(isMultiStepEnabled() && isBatchEnabled())
+		throw std::runtime_error("SolverEngineGenerator::generateCFunctionAndExport(): multi-step solver is not supported with batched solvers");
+
+	out <<
+			"/**\n"
+			" *\n"
+			" * LB-LMC based Circuit Solver Engine\n"
+			" *\n"
+			" * Auto-generated by SolverEngineGenerator Object of the ORTiS Circuit Solver Codegen Tools\n"
+			" *\n"
+			" */\n\n";
+
+	out << "#ifndef " << model_name << "_SIMULATIONENGINE_HPP" << "\n";
+	out << "#define " << model_name << "_SIMULATIONENGINE_HPP" << "\n";
+
+	out << "\n\n";
+
+	out << generateRealTypeCode(zero_bound);
+
+	if(isSIMDSolveEnabled())
+	{
+		out << SystemSIMDSolverGenerator::generateKernelCode() << "\n\n";
+	}
+
+	if(isBinaryMatrixEnabled())
+	{
+		out << SystemBinaryMatrixGenerator::generateLoaderCode() << "\n\n";
+	}
+
+	if(isBatchEnabled())
+	{
+		std::string parameter_list;
+
+		out << createBatchGenerator(parameter_list).generateParametersStruct(model_name + "_parameters",
+			parameters.codegen_solver_templated_real_type_enable && parameters.codegen_solver_templated_function_enable) << "\n";
+	}
+
+	if(isStateStructEnabled())
+	{
+		const bool templated_real = parameters.codegen_solver_templated_function_enable && parameters.codegen_solver_templated_real_type_enable;
+
+		out << createStateGenerator().generateStateStruct(model_name + "_state", templated_real) << "\n";
+
+		out << generateStateInitCFunction() << "\n\n";
+
+		if(!templated_real)
+		{
+			out << "inline\n";
+		}
+	}
+	else if(parameters.codegen_solver_templated_function_enable == false)
+	{
+		out << "inline\n";
+	}
+
+	generateCFunction(out, zero_bound);
+	out << "\n\n";
+
+	if(isMultiStepEnabled())
+	{
+		generateMultiStepCFunction(out, zero_bound);
+		out << "\n\n";
+	}
+
+	out << "\n#endif";
+}
+
 } //namespace lblmc
@@ -36,6 +36,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 
 #include "codegen/ArrayObject.hpp"
 #include "codegen/CodeGenDataTypes.hpp"
+#include "codegen/RealLiteralFormatter.hpp"
 
 namespace lblmc
 {
@@ -75,6 +76,7 @@ void SubsystemSolverEngineGenerator::reset(std::string model_name, unsigned int
 	this->model_name = model_name;
 	this->num_solutions = num_solutions;
 	this->comp_parameters.clear();
+	this->comp_source_parameters.clear();
 	this->comp_fields.clear();
 	this->comp_inputs.clear();
 	this->comp_outputs.clear();
@@ -137,6 +139,19 @@ const SubsystemSolverEngineGenerator::Port& SubsystemSolverEngineGenerator::getP
 	throw std::out_of_range("SubsystemSolverEngineGenerator::getPort(id) -- port does not exist for given id");
 }
 
+bool SubsystemSolverEngineGenerator::hasPort(unsigned int id) const
+{
+	for(const auto& p : ports)
+	{
+		if(p.id == id)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 std::vector<SubsystemSolverEngineGenerator::PortModel> SubsystemSolverEngineGenerator::computePortModels() const
 {
 	if(ports.empty())
@@ -144,6 +159,11 @@ std::vector<SubsystemSolverEngineGenerator::PortModel> SubsystemSolverEngineGene
 		throw std::runtime_error("SubsystemSolverEngineGenerator::computePortModels() -- subsystem has no ports for which to compute models");
 	}
 
+	if(conductance_matrix_gen.getNumberOfSwitches() > 0)
+	{
+		throw std::runtime_error("SubsystemSolverEngineGenerator::computePortModels() -- cannot compute fixed port models of subsystem with switched conductances");
+	}
+
 	unsigned int num_ports = ports.size();
 	unsigned int dimension = conductance_matrix_gen.getDimension();
 	unsigned int num_sources = source_vector_gen.getNumSources();
@@ -195,19 +215,30 @@ std::vector<SubsystemSolverEngineGenerator::PortModel> SubsystemSolverEngineGene
 		}
 	}
 
-		//init solution, source, and zero vector
+		//factor gprobe once; as the port models only read the probe currents, solving the transposed
+		//system for each probe gives the rows of gprobe^-1 relating the probe currents to all sources
+
+	const auto gprobe_lu = gprobe.fullPivLu();
+
+	if(!gprobe_lu.isInvertible())
+	{
+		throw std::runtime_error("SubsystemSolverEngineGenerator::computePortModels() -- conductance matrix of subsystem with port probes is singular");
+	}
+
+	MatrixRMXd eprobe = MatrixRMXd::Zero(dimension+num_ports, num_ports);
 
-	VectorRMXd vzeroed = VectorRMXd::Zero(dimension+num_ports);
-	VectorRMXd bprobe = vzeroed;
-	VectorRMXd xprobe = vzeroed;
+	for(unsigned int i = 0; i < num_ports; i++)
+	{
+		eprobe(dimension+i, i) = 1.0;
+	}
+
+	const MatrixRMXd probe_rows = gprobe_lu.transpose().solve(eprobe); // column i is row dimension+i of gprobe^-1
 
 		//compute conductances and transconductances
 
 	for(unsigned int i = 0; i < num_ports; i++) // iterate probes
 	{
-		bprobe(dimension+i) = 1.0;
-
-		xprobe = gprobe.fullPivLu().solve(bprobe); // x = G\b with full pivot LU factorization
+		const double probe_current = probe_rows(dimension+i, i);
 
 		for(unsigned int j = 0; j < num_ports; j++) // iterate port models
 		{
@@ -215,54 +246,44 @@ std::vector<SubsystemSolverEngineGenerator::PortModel> SubsystemSolverEngineGene
 
 			if(mdl.id == ports[i].id)
 			{
-				mdl.conductance = xprobe(dimension+i);
+				mdl.conductance = probe_current;
 			}
 			else
 			{
-                //mdl.transconductances[i] = xprobe(dimension+i); //changed 2021-01-15-17.52
-                mdl.transconductances[i+1] = xprobe(dimension+i);
+                mdl.transconductances[ports[i].id] = probe_current;
 			}
 
 		}
-
-		bprobe = vzeroed;
 	}
 
-		//compute port source gains
+		//compute port source gains, each the probe current from a unit source across its nodes
 
-	for(unsigned int i = 0; i < num_ports; i++) //iterate probes/models
+	for(unsigned int s = 0; s < num_sources; s++) //iterate sources
 	{
-		auto& mdl = port_models[i];
+		const auto& source_nodes = source_vector_gen.getSourceNodesById(s+1);
 
-		for(unsigned int s = 0; s < num_sources; s++) //iterate sources; may need to init s to 1
+		for(unsigned int i = 0; i < num_ports; i++) //iterate probes/models
 		{
-			//  update bprobe for present source at s, like in pseudo code below:
-			// vector nodes = source_vector_gen.getNodeIndicesForSource(s);
-			// bprobe (at nodes) = +/- 1.0;
-
-			const auto& source_nodes = source_vector_gen.getSourceNodesById(s+1);
+			double gain = 0.0;
 
 			if(source_nodes[0] != 0)
 			{
-				bprobe(source_nodes[0]-1) += 1.0;
+				gain += probe_rows(source_nodes[0]-1, i);
 
 				if(source_nodes[1] != 0)
 				{
-					bprobe(source_nodes[1]-1) += -1.0;
+					gain -= probe_rows(source_nodes[1]-1, i);
 				}
 			}
 			else
 			{
 				if(source_nodes[1] != 0)
 				{
-					bprobe(source_nodes[1]-1) += 1.0;
+					gain += probe_rows(source_nodes[1]-1, i);
 				}
 			}
 
-			xprobe = gprobe.fullPivLu().solve(bprobe); // x = G\b with full pivot LU factorization
-			mdl.source_gains[s] = xprobe(dimension+i);
-
-			bprobe = vzeroed;
+			port_models[i].source_gains[s] = gain;
 		}
 	}
 
@@ -285,6 +306,10 @@ void SubsystemSolverEngineGenerator::stampOthersPortModel(const PortModel& port_
 
             for(const auto& xconduct_pair : port_model.transconductances)
 			{
+					//ports of the other subsystem to a third one are not seen from this subsystem
+
+				if(!hasPort(xconduct_pair.first)) continue;
+
                 const auto& other_port = getPort( xconduct_pair.first );
                 conductance_matrix_gen.stampTransconductance
                 (
@@ -344,7 +369,6 @@ void SubsystemSolverEngineGenerator::addOwnSourceGains(const std::vector<PortMod
 std::string SubsystemSolverEngineGenerator::generatePortSourceEquation(unsigned int port_id) const
 {
 	std::stringstream sstrm;
-	sstrm << std::setprecision(16) << std::fixed << std::scientific;
 
 	try
 	{
@@ -359,14 +383,14 @@ std::string SubsystemSolverEngineGenerator::generatePortSourceEquation(unsigned
 
 		auto gain_pair_begin_iter = gains.begin();
 
-		sstrm << "b_components["<<(gain_pair_begin_iter->first)<<"]*real("<<(gain_pair_begin_iter->second)<<")";
+		sstrm << "b_components["<<(gain_pair_begin_iter->first)<<"]*real("<<RealLiteralFormatter::format(gain_pair_begin_iter->second)<<")";
 
 		++gain_pair_begin_iter;
 
 		for(auto gain_pair_iter = gain_pair_begin_iter; gain_pair_iter != gains.end(); gain_pair_iter++)
 		{
             sstrm << " + " <<
-            "b_components["<<(gain_pair_iter->first)<<"]*real("<<(gain_pair_iter->second)<<")";
+            "b_components["<<(gain_pair_iter->first)<<"]*real("<<RealLiteralFormatter::format(gain_pair_iter->second)<<")";
 		}
 
 		sstrm << ";\n\n";
@@ -442,6 +466,24 @@ std::string SubsystemSolverEngineGenerator::generatePortSourceOutputParameterLis
 }
 
 
+std::vector<bool> SubsystemSolverEngineGenerator::findObservedSolutions() const
+{
+	std::vector<bool> observed = SolverEngineGenerator::findObservedSolutions();
+
+	for(const auto& port : ports)
+	{
+		if(port.p < observed.size()) observed[port.p] = true;
+		if(port.n < observed.size()) observed[port.n] = true;
+	}
+
+	return observed;
+}
+
+bool SubsystemSolverEngineGenerator::isSplitEnabled() const
+{
+	return false;
+}
+
 std::string SubsystemSolverEngineGenerator::generateCFunctionParameterList() const
 {
 	std::stringstream sstrm;
@@ -511,196 +553,427 @@ std::string SubsystemSolverEngineGenerator::generateCFunctionParameterList() con
 	return sstrm.str();
 }
 
-std::string SubsystemSolverEngineGenerator::generateCInlineCode(double zero_bound) const
+void SubsystemSolverEngineGenerator::generateCInlineCode(std::ostream& out, double zero_bound) const
 {
-	std::stringstream sstrm;
+	const bool switch_bank_enable = conductance_matrix_gen.getNumberOfSwitches() > 0;
+	const bool fused_enable = parameters.solve_fused_source_gain_enable && !switch_bank_enable;
+	const bool lu_enable = parameters.solve_sparse_lu_enable && !fused_enable && !switch_bank_enable;
+
+	const std::vector<bool> solved = findSolvedSolutions();
+
+		//conductance matrix and source vector of the system actually solved, Kron reduced if enabled
+
+	SystemConductanceGenerator cond_gen(conductance_matrix_gen);
+	SystemSourceVectorGenerator src_gen(source_vector_gen);
+	std::vector<unsigned int> solution_indices;
+
+	if(parameters.solve_kron_reduction_enable)
+	{
+		solution_indices = reduceSystem(cond_gen, src_gen);
+	}
+
+	const unsigned int dimension = cond_gen.getDimension();
+
+	SystemConductanceGenerator invg_gen(cond_gen);
+	SystemLUSolverGenerator lu_solver_gen;
+	SystemSwitchBankGenerator switch_bank_gen;
+	MatrixRMXd src_gain;
 
-	SystemConductanceGenerator invg_gen(conductance_matrix_gen);
-	invg_gen.invertSelf();
-	const double * invg = invg_gen.asArray();
+	if(switch_bank_enable)
+	{
+		switch_bank_gen.reset(cond_gen, parameters.switch_bank_memory_budget, zero_bound);
+		switch_bank_gen.setAdderTreeFanIn(parameters.solve_adder_tree_fan_in);
+		switch_bank_gen.setSolvedSolutions(solved);
+		switch_bank_gen.setSolutionIndices(solution_indices);
+	}
+	else if(lu_enable)
+	{
+		lu_solver_gen.reset(cond_gen.asSparseMatrix(), zero_bound);
+		lu_solver_gen.setAdderTreeFanIn(parameters.solve_adder_tree_fan_in);
+		lu_solver_gen.setSolvedSolutions(solved);
+		lu_solver_gen.setSolutionIndices(solution_indices);
+	}
+	else
+	{
+		invertSolveMatrix(invg_gen, src_gen, solved, solution_indices);
+	}
+
+	const bool sparsify_enable = parameters.sparsify_error_budget > 0.0 && !lu_enable && !switch_bank_enable;
+
+	if(sparsify_enable && !fused_enable)
+	{
+		invg_gen.asEigen3Matrix() = sparsifySolveMatrix(invg_gen.asEigen3Matrix(), src_gen, false, zero_bound).getMatrix();
+	}
+
+	const double * invg = lu_enable ? nullptr : invg_gen.asArray();
+
+	unsigned int num_components = src_gen.getNumSources();
+
+		//rescaled solve matrix discards the same elements as unscaled
+
+	const bool rescale_enable = parameters.inv_conduct_matrix_rescale_enable && !lu_enable && !switch_bank_enable;
+	const double divider = rescale_enable ? findSolveMatrixDivider() : 1.0;
+	const double solve_zero_bound = zero_bound/divider;
+
+	SystemSolverGenerator solver_gen(invg, dimension, num_components, solve_zero_bound);
+	solver_gen.setAdderTreeFanIn(parameters.solve_adder_tree_fan_in);
+	solver_gen.setSolvedSolutions(solved);
+	solver_gen.setSolutionIndices(solution_indices);
+
+	if(fused_enable)
+	{
+		src_gain = invg_gen.asEigen3Matrix() * src_gen.asIncidenceMatrix();
+
+		if(sparsify_enable)
+		{
+			src_gain = sparsifySolveMatrix(src_gain, src_gen, true, zero_bound).getMatrix();
+		}
+	}
+
+	if(rescale_enable)
+	{
+		invg_gen.asEigen3Matrix() /= divider;
+		src_gain /= divider;
+	}
 
-	unsigned int num_components = source_vector_gen.getNumSources();
+	const bool simd_enable = parameters.solve_simd_enable && !lu_enable && !switch_bank_enable && !(fused_enable && num_components == 0);
 
-	SystemSolverGenerator solver_gen(invg, num_solutions, num_components, zero_bound);
+	SystemSIMDSolverGenerator simd_solver_gen;
 
-	std::string buf;
+	if(simd_enable)
+	{
+		if(fused_enable)
+			simd_solver_gen.reset(src_gain.data(), dimension, num_components, solve_zero_bound);
+		else
+			simd_solver_gen.reset(invg, dimension, dimension, solve_zero_bound);
+
+		simd_solver_gen.setSolvedSolutions(solved);
+		simd_solver_gen.setSolutionIndices(solution_indices);
+	}
+
+		//large solves loop over compressed tables, instead of unrolling a statement per element
+
+	unsigned long num_macs = solver_gen.getNumberOfMultiplyAccumulates();
+
+	if(lu_enable)
+		num_macs = lu_solver_gen.getNumberOfMultiplyAccumulates();
+	else if(fused_enable)
+		num_macs = num_components > 0 ? solver_gen.getNumberOfSourceGainMultiplyAccumulates(src_gain.data()) : 0;
+
+	const bool table_enable = isTableSolveEnabled(num_macs) && !switch_bank_enable && !simd_enable;
+
+	SystemTableSolverGenerator table_gen;
+
+	if(table_enable && !lu_enable)
+	{
+		if(fused_enable)
+			table_gen.reset(src_gain.data(), dimension, num_components, solve_zero_bound, solved, solution_indices);
+		else
+			table_gen.reset(invg, dimension, dimension, solve_zero_bound, solved, solution_indices);
+	}
+
+	const std::string table_name = fused_enable ? "src_gain" : "inv_g";
+
+	const std::string coefficient_type = getSignalTypeName(SystemWordLengthAnalyzer::COEFFICIENT);
+	const SystemDirectiveGenerator directive_gen(parameters.xilinx_hls_init_interval);
 
 	//codegen xilinx HLS features
 	if(parameters.xilinx_hls_enable)
 	{
-		sstrm << "//clock period=" << parameters.xilinx_hls_clock_period << "\n";
+		out << "//clock period=" << parameters.xilinx_hls_clock_period << "\n";
 
 		if(parameters.xilinx_hls_inline)
 		{
-			sstrm << "#pragma HLS inline\n";
+			out << "#pragma HLS inline\n";
+		}
+		else
+		{
+			out << directive_gen.generateInterfaceCode(generateCFunctionParameterList());
 		}
 
 		if(parameters.xilinx_hls_latency_enable)
 		{
-			sstrm << "#pragma HLS latency min="<<parameters.xilinx_hls_latency_min<<
+			out << "#pragma HLS latency min="<<parameters.xilinx_hls_latency_min<<
 			         " max="<<parameters.xilinx_hls_latency_max<<"\n";
 		}
 
-		sstrm << "\n";
+		if(!parameters.xilinx_hls_inline)
+		{
+			out << directive_gen.generatePipelineCode();
+		}
+
+		out << "\n";
 	}
 
-	sstrm << "//MODEL PARAMETERS\n\n";
+	out << "//MODEL PARAMETERS\n\n";
 
 	for(auto i : comp_parameters)
 	{
-		sstrm << i << "\n";
+		out << i << "\n";
 	}
-	sstrm << "\n";
+	out << "\n";
 
-	sstrm << "//COMPONENT FIELDS AND STATES\n\n";
+	out << "//COMPONENT FIELDS AND STATES\n\n";
 
 	for(auto i : comp_fields)
 	{
-		sstrm << i << "\n";
+		out << i << "\n";
 	}
-	sstrm << "\n";
+	out << "\n";
 
-	sstrm << "//MODEL SOLUTIONS\n\n";
+	out << "//MODEL SOLUTIONS\n\n";
 
-	sstrm
-	<< "static real b["<<num_solutions<<"];\n"
-	<< "static real x["<<num_solutions+1<<"];\n"
-	<< "static real b_components["<<num_components<<"];\n\n";
+	out
+	<< "static " << getSignalTypeName(SystemWordLengthAnalyzer::SOURCE) << " b["<<dimension<<"];\n"
+	<< "static " << getSignalTypeName(SystemWordLengthAnalyzer::SOLUTION) << " x["<<num_solutions+1<<"];\n"
+	<< "static " << getSignalTypeName(SystemWordLengthAnalyzer::SOURCE) << " b_components["<<num_components<<"];\n\n";
 
-	sstrm << "//INVERTED CONDUCTANCE MATRIX G^-1\n\n";
+	if(switch_bank_enable)
+	{
+		out << "//INVERTED CONDUCTANCE MATRIX BANK INDEXED BY SWITCH STATE\n\n";
 
-	buf = invg_gen.asCLiteral("inv_g");
-	sstrm << buf << "\n\n";
+		switch_bank_gen.generateCLiteral(out, "inv_g_bank", coefficient_type, parameters.inv_conduct_matrix_num_threads);
+		out << "\n\n";
+	}
+	else if(simd_enable)
+	{
+		if(fused_enable)
+		{
+			out << "//SOURCE GAIN MATRIX G^-1 * A (COLUMN-BLOCKED)\n\n";
+
+			simd_solver_gen.generateCLiteral(out, "src_gain_simd", coefficient_type);
+		}
+		else
+		{
+			out << "//INVERTED CONDUCTANCE MATRIX G^-1 (COLUMN-BLOCKED)\n\n";
+
+			simd_solver_gen.generateCLiteral(out, "inv_g_simd", coefficient_type);
+		}
+		out << "\n\n";
+	}
+	else if(table_enable && lu_enable)
+	{
+		out << "//SPARSE LU FACTOR TABLES\n\n";
+
+		lu_solver_gen.generateTableCLiteral(out, coefficient_type);
+		out << "\n\n";
+	}
+	else if(table_enable)
+	{
+		if(fused_enable)
+		{
+			out << "//SOURCE GAIN MATRIX G^-1 * A";
+		}
+		else
+		{
+			out << "//INVERTED CONDUCTANCE MATRIX G^-1";
+		}
+		out << (table_gen.getFormat() == SystemTableSolverGenerator::ELL ? " (ELL TABLES)\n\n" : " (CSR TABLES)\n\n");
+
+		table_gen.generateValueCLiteral(out, table_name, coefficient_type);
+		table_gen.generateIndexCLiteral(out, table_name);
+		out << "\n\n";
+	}
+	else if(fused_enable)
+	{
+		out << "//SOURCE GAIN MATRIX G^-1 * A\n\n";
+
+		solver_gen.generateSourceGainCLiteral(out, src_gain.data(), "src_gain", coefficient_type, parameters.inv_conduct_matrix_num_threads);
+		out << "\n\n";
+	}
+	else if(!lu_enable)
+	{
+		out << "//INVERTED CONDUCTANCE MATRIX G^-1\n\n";
+
+		invg_gen.asCLiteral(out, "inv_g", coefficient_type, parameters.inv_conduct_matrix_num_threads);
+		out << "\n\n";
+	}
+
+	if(switch_bank_enable)
+	{
+		out << generateSolveDirectiveCode("inv_g_bank", {switch_bank_gen.getNumberOfBankedStates(), dimension, dimension},
+			switch_bank_gen.getNumberOfMultiplyAccumulates(), false, dimension, num_components, true);
+	}
+	else if(fused_enable && !simd_enable && !table_enable)
+	{
+		out << generateSolveDirectiveCode("src_gain", {dimension, num_components}, num_macs, true, dimension, num_components, true);
+	}
+	else if(!lu_enable && !simd_enable && !table_enable)
+	{
+		out << generateSolveDirectiveCode("inv_g", {dimension, dimension}, num_macs, false, dimension, num_components, true);
+	}
+	else
+	{
+		out << generateSolveDirectiveCode("", {}, num_macs, fused_enable, dimension, num_components, true);
+	}
 
-	sstrm << "//READ PORT INJECTIONS FROM OTHER SUBSYSTEMS H(n-1)\n\n";
+	out << "//READ PORT INJECTIONS FROM OTHER SUBSYSTEMS H(n-1)\n\n";
 
 	for(const auto& id_pair : port_source_ids)
 	{
-		sstrm <<
+		out <<
 		"b_components["<<id_pair.second-1<<"]"<<" = "<<"port_inject_"<<id_pair.first<<"_in"<<";\n";
 	}
-	sstrm << "\n";
+	out << "\n";
 
-	sstrm << "//AGGREGRATE COMPONENT SOURCE CONTRIBUTIONS b(n-1)\n\n";
+	if(!fused_enable || parameters.io_source_vector_output_enable)
+	{
+		out << "//AGGREGRATE COMPONENT SOURCE CONTRIBUTIONS b(n-1)\n\n";
 
-	source_vector_gen.asCInlineCode(buf);
-	sstrm << buf << "\n\n";
+		out << src_gen.asCInlineCode(parameters.solve_adder_tree_fan_in) << "\n\n";
+	}
 
-	sstrm << "//MODEL UPDATE SOLUTIONS x(n)=G^-1 * b(n-1)\n\n";
+	out << "//MODEL UPDATE SOLUTIONS x(n)=G^-1 * b(n-1)\n\n";
 
-	solver_gen.generateCInlineCode(buf, "inv_g");
-	sstrm << buf << "\n\n";
+	if(switch_bank_enable)
+	{
+		out << switch_bank_gen.generateCInlineCode("inv_g_bank");
+	}
+	else if(simd_enable)
+	{
+		if(fused_enable)
+			out << simd_solver_gen.generateCInlineCode("src_gain_simd", "b_components");
+		else
+			out << simd_solver_gen.generateCInlineCode("inv_g_simd", "b");
+	}
+	else if(table_enable && lu_enable)
+	{
+		out << lu_solver_gen.generateTableCInlineCode();
+	}
+	else if(table_enable)
+	{
+		out << table_gen.generateCInlineCode(table_name, fused_enable ? "b_components" : "b");
+	}
+	else if(fused_enable)
+	{
+		out << solver_gen.generateSourceGainCInlineCode(src_gain.data(), "src_gain");
+	}
+	else if(lu_enable)
+	{
+		out << lu_solver_gen.generateCInlineCode();
+	}
+	else
+	{
+		solver_gen.generateCInlineCode(out, "inv_g");
+	}
+	out << "\n\n";
+
+	if(rescale_enable)
+	{
+		out << "//RESCALE SOLUTIONS BY INVERTED CONDUCTANCE MATRIX DIVIDER\n\n";
+
+		out << generateSolutionRescaleCode(dimension, solved, solution_indices, divider) << "\n\n";
+	}
 
-	sstrm << "//COMPONENT SOURCE CONTRIBUTION UPDATES b_comp(n)\n\n";
+	out << "//COMPONENT SOURCE CONTRIBUTION UPDATES b_comp(n)\n\n";
 
 	for(auto i : comp_update_bodies)
 	{
-		sstrm << i << "\n";
+		out << (parameters.xilinx_hls_enable ? directive_gen.generateLoopCode(i) : i) << "\n";
 	}
-	sstrm << "\n";
+	out << "\n";
 
 	if(parameters.io_signal_output_enable)
 	{
-		sstrm << "//MODEL OUTPUT SIGNAL UPDATES y(n)\n\n";
+		out << "//MODEL OUTPUT SIGNAL UPDATES y(n)\n\n";
 
 		for(auto i : comp_outputs_update_bodies)
 		{
-			sstrm << i << "\n";
+			out << (parameters.xilinx_hls_enable ? directive_gen.generateLoopCode(i) : i) << "\n";
 		}
-		sstrm << "\n";
+		out << "\n";
 	}
-
-	return sstrm.str();
 }
 
-std::string SubsystemSolverEngineGenerator::generateCFunction(double zero_bound) const
+void SubsystemSolverEngineGenerator::generateCFunction(std::ostream& out, double zero_bound) const
 {
-	std::stringstream sstrm;
-
 	if(parameters.codegen_solver_templated_function_enable == true)
 	{
-        sstrm
+        out
         << "template< int instance";
 
         if(parameters.codegen_solver_templated_real_type_enable == true)
 		{
-			sstrm
+			out
 			<< ", typename real";
 		}
 
-		sstrm
+		out
 		<< " >\n";
 	}
 
-	sstrm
+	out
 	<< "void "<<model_name<<"_solver\n"
 	<< "(\n";
 
-	sstrm
+	out
 	<< generateCFunctionParameterList()
 	<< "\n)\n"
 	<< "{\n";
 
-	std::string buf;
-	buf = generateCInlineCode(zero_bound);
-	sstrm << buf;
+	generateCInlineCode(out, zero_bound);
 
 	if(parameters.io_source_vector_output_enable == true)
 	{
+		const std::vector<unsigned int> retained = findRetainedSolutions();
+		std::vector<long> reduced_row(num_solutions+1, -1);
+
+		for(unsigned int r = 0; r < retained.size(); r++)
+		{
+			reduced_row[retained[r]] = r;
+		}
+
 		for(unsigned int i = 0; i < num_solutions; i++)
 		{
-			sstrm << "b_out["<<i<<"] = b["<<i<<"];\n";
+			if(reduced_row[i+1] < 0)
+				out << "b_out["<<i<<"] = 0.0;\n";
+			else
+				out << "b_out["<<i<<"] = b["<<reduced_row[i+1]<<"];\n";
 		}
 	}
 
-	sstrm << "\n";
+	out << "\n";
 
 	if(parameters.io_component_sources_output_enable == true)
 	{
 		for(unsigned int i = 0; i < source_vector_gen.getNumSources(); i++)
 		{
-			sstrm << "sources_out["<<i<<"] = b_components["<<i<<"];\n";
+			out << "sources_out["<<i<<"] = b_components["<<i<<"];\n";
 		}
 	}
 
-	sstrm << "\n";
+	out << "\n";
+
+	out << "//UPDATE PORT INJECTIONS TO OTHER SUBSYSTEMS\n\n";
+
+	out << generatePortSourceEquations() << "\n";
 
-	sstrm << "//UPDATE PORT INJECTIONS TO OTHER SUBSYSTEMS\n\n";
+	out << "//UPDATE OUTPUTS\n\n";
 
-	sstrm << generatePortSourceEquations() << "\n";
+	const std::vector<bool> solved = findSolvedSolutions();
+	const std::vector<unsigned int> retained = findRetainedSolutions();
+	std::vector<bool> is_retained(num_solutions+1, false);
 
-	sstrm << "//UPDATE OUTPUTS\n\n";
+	for(auto i : retained)
+	{
+		is_retained[i] = true;
+	}
 
 	for(unsigned int i = 0; i < num_solutions; i++)
 	{
-		sstrm << "x_out["<<i<<"] = x["<<i+1<<"];\n";
+		if(!solved.empty() && !solved[i+1]) continue;
+		if(!is_retained[i+1]) continue;
+
+		out << "x_out["<<i<<"] = x["<<i+1<<"];\n";
 	}
 
-	sstrm
+	out
 	<< "\n}";
-
-	return sstrm.str();
 }
 
-void SubsystemSolverEngineGenerator::generateCFunctionAndExport(std::string filename, double zero_bound) const
+void SubsystemSolverEngineGenerator::generateCFunctionAndExport(std::ostream& out, double zero_bound) const
 {
-	if(filename == "")
-		throw std::invalid_argument("SubsystemSolverEngineGenerator::generateCFunctionAndExport(): filename cannot be null or empty");
-
-	std::fstream file;
-
-	std::string fname = filename;
-
-	try
-	{
-		file.open(fname.c_str(), std::fstream::out | std::fstream::trunc);
-	}
-	catch(...)
-	{
-		throw std::runtime_error("SubsystemSolverEngineGenerator::generateCFunctionAndExport(): failed to open or create source files");
-	}
-
-	file <<
+	out <<
 			"/**\n"
 			" *\n"
 			" * LBLMC Vivado HLS Simulation Engine for FPGA Designs\n"
@@ -709,49 +982,27 @@ void SubsystemSolverEngineGenerator::generateCFunctionAndExport(std::string file
 			" *\n"
 			" */\n\n";
 
-	file << "#ifndef " << model_name << "_SIMULATIONENGINE_HPP" << "\n";
-	file << "#define " << model_name << "_SIMULATIONENGINE_HPP" << "\n";
+	out << "#ifndef " << model_name << "_SIMULATIONENGINE_HPP" << "\n";
+	out << "#define " << model_name << "_SIMULATIONENGINE_HPP" << "\n";
 
-	file << "\n\n";
+	out << "\n\n";
 
-	if( !( parameters.codegen_solver_templated_real_type_enable == true &&
-		parameters.codegen_solver_templated_function_enable == true ) )
-	{
-		if(parameters.fixed_point_enable)
-		{
-			if(parameters.xilinx_hls_enable)
-			{
-				file <<
-				"#include <ap_fixed.h>\n" <<
-				"typedef ap_fixed<"<<parameters.fixed_point_word_width<<", "<<
-				parameters.fixed_point_int_width<<", AP_RND> real;\n\n";
+	out << generateRealTypeCode(zero_bound);
 
-			}
-			else
-			{
-				file << "//platform-agnostic fixed point not supported yet. Using double real values\n"<<
-				"typedef double real;\n\n";
-			}
-		}
-		else
-		{
-			file << "typedef double real;\n\n";
-		}
+	if(parameters.solve_simd_enable)
+	{
+		out << SystemSIMDSolverGenerator::generateKernelCode() << "\n\n";
 	}
 
 	if(parameters.codegen_solver_templated_function_enable == false)
 	{
-		file << "inline\n";
+		out << "inline\n";
 	}
 
-    std::string buf;
-    buf = generateCFunction(zero_bound);
-    file << buf << "\n\n";
-
-	file << "\n#endif";
-
-	file.close();
+	generateCFunction(out, zero_bound);
+	out << "\n\n";
 
+	out << "\n#endif";
 }
 
 } //namespace lblmc
@@ -0,0 +1,448 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/SystemBatchGenerator.hpp"
+
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <cctype>
+
+namespace lblmc
+{
+
+const std::string SystemBatchGenerator::INDEX = "w";
+const std::string SystemBatchGenerator::PARAMETERS = "params";
+
+SystemBatchGenerator::SystemBatchGenerator() :
+	width(1), variables(), indices(), fields(), source_parameters(), parameters(), shared_code(), local_code()
+{}
+
+SystemBatchGenerator::SystemBatchGenerator(unsigned int width) :
+	width(width), variables(), indices(), fields(), source_parameters(), parameters(), shared_code(), local_code()
+{
+	if(width == 0)
+		throw std::invalid_argument("SystemBatchGenerator::constructor(): width must be nonzero");
+}
+
+void SystemBatchGenerator::reset(unsigned int width)
+{
+	if(width == 0)
+		throw std::invalid_argument("SystemBatchGenerator::reset(): width must be nonzero");
+
+	this->width = width;
+	variables.clear();
+	indices.clear();
+	fields.clear();
+	source_parameters.clear();
+	parameters.clear();
+	shared_code.clear();
+	local_code.clear();
+}
+
+void SystemBatchGenerator::insertVariable(const std::string& name)
+{
+	variables[name] = VALUE;
+}
+
+void SystemBatchGenerator::insertSourceParameters(const std::vector<std::string>& names)
+{
+	source_parameters.insert(names.begin(), names.end());
+}
+
+void SystemBatchGenerator::insertParameters(const std::string& code)
+{
+	for(const auto& statement : SystemStateGenerator::splitTopLevel(SystemStateGenerator::stripComments(code), ';'))
+	{
+		const std::string decl = SystemStateGenerator::trim(statement);
+		if(decl.empty()) continue;
+
+		const std::size_t eq = decl.find('=');
+		if(eq == std::string::npos)
+			throw std::runtime_error("SystemBatchGenerator::insertParameters(): cannot parse parameter declaration: " + decl);
+
+		std::istringstream head(decl.substr(0, eq));
+		std::vector<std::string> words;
+		std::string word;
+
+		while(head >> word) words.push_back(word);
+
+			//"const static real name" or "static const real name" of source parameters are per instance; all else is shared
+
+		const bool per_instance = words.size() == 4 && words[2] == "real" &&
+			((words[0] == "const" && words[1] == "static") || (words[0] == "static" && words[1] == "const")) &&
+			source_parameters.count(words[3]) != 0;
+
+		if(!per_instance)
+		{
+			shared_code += decl + ";\n";
+			continue;
+		}
+
+		parameters.push_back(std::make_pair(words[3], SystemStateGenerator::trim(decl.substr(eq+1))));
+		variables[words[3]] = PARAMETER;
+	}
+}
+
+void SystemBatchGenerator::insertFields(const std::string& code)
+{
+	SystemStateGenerator state_gen;
+	state_gen.insertFields(code);
+
+	for(const auto& field : state_gen.getFields())
+	{
+		fields.push_back(field);
+		variables[field.name] = VALUE;
+	}
+
+		//temporaries are made per instance
+
+	local_code += state_gen.getLocalFieldsCode();
+}
+
+std::string SystemBatchGenerator::insertArguments(const std::string& arguments)
+{
+	return insertArguments(arguments, width, INDEX);
+}
+
+std::string SystemBatchGenerator::insertArguments(const std::string& arguments, unsigned int length, const std::string& index)
+{
+	std::stringstream sstrm;
+	bool first = true;
+
+	for(const auto& argument : SystemStateGenerator::splitTopLevel(SystemStateGenerator::stripComments(arguments), ','))
+	{
+		if(SystemStateGenerator::trim(argument).empty()) continue;
+
+		std::vector<std::string> dimensions;
+		std::string head = SystemStateGenerator::stripDimensions(argument, dimensions);
+
+		std::size_t name_begin = head.size();
+		while(name_begin > 0 && (std::isalnum((unsigned char)head[name_begin-1]) || head[name_begin-1] == '_')) name_begin--;
+
+		const std::string name = head.substr(name_begin);
+		std::string type = SystemStateGenerator::trim(head.substr(0, name_begin));
+
+		if(name.empty() || type.empty())
+			throw std::runtime_error("SystemBatchGenerator::insertArguments(): cannot parse argument: " + SystemStateGenerator::trim(argument));
+
+			//pointers and references to one value become arrays of the values of the instances
+
+		VariableKind kind = VALUE;
+
+		if(type.back() == '*')
+		{
+			kind = POINTER;
+			type = SystemStateGenerator::trim(type.substr(0, type.size()-1));
+		}
+		else if(type.back() == '&')
+		{
+			type = SystemStateGenerator::trim(type.substr(0, type.size()-1));
+		}
+
+		variables[name] = kind;
+
+		if(index != INDEX) indices[name] = index;
+		else indices.erase(name);
+
+		if(!first) sstrm << ",\n";
+		first = false;
+
+		sstrm << type << " " << name;
+		for(const auto& d : dimensions) sstrm << "[" << d << "]";
+		sstrm << "[" << length << "]";
+	}
+
+	return sstrm.str();
+}
+
+std::string SystemBatchGenerator::getIndex(const std::string& name) const
+{
+	const auto found = indices.find(name);
+
+	return found == indices.end() ? INDEX : found->second;
+}
+
+std::string SystemBatchGenerator::generateParametersStruct(const std::string& struct_name, bool templated_real) const
+{
+	std::stringstream sstrm;
+
+	if(templated_real)
+	{
+		sstrm << "template<typename real>\n";
+	}
+
+	sstrm
+	<< "struct " << struct_name << "\n"
+	<< "{\n";
+
+	for(const auto& p : parameters)
+	{
+		sstrm << "\treal " << p.first << "[" << width << "];\n";
+	}
+
+	sstrm
+	<< "\n"
+	<< "\t" << struct_name << "()\n"
+	<< "\t{\n"
+	<< "\t\tfor(int " << INDEX << " = 0; " << INDEX << " < " << width << "; " << INDEX << "++)\n"
+	<< "\t\t{\n";
+
+	for(const auto& p : parameters)
+	{
+		sstrm << "\t\t\t" << p.first << "[" << INDEX << "] = " << p.second << ";\n";
+	}
+
+	sstrm
+	<< "\t\t}\n"
+	<< "\t}\n"
+	<< "};\n";
+
+	return sstrm.str();
+}
+
+std::string SystemBatchGenerator::generateFieldDeclarations() const
+{
+	std::stringstream sstrm;
+
+	for(const auto& field : fields)
+	{
+		sstrm << "static " << field.type << " " << field.name;
+		for(const auto& d : field.dimensions) sstrm << "[" << d << "]";
+		sstrm << "[" << width << "];\n";
+	}
+
+	return sstrm.str();
+}
+
+std::string SystemBatchGenerator::generateFieldInitializationCode() const
+{
+	std::stringstream body;
+
+	for(const auto& field : fields)
+	{
+		if(field.initializer.empty()) continue;
+
+		if(field.dimensions.empty())
+		{
+			body << field.name << "[" << INDEX << "] = " << batchCode(field.initializer) << ";\n";
+			continue;
+		}
+
+			//copy an initialized array of one instance into the widened array element by element
+
+		std::string init_name = field.name + "_init";
+		std::string element = field.name;
+		std::string init_element = init_name;
+
+		body << "{\n" << "const " << field.type << " " << init_name;
+		for(const auto& d : field.dimensions) body << "[" << d << "]";
+		body << " = " << batchCode(field.initializer) << ";\n";
+
+		for(unsigned int k = 0; k < field.dimensions.size(); k++)
+		{
+			const std::string index = "k" + std::to_string(k);
+			body << "for(int " << index << " = 0; " << index << " < " << field.dimensions[k] << "; " << index << "++)\n";
+			element += "[" + index + "]";
+			init_element += "[" + index + "]";
+		}
+
+		body << element << "[" << INDEX << "] = " << init_element << ";\n" << "}\n";
+	}
+
+	if(body.str().empty()) return std::string();
+
+	std::stringstream sstrm;
+
+	sstrm
+	<< "static bool batch_initialized = false;\n"
+	<< "if(!batch_initialized)\n"
+	<< "{\n"
+	<< generateLoop(body.str())
+	<< "batch_initialized = true;\n"
+	<< "}\n";
+
+	return sstrm.str();
+}
+
+std::string SystemBatchGenerator::batchCode(const std::string& code) const
+{
+	const std::size_t len = code.size();
+	std::string out;
+	out.reserve(len + len/4);
+
+	auto is_word = [](char c) { return std::isalnum((unsigned char)c) || c == '_'; };
+
+		//last two characters of code outside comments and whitespace, to tell dereferences from products
+
+	char last = 0;
+	char before_last = 0;
+
+	auto significant = [&](char c)
+	{
+		if(std::isspace((unsigned char)c)) return;
+		before_last = last;
+		last = c;
+	};
+
+	for(std::size_t i = 0; i < len; i++)
+	{
+			//copy comments and literals as is
+
+		if(code.compare(i, 2, "//") == 0 || code.compare(i, 2, "/*") == 0)
+		{
+			std::size_t end = code[i+1] == '/' ? code.find('\n', i) : code.find("*/", i+2);
+			end = end == std::string::npos ? len : end + (code[i+1] == '/' ? 0 : 2);
+			out.append(code, i, end-i);
+			i = end-1;
+			continue;
+		}
+
+		if(code[i] == '"' || code[i] == '\'')
+		{
+			const char quote = code[i];
+			std::size_t end = i+1;
+			for(; end < len && code[end] != quote; end++)
+			{
+				if(code[end] == '\\') end++;
+			}
+			end = end < len ? end+1 : len;
+			out.append(code, i, end-i);
+			significant('0');
+			i = end-1;
+			continue;
+		}
+
+		if(!is_word(code[i]))
+		{
+			out += code[i];
+			significant(code[i]);
+			continue;
+		}
+
+		std::size_t end = i;
+		while(end < len && (is_word(code[end]) || (std::isdigit((unsigned char)code[i]) && code[end] == '.'))) end++;
+
+		const std::string word = code.substr(i, end-i);
+		const bool member = (i > 0 && code[i-1] == '.') || (i > 1 && code.compare(i-2, 2, "->") == 0);
+		const auto found = variables.find(word);
+
+		const char previous = last;
+		const char before_previous = before_last;
+
+		significant('0');
+
+		if(member || std::isdigit((unsigned char)code[i]) || found == variables.end())
+		{
+			out += word;
+			i = end-1;
+			continue;
+		}
+
+		if(found->second == PARAMETER)
+		{
+			out += PARAMETERS + "." + word + "[" + getIndex(word) + "]";
+			i = end-1;
+			continue;
+		}
+
+		if(found->second == POINTER)
+		{
+				//dereference *name, where the * follows no operand, is the value of the instance
+
+			const bool deref = previous == '*' &&
+				!(is_word(before_previous) || before_previous == ')' || before_previous == ']');
+
+			if(deref)
+			{
+				std::size_t star = out.size();
+				while(star > 0 && std::isspace((unsigned char)out[star-1])) star--;
+
+				out.erase(star-1);
+				out += word + "[" + getIndex(word) + "]";
+			}
+			else
+			{
+				out += "(" + word + "+" + getIndex(word) + ")";
+			}
+
+			i = end-1;
+			continue;
+		}
+
+			//index after the subscripts of one instance
+
+		std::size_t j = end;
+
+		while(true)
+		{
+			std::size_t k = j;
+			while(k < len && std::isspace((unsigned char)code[k])) k++;
+			if(k >= len || code[k] != '[') break;
+
+			int depth = 0;
+			for(; k < len; k++)
+			{
+				if(code[k] == '[') depth++;
+				if(code[k] == ']' && --depth == 0) break;
+			}
+
+			if(k >= len) break;
+			j = k+1;
+		}
+
+		out += word + batchCode(code.substr(end, j-end)) + "[" + getIndex(word) + "]";
+		i = j-1;
+	}
+
+	return out;
+}
+
+std::string SystemBatchGenerator::generateLoop(const std::string& code) const
+{
+	return generateLoop(code, width, INDEX);
+}
+
+std::string SystemBatchGenerator::generateLoop(const std::string& code, unsigned int count, const std::string& index) const
+{
+	std::stringstream sstrm;
+
+	sstrm
+	<< "for(int " << index << " = 0; " << index << " < " << count << "; " << index << "++)\n"
+	<< "{\n";
+
+	std::istringstream lines(code);
+	std::string line;
+
+	while(std::getline(lines, line))
+	{
+		if(line.empty()) sstrm << "\n";
+		else sstrm << "\t" << line << "\n";
+	}
+
+	sstrm << "}\n";
+
+	return sstrm.str();
+}
+
+} // namespace lblmc
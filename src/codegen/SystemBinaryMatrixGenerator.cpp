@@ -0,0 +1,154 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/SystemBinaryMatrixGenerator.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <cstdint>
+#include <stdexcept>
+
+namespace lblmc
+{
+
+void SystemBinaryMatrixGenerator::exportBinary(std::string filename, const double* M, unsigned long count)
+{
+	if(filename.empty())
+		throw std::invalid_argument("SystemBinaryMatrixGenerator::exportBinary(): filename cannot be empty");
+
+	if(M == nullptr && count > 0)
+		throw std::invalid_argument("SystemBinaryMatrixGenerator::exportBinary(): M cannot be null");
+
+	std::ofstream file(filename, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+	if(!file)
+		throw std::runtime_error("SystemBinaryMatrixGenerator::exportBinary(): failed to open or create " + filename);
+
+	const std::uint64_t stored_count = count;
+
+	file.write("LBLMCMAT", 8);
+	file.write(reinterpret_cast<const char*>(&stored_count), sizeof(stored_count));
+	file.write(reinterpret_cast<const char*>(M), count*sizeof(double));
+
+	if(!file)
+		throw std::runtime_error("SystemBinaryMatrixGenerator::exportBinary(): failed to write " + filename);
+}
+
+std::string SystemBinaryMatrixGenerator::generateLoaderCode()
+{
+	return
+	"#ifndef LBLMC_BINARY_MATRIX_LOADER\n"
+	"#define LBLMC_BINARY_MATRIX_LOADER\n"
+	"\n"
+	"#include <cstdio>\n"
+	"#include <cstring>\n"
+	"\n"
+	"#ifndef LBLMC_BINARY_MATRIX_DIR\n"
+	"#define LBLMC_BINARY_MATRIX_DIR \"\"\n"
+	"#endif\n"
+	"\n"
+	"//false once any binary matrix failed to load; check after the first call of the solver\n"
+	"\n"
+	"inline bool& lblmc_binary_matrices_loaded()\n"
+	"{\n"
+	"\tstatic bool loaded = true;\n"
+	"\treturn loaded;\n"
+	"}\n"
+	"\n"
+	"//fills M[count] from binary file holding magic LBLMCMAT, the 8 byte element count, and the elements as doubles;\n"
+	"//zeroes M and returns false if the file is missing or does not hold count elements\n"
+	"\n"
+	"template<typename real_m>\n"
+	"inline bool lblmc_load_binary_matrix(const char* filename, real_m* M, unsigned long count)\n"
+	"{\n"
+	"\tstd::FILE* file = std::fopen(filename, \"rb\");\n"
+	"\tchar magic[8];\n"
+	"\tunsigned long long stored_count = 0;\n"
+	"\tbool valid = file != NULL &&\n"
+	"\t\tstd::fread(magic, 1, 8, file) == 8 && std::memcmp(magic, \"LBLMCMAT\", 8) == 0 &&\n"
+	"\t\tstd::fread(&stored_count, sizeof(stored_count), 1, file) == 1 && stored_count == count;\n"
+	"\n"
+	"\tdouble buf[512];\n"
+	"\n"
+	"\tfor(unsigned long i = 0; valid && i < count; i += 512)\n"
+	"\t{\n"
+	"\t\tconst unsigned long n = count - i < 512 ? count - i : 512;\n"
+	"\n"
+	"\t\tvalid = std::fread(buf, sizeof(double), n, file) == n;\n"
+	"\n"
+	"\t\tfor(unsigned long k = 0; valid && k < n; k++) M[i+k] = real_m(buf[k]);\n"
+	"\t}\n"
+	"\n"
+	"\tif(file != NULL) std::fclose(file);\n"
+	"\n"
+	"\tif(!valid)\n"
+	"\t{\n"
+	"\t\tfor(unsigned long i = 0; i < count; i++) M[i] = real_m(0);\n"
+	"\n"
+	"\t\tlblmc_binary_matrices_loaded() = false;\n"
+	"\t}\n"
+	"\n"
+	"\treturn valid;\n"
+	"}\n"
+	"\n"
+	"#endif //LBLMC_BINARY_MATRIX_LOADER\n";
+}
+
+std::string SystemBinaryMatrixGenerator::generateLoadCode(std::string M_name, const std::vector<unsigned long>& dimensions, std::string filename,
+	std::string type_name, std::string prefix)
+{
+	if(M_name.empty())
+		throw std::invalid_argument("SystemBinaryMatrixGenerator::generateLoadCode(): M_name cannot be empty");
+
+	if(dimensions.empty())
+		throw std::invalid_argument("SystemBinaryMatrixGenerator::generateLoadCode(): dimensions cannot be empty");
+
+	std::stringstream sstrm;
+	std::string first_element = M_name;
+	unsigned long count = 1;
+
+	sstrm << prefix << "static " << type_name << " " << M_name;
+
+	for(auto d : dimensions)
+	{
+		sstrm << "[" << d << "]";
+		first_element += "[0]";
+		count *= d;
+	}
+
+	sstrm << ";\n";
+
+		//static initialization runs once, on the first call of the solver; a failed load is reported by
+		//lblmc_binary_matrices_loaded() for the caller to handle
+
+	sstrm
+	<< "static const bool " << M_name << "_loaded = lblmc_load_binary_matrix(LBLMC_BINARY_MATRIX_DIR \"" << filename << "\", &"
+	<< first_element << ", " << count << "ul);\n"
+	<< "(void) " << M_name << "_loaded;\n";
+
+	return sstrm.str();
+}
+
+} //namespace lblmc
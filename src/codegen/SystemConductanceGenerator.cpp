@@ -22,11 +22,16 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 
 
 #include "codegen/SystemConductanceGenerator.hpp"
+#include "codegen/RealLiteralFormatter.hpp"
 
 #include <vector>
 #include <fstream>
+#include <sstream>
 #include <iomanip>
 #include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 #include <Eigen/Dense>
 
@@ -35,22 +40,28 @@ namespace lblmc
 
 //SystemConductanceGenerator::SystemConductanceGenerator() {}
 
-SystemConductanceGenerator::SystemConductanceGenerator(unsigned int dimension):
-	matrix(MatrixRMXd::Zero(dimension,dimension)), dimension(dimension)
+SystemConductanceGenerator::SystemConductanceGenerator(unsigned int dimension, bool sparse_assembly_enable):
+	matrix(sparse_assembly_enable ? MatrixRMXd() : MatrixRMXd::Zero(dimension,dimension)), dimension(dimension),
+	sparse_assembly_enable(sparse_assembly_enable), triplets(),
+	sparse_matrix(sparse_assembly_enable ? dimension : 0, sparse_assembly_enable ? dimension : 0), dense_current(false),
+	switched_conductances(), factorization(std::make_shared<Factorization>())
 {
 	if(dimension == 0)
 		throw std::invalid_argument("SystemConductanceGenerator constructor(): dimension must be nonzero");
 }
 
 SystemConductanceGenerator::SystemConductanceGenerator(unsigned int dimension, const MatrixRMXd& base):
-		matrix(base), dimension(dimension)
+		matrix(base), dimension(dimension), sparse_assembly_enable(false), triplets(), sparse_matrix(), dense_current(false),
+		switched_conductances(), factorization(std::make_shared<Factorization>())
 {
 	if(dimension == 0)
 		throw std::invalid_argument("SystemConductanceGenerator constructor(): dimension must be nonzero");
 }
 
 SystemConductanceGenerator::SystemConductanceGenerator(const SystemConductanceGenerator& base) :
-		matrix(base.matrix), dimension(base.dimension)
+		matrix(base.matrix), dimension(base.dimension), sparse_assembly_enable(base.sparse_assembly_enable),
+		triplets(base.triplets), sparse_matrix(base.sparse_matrix), dense_current(base.dense_current),
+		switched_conductances(base.switched_conductances), factorization(base.factorization)
 {
 	//do nothing else
 }
@@ -60,8 +71,20 @@ void SystemConductanceGenerator::reset(unsigned int dimension)
 	if(dimension == 0)
 		throw std::invalid_argument("SystemConductanceGenerator::reset(): dimension must be nonzero");
 
+	invalidateFactorization();
+
 	this->dimension = dimension;
-	this->matrix.setZero();
+	this->switched_conductances.clear();
+
+	if(sparse_assembly_enable)
+	{
+		triplets.clear();
+		sparse_matrix = SparseMatrixRMXd(dimension, dimension);
+	}
+	else
+	{
+		this->matrix.setZero();
+	}
 }
 
 void SystemConductanceGenerator::reset(unsigned int dimension, const MatrixRMXd& base)
@@ -69,34 +92,153 @@ void SystemConductanceGenerator::reset(unsigned int dimension, const MatrixRMXd&
 	if(dimension == 0)
 		throw std::invalid_argument("SystemConductanceGenerator::reset(): dimension must be nonzero");
 
+	invalidateFactorization();
+
 	this->dimension = dimension;
-	this->matrix = base;
+	this->switched_conductances.clear();
+
+	if(sparse_assembly_enable)
+	{
+		triplets.clear();
+		sparse_matrix = base.sparseView();
+	}
+	else
+	{
+		this->matrix = base;
+	}
 }
 
 void SystemConductanceGenerator::reset(const SystemConductanceGenerator& base)
 {
 	dimension = base.dimension;
 	matrix = base.matrix;
+	sparse_assembly_enable = base.sparse_assembly_enable;
+	triplets = base.triplets;
+	sparse_matrix = base.sparse_matrix;
+	dense_current = base.dense_current;
+	switched_conductances = base.switched_conductances;
+	factorization = base.factorization;
+}
+
+void SystemConductanceGenerator::invalidateFactorization()
+{
+	if(sparse_assembly_enable && dense_current)
+	{
+		matrix.resize(0,0);
+		dense_current = false;
+	}
+
+		//a cache used by this generator alone with nothing computed can be kept, as during stamping
+
+	if(factorization.use_count() == 1 && !factorization->lu && !factorization->sparse_lu) return;
+
+	factorization = std::make_shared<Factorization>();
+}
+
+void SystemConductanceGenerator::assemble() const
+{
+	if(!triplets.empty())
+	{
+		SparseMatrixRMXd stamps(dimension, dimension);
+		stamps.setFromTriplets(triplets.begin(), triplets.end());
+
+		sparse_matrix += stamps;
+
+		triplets.clear();
+		triplets.shrink_to_fit();
+	}
+
+		//stamps that cancel leave exact zeros, which are not part of the sparsity pattern of the matrix
+
+	sparse_matrix.prune([](const Eigen::Index&, const Eigen::Index&, const double& value) { return value != 0.0; });
+}
+
+const MatrixRMXd& SystemConductanceGenerator::denseMatrix() const
+{
+	if(sparse_assembly_enable && !dense_current)
+	{
+		assemble();
+		matrix = MatrixRMXd(sparse_matrix);
+		dense_current = true;
+	}
+
+	return matrix;
+}
+
+void SystemConductanceGenerator::addElement(unsigned int r, unsigned int c, double value)
+{
+	if(sparse_assembly_enable)
+		triplets.emplace_back(r, c, value);
+	else
+		matrix(r,c) += value;
+}
+
+void SystemConductanceGenerator::setElement(unsigned int r, unsigned int c, double value)
+{
+	if(sparse_assembly_enable)
+	{
+		assemble();
+		sparse_matrix.coeffRef(r,c) = value;
+	}
+	else
+	{
+		matrix(r,c) = value;
+	}
+}
+
+void SystemConductanceGenerator::setSparseAssemblyEnable(bool enable)
+{
+	if(enable == sparse_assembly_enable) return;
+
+	if(enable)
+	{
+		sparse_matrix = matrix.sparseView();
+		matrix.resize(0,0);
+	}
+	else
+	{
+		matrix = denseMatrix();
+		triplets.clear();
+		sparse_matrix = SparseMatrixRMXd();
+	}
+
+	sparse_assembly_enable = enable;
+	dense_current = false;
+}
+
+SparseMatrixRMXd SystemConductanceGenerator::asSparseMatrix() const
+{
+	if(!sparse_assembly_enable) return matrix.sparseView();
+
+	assemble();
+
+	return sparse_matrix;
 }
 
 double* SystemConductanceGenerator::asPointer()
 {
+	setSparseAssemblyEnable(false);
+	invalidateFactorization();
 	return matrix.data();
 }
 
 double* SystemConductanceGenerator::asArray()
 {
+	setSparseAssemblyEnable(false);
+	invalidateFactorization();
 	return matrix.data();
 }
 
 MatrixRMXd& SystemConductanceGenerator::asEigen3Matrix()
 {
+	setSparseAssemblyEnable(false);
+	invalidateFactorization();
 	return matrix;
 }
 
 const MatrixRMXd& SystemConductanceGenerator::asEigen3Matrix() const
 {
-	return matrix;
+	return denseMatrix();
 }
 
 unsigned int SystemConductanceGenerator::getDimension() const
@@ -111,19 +253,21 @@ void SystemConductanceGenerator::stampConductance(double conductance, unsigned i
 		throw std::invalid_argument("SystemConductanceGenerator::stampConductance(): given node index/indices are outside dimension of conductance matrix");
 	}
 
+	invalidateFactorization();
+
 	if(p == n) return;
 
 	if( p != 0 && n != 0)
 	{
-		matrix(p-1,p-1) +=  conductance;
-		matrix(p-1,n-1) += -conductance;
-		matrix(n-1,p-1) += -conductance;
-		matrix(n-1,n-1) +=  conductance;
+		addElement(p-1,p-1, conductance);
+		addElement(p-1,n-1, -conductance);
+		addElement(n-1,p-1, -conductance);
+		addElement(n-1,n-1, conductance);
 	}
 	else if (p != 0)
-		matrix(p-1,p-1) += conductance;
+		addElement(p-1,p-1, conductance);
 	else if (n != 0)
-		matrix(n-1,n-1) += conductance;
+		addElement(n-1,n-1, conductance);
 }
 
 void SystemConductanceGenerator::stampTransconductance(double transconductance, unsigned int m, unsigned int n, unsigned int p, unsigned int q)
@@ -133,26 +277,28 @@ void SystemConductanceGenerator::stampTransconductance(double transconductance,
 		throw std::invalid_argument("SystemConductanceGenerator::stampTransconductance(): given node index/indices are outside dimension of conductance matrix");
 	}
 
+	invalidateFactorization();
+
 	if( (m == n) && (m == p) && (m == q) ) return; //component ports are shorted out, so do nothing
 
 	if( (m != 0) && (p != 0) )
 	{
-		matrix(p-1,m-1) += transconductance;
+		addElement(p-1,m-1, transconductance);
 	}
 
 	if( (m != 0) && (q != 0) )
 	{
-		matrix(q-1,m-1) -= transconductance;
+		addElement(q-1,m-1, -transconductance);
 	}
 
 	if( (n != 0) && (p != 0) )
 	{
-		matrix(p-1,n-1) -= transconductance;
+		addElement(p-1,n-1, -transconductance);
 	}
 
 	if( (n != 0) && (q != 0) )
 	{
-		matrix(q-1,n-1) += transconductance;
+		addElement(q-1,n-1, transconductance);
 	}
 
 }
@@ -164,30 +310,32 @@ void SystemConductanceGenerator::stampTransconductance2(double transconductance1
 		throw std::invalid_argument("SystemConductanceGenerator::stampTransconductance2(): given node index/indices are outside dimension of conductance matrix");
 	}
 
+	invalidateFactorization();
+
 	if( (m == n) && (m == p) && (m == q) ) return; //component ports are shorted out, so do nothing
 
 	if( (m != 0) && (p != 0) )
 	{
-		matrix(m-1,p-1) += transconductance12;
-		matrix(p-1,m-1) += transconductance21;
+		addElement(m-1,p-1, transconductance12);
+		addElement(p-1,m-1, transconductance21);
 	}
 
 	if( (m != 0) && (q != 0) )
 	{
-		matrix(m-1,q-1) -= transconductance12;
-		matrix(q-1,m-1) -= transconductance21;
+		addElement(m-1,q-1, -transconductance12);
+		addElement(q-1,m-1, -transconductance21);
 	}
 
 	if( (n != 0) && (p != 0) )
 	{
-		matrix(n-1,p-1) -= transconductance12;
-		matrix(p-1,n-1) -= transconductance21;
+		addElement(n-1,p-1, -transconductance12);
+		addElement(p-1,n-1, -transconductance21);
 	}
 
 	if( (n != 0) && (q != 0) )
 	{
-		matrix(n-1,q-1) += transconductance12;
-		matrix(q-1,n-1) += transconductance21;
+		addElement(n-1,q-1, transconductance12);
+		addElement(q-1,n-1, transconductance21);
 	}
 }
 
@@ -198,8 +346,44 @@ void SystemConductanceGenerator::stampPartialConductance(double conductance, uns
 		throw std::invalid_argument("SystemConductanceGenerator::stampPartialConductance(): given matrix index/indices are outside dimension of conductance matrix");
 	}
 
+	invalidateFactorization();
+
 	if( r != 0 && c != 0)
-		matrix(r-1,c-1) += conductance;
+		addElement(r-1,c-1, conductance);
+}
+
+void SystemConductanceGenerator::stampSwitchedConductance(double on_conductance, double off_conductance, unsigned int p, unsigned int n, std::string state)
+{
+	if(dimension < p || dimension < n || p == n)
+	{
+		throw std::invalid_argument("SystemConductanceGenerator::stampSwitchedConductance(): given node indices must be distinct and inside dimension of conductance matrix");
+	}
+
+	if(on_conductance == off_conductance)
+	{
+		throw std::invalid_argument("SystemConductanceGenerator::stampSwitchedConductance(): on and off conductances must differ");
+	}
+
+	if(state.empty())
+	{
+		throw std::invalid_argument("SystemConductanceGenerator::stampSwitchedConductance(): state must be a valid, non-empty C++ expression");
+	}
+
+	switched_conductances.push_back(SwitchedConductance(p, n, on_conductance, off_conductance, state));
+}
+
+MatrixRMXd SystemConductanceGenerator::asSwitchStateEigen3Matrix(unsigned long switch_state) const
+{
+	SystemConductanceGenerator state_gen(dimension, denseMatrix());
+
+	for(unsigned int s = 0; s < switched_conductances.size(); s++)
+	{
+		const SwitchedConductance& sw = switched_conductances[s];
+
+		state_gen.stampConductance( ((switch_state >> s) & 1ul) ? sw.on_conductance : sw.off_conductance, sw.p, sw.n );
+	}
+
+	return state_gen.matrix;
 }
 
 void SystemConductanceGenerator::stampIdealVoltageSourceIncidence(unsigned int s, unsigned int p, unsigned int n)
@@ -218,38 +402,294 @@ void SystemConductanceGenerator::stampIdealVoltageSourceIncidence(unsigned int s
 
 	if(p == n) return;
 
+	invalidateFactorization();
+
 	if( p != 0 && n != 0)
 	{
-		matrix(s-1,p-1) =  1;
-		matrix(s-1,n-1) = -1;
-		matrix(n-1,s-1) = -1;
-		matrix(p-1,s-1) =  1;
+		setElement(s-1,p-1, 1);
+		setElement(s-1,n-1, -1);
+		setElement(n-1,s-1, -1);
+		setElement(p-1,s-1, 1);
 	}
 	else if (p != 0)
 	{
-		matrix(s-1,p-1) = 1;
-		matrix(p-1,s-1) = 1;
+		setElement(s-1,p-1, 1);
+		setElement(p-1,s-1, 1);
 	}
 	else if (n != 0)
 	{
-		matrix(s-1,n-1) = -1;
-		matrix(n-1,s-1) = -1;
+		setElement(s-1,n-1, -1);
+		setElement(n-1,s-1, -1);
+	}
+}
+
+void SystemConductanceGenerator::factorize() const
+{
+	if(!factorization->lu)
+	{
+		factorization->lu.reset(new Eigen::FullPivLU<MatrixRMXd>(denseMatrix()));
+	}
+}
+
+void SystemConductanceGenerator::factorizeSparse() const
+{
+	if(!factorization->sparse_lu)
+	{
+		factorization->sparse_lu.reset(new Eigen::SparseLU< Eigen::SparseMatrix<double> >());
+		factorization->sparse_lu->compute(asSparseMatrix());
+	}
+}
+
+const Eigen::FullPivLU<MatrixRMXd>& SystemConductanceGenerator::getFactorization() const
+{
+	std::lock_guard<std::mutex> lock(factorization->mutex);
+
+	factorize();
+
+	return *factorization->lu;
+}
+
+const MatrixRMXd& SystemConductanceGenerator::getInverse() const
+{
+	std::lock_guard<std::mutex> lock(factorization->mutex);
+
+	if(!factorization->inverse && sparse_assembly_enable)
+	{
+		factorizeSparse();
+
+		if(factorization->sparse_lu->info() != Eigen::Success)
+		{
+			throw std::runtime_error("SystemConductanceGenerator::getInverse(): cannot invert conductance matrix as it is singular");
+		}
+
+			//sparse LU solves into column-major results only
+
+		Eigen::MatrixXd inverse = factorization->sparse_lu->solve(Eigen::MatrixXd::Identity(dimension, dimension));
+
+		factorization->inverse.reset(new MatrixRMXd(inverse));
+	}
+
+	if(!factorization->inverse)
+	{
+		factorize();
+
+		if(!factorization->lu->isInvertible())
+		{
+			throw std::runtime_error("SystemConductanceGenerator::getInverse(): cannot invert conductance matrix as it is singular");
+		}
+
+		factorization->inverse.reset(new MatrixRMXd(factorization->lu->inverse()));
 	}
+
+	return *factorization->inverse;
+}
+
+MatrixRMXd SystemConductanceGenerator::getSelectedInverse(const std::vector<bool>& rows, const std::vector<bool>& cols, unsigned int num_threads) const
+{
+	std::lock_guard<std::mutex> lock(factorization->mutex);
+
+	factorizeSparse();
+
+	if(factorization->sparse_lu->info() != Eigen::Success)
+	{
+		throw std::runtime_error("SystemConductanceGenerator::getSelectedInverse(): cannot invert conductance matrix as it is singular");
+	}
+
+	std::vector<unsigned int> selected_rows, selected_cols;
+
+	for(unsigned int i = 0; i < dimension; i++)
+	{
+		if(rows.empty() || (i < rows.size() && rows[i])) selected_rows.push_back(i);
+		if(cols.empty() || (i < cols.size() && cols[i])) selected_cols.push_back(i);
+	}
+
+	MatrixRMXd inverse = MatrixRMXd::Zero(dimension, dimension);
+
+	if(selected_rows.empty() || selected_cols.empty()) return inverse;
+
+		//solve columns G*y=e_c of the inverse, or rows (G^T)*y=e_r if fewer, keeping the selected elements of y
+
+	const bool by_rows = selected_rows.size() < selected_cols.size();
+	const std::vector<unsigned int>& solved = by_rows ? selected_rows : selected_cols;
+	const std::vector<unsigned int>& kept = by_rows ? selected_cols : selected_rows;
+
+	Eigen::SparseLU< Eigen::SparseMatrix<double> >& lu = *factorization->sparse_lu;
+
+	const unsigned int block_size = 32;
+	const unsigned int num_blocks = (solved.size() + block_size - 1) / block_size;
+
+	if(num_threads == 0) num_threads = std::max(1u, std::thread::hardware_concurrency());
+	num_threads = std::min(num_threads, num_blocks);
+
+	std::atomic<unsigned int> next_block(0);
+
+	auto solveBlocks = [&]()
+	{
+		Eigen::MatrixXd unit, y;
+
+		for(unsigned int block = next_block++; block < num_blocks; block = next_block++)
+		{
+			const unsigned int begin = block*block_size;
+			const unsigned int count = std::min<unsigned int>(block_size, solved.size() - begin);
+
+			unit = Eigen::MatrixXd::Zero(dimension, count);
+
+			for(unsigned int k = 0; k < count; k++) unit(solved[begin+k], k) = 1.0;
+
+			if(by_rows)
+				y = lu.transpose().solve(unit);
+			else
+				y = lu.solve(unit);
+
+				//each block writes distinct elements of the inverse
+
+			for(unsigned int k = 0; k < count; k++)
+			{
+				for(unsigned int i : kept)
+				{
+					if(by_rows)
+						inverse(solved[begin+k], i) = y(i, k);
+					else
+						inverse(i, solved[begin+k]) = y(i, k);
+				}
+			}
+		}
+	};
+
+	std::vector<std::thread> pool;
+
+	for(unsigned int t = 1; t < num_threads; t++)
+	{
+		pool.emplace_back(solveBlocks);
+	}
+
+	solveBlocks();
+
+	for(std::thread& thread : pool)
+	{
+		thread.join();
+	}
+
+	return inverse;
 }
 
 bool SystemConductanceGenerator::isInvertible() const
 {
-	return matrix.fullPivLu().isInvertible();
+	if(sparse_assembly_enable)
+	{
+		std::lock_guard<std::mutex> lock(factorization->mutex);
+
+		factorizeSparse();
+
+		return factorization->sparse_lu->info() == Eigen::Success;
+	}
+
+	return getFactorization().isInvertible();
+}
+
+std::vector<unsigned int> SystemConductanceGenerator::kronReduce(const std::vector<bool>& eliminated)
+{
+	std::vector<unsigned int> retained_rows, eliminated_rows;
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(r+1 < eliminated.size() && eliminated[r+1])
+			eliminated_rows.push_back(r);
+		else
+			retained_rows.push_back(r);
+	}
+
+	if(retained_rows.empty())
+		throw std::invalid_argument("SystemConductanceGenerator::kronReduce(): cannot eliminate all solutions of the system");
+
+	std::vector<unsigned int> retained;
+	std::vector<unsigned int> reduced_index(dimension+1, 0);
+
+	for(auto r : retained_rows)
+	{
+		retained.push_back(r+1);
+		reduced_index[r+1] = retained.size();
+	}
+
+	for(const auto& sw : switched_conductances)
+	{
+		if( (sw.p != 0 && reduced_index[sw.p] == 0) || (sw.n != 0 && reduced_index[sw.n] == 0) )
+			throw std::invalid_argument("SystemConductanceGenerator::kronReduce(): cannot eliminate solutions connected to switched conductances");
+	}
+
+	if(eliminated_rows.empty()) return retained;
+
+	const unsigned int m = retained_rows.size();
+	const unsigned int e = eliminated_rows.size();
+
+	const MatrixRMXd& G = denseMatrix();
+
+	MatrixRMXd Grr(m, m), Gre(m, e), Ger(e, m), Gee(e, e);
+
+	for(unsigned int i = 0; i < m; i++)
+	{
+		for(unsigned int j = 0; j < m; j++) Grr(i,j) = G(retained_rows[i], retained_rows[j]);
+		for(unsigned int j = 0; j < e; j++) Gre(i,j) = G(retained_rows[i], eliminated_rows[j]);
+	}
+
+	for(unsigned int i = 0; i < e; i++)
+	{
+		for(unsigned int j = 0; j < m; j++) Ger(i,j) = G(eliminated_rows[i], retained_rows[j]);
+		for(unsigned int j = 0; j < e; j++) Gee(i,j) = G(eliminated_rows[i], eliminated_rows[j]);
+	}
+
+	auto Gee_lu = Gee.fullPivLu();
+
+	if(!Gee_lu.isInvertible())
+	{
+		throw std::runtime_error("SystemConductanceGenerator::kronReduce(): cannot reduce conductance matrix as submatrix of eliminated solutions is singular");
+	}
+
+	setSparseAssemblyEnable(false);
+	invalidateFactorization();
+
+	matrix = Grr - Gre * Gee_lu.solve(Ger);
+	dimension = m;
+
+	for(auto& sw : switched_conductances)
+	{
+		sw.p = reduced_index[sw.p];
+		sw.n = reduced_index[sw.n];
+	}
+
+	return retained;
 }
 
 void SystemConductanceGenerator::invertSelf()
 {
-	if(!matrix.fullPivLu().isInvertible())
+	const MatrixRMXd inverse = getInverse();
+
+	invalidateFactorization();
+
+	if(sparse_assembly_enable)
+	{
+		triplets.clear();
+		sparse_matrix = SparseMatrixRMXd();
+		sparse_assembly_enable = false;
+	}
+
+	matrix = inverse;
+}
+
+void SystemConductanceGenerator::invertSelectedSelf(const std::vector<bool>& rows, const std::vector<bool>& cols, unsigned int num_threads)
+{
+	MatrixRMXd inverse = getSelectedInverse(rows, cols, num_threads);
+
+	invalidateFactorization();
+
+	if(sparse_assembly_enable)
 	{
-		throw std::runtime_error("SystemConductanceGenerator::invertSelf(): cannot invert conductance matrix as it is singular");
+		triplets.clear();
+		sparse_matrix = SparseMatrixRMXd();
+		sparse_assembly_enable = false;
 	}
 
-	matrix = matrix.fullPivLu().inverse();
+	matrix.swap(inverse);
 }
 
 SystemConductanceGenerator SystemConductanceGenerator::invert() const
@@ -261,13 +701,15 @@ SystemConductanceGenerator SystemConductanceGenerator::invert() const
 
 std::string SystemConductanceGenerator::spy() const
 {
+	const MatrixRMXd& G = denseMatrix();
+
 	std::string buffer;
 
 	for(unsigned int r = 0; r < dimension; r++)
 	{
 		for(unsigned int c = 0; c < dimension; c++)
 		{
-			if( matrix(r,c)  == 0.0 )
+			if( G(r,c)  == 0.0 )
 				buffer += ". ";
 			else
 				buffer += "X ";
@@ -280,6 +722,8 @@ std::string SystemConductanceGenerator::spy() const
 
 void SystemConductanceGenerator::exportSpy(std::string filename) const
 {
+	const MatrixRMXd& G = denseMatrix();
+
 	std::fstream file;
 
 	try
@@ -295,7 +739,7 @@ void SystemConductanceGenerator::exportSpy(std::string filename) const
 	{
 		for(unsigned int c = 0; c < dimension; c++)
 		{
-			if( matrix(r,c)  == 0.0 )
+			if( G(r,c)  == 0.0 )
 				file << '.';
 			else
 				file << 'X';
@@ -309,6 +753,8 @@ void SystemConductanceGenerator::exportSpy(std::string filename) const
 
 std::string SystemConductanceGenerator::asString() const
 {
+	const MatrixRMXd& G = denseMatrix();
+
 	std::stringstream str;
 
 	str << std::setprecision(16);
@@ -319,7 +765,7 @@ std::string SystemConductanceGenerator::asString() const
 	{
 		for(unsigned int c = 0; c < dimension; c++)
 		{
-			str << "   " << matrix(r,c);
+			str << "   " << G(r,c);
 		}
 		str << "\n";
 	}
@@ -330,6 +776,8 @@ std::string SystemConductanceGenerator::asString() const
 
 void SystemConductanceGenerator::exportAsASCIIMatlab(std::string filename) const
 {
+	const MatrixRMXd& G = denseMatrix();
+
 	std::fstream file;
 
 	try
@@ -349,7 +797,7 @@ void SystemConductanceGenerator::exportAsASCIIMatlab(std::string filename) const
 	{
 		for(unsigned int c = 0; c < dimension; c++)
 		{
-			file << "   " << matrix(r,c);
+			file << "   " << G(r,c);
 		}
 		file << "\n";
 	}
@@ -361,6 +809,8 @@ void SystemConductanceGenerator::exportAsASCIIMatlab(std::string filename) const
 
 void SystemConductanceGenerator::exportAsCSV(std::string filename) const
 {
+	const MatrixRMXd& G = denseMatrix();
+
 	std::fstream file;
 
 	try
@@ -378,11 +828,11 @@ void SystemConductanceGenerator::exportAsCSV(std::string filename) const
 
 	for(unsigned int r = 0; r < dimension; r++)
 	{
-		file << matrix(r,0);
+		file << G(r,0);
 
 		for(unsigned int c = 1; c < dimension; c++)
 		{
-			file << ", " << matrix(r,c);
+			file << ", " << G(r,c);
 		}
 		file << "\n";
 	}
@@ -393,6 +843,8 @@ void SystemConductanceGenerator::exportAsCSV(std::string filename) const
 
 void SystemConductanceGenerator::exportAsCHeader(std::string filename, std::string mat_name) const
 {
+	const MatrixRMXd& G = denseMatrix();
+
 	std::fstream file;
 
 	std::string fname = filename;
@@ -431,11 +883,11 @@ void SystemConductanceGenerator::exportAsCHeader(std::string filename, std::stri
 
 	for(unsigned int r = 0; r < dimension; r++)
 	{
-		file << "{" << matrix(r,0);
+		file << "{" << G(r,0);
 
 		for(unsigned int c = 1; c < dimension; c++)
 		{
-			file << "," << matrix(r,c);
+			file << "," << G(r,c);
 		}
 		file << "}";
 
@@ -455,36 +907,25 @@ void SystemConductanceGenerator::exportAsCHeader(std::string filename, std::stri
 
 std::string SystemConductanceGenerator::asCLiteral(std::string mat_name) const
 {
-	if( mat_name.empty() )
-		throw std::invalid_argument("SystemConductanceGenerator::exportAsCCodeLiteral(): mat_name cannot be empty or null");
-
 	std::stringstream mat;
 
-	mat << std::setprecision(16);
-	mat << std::fixed;
-	mat << std::scientific;
+	asCLiteral(mat, mat_name);
 
-	mat << "const static real " << mat_name << "[" << dimension << "][" << dimension << "] =\n{";
-
-	for(unsigned int r = 0; r < dimension; r++)
-	{
-		mat << "{" << matrix(r,0);
+	return mat.str();
+}
 
-		for(unsigned int c = 1; c < dimension; c++)
-		{
-			mat << "," << matrix(r,c);
-		}
-		mat << "}";
+void SystemConductanceGenerator::asCLiteral(std::ostream& out, std::string mat_name, std::string type_name, unsigned int num_threads) const
+{
+	const MatrixRMXd& G = denseMatrix();
 
-		if(r != dimension-1) mat << ",";
+	if( mat_name.empty() )
+		throw std::invalid_argument("SystemConductanceGenerator::asCLiteral(): mat_name cannot be empty or null");
 
-		mat << "\n";
-	}
+	out << "const static " << type_name << " " << mat_name << "[" << dimension << "][" << dimension << "] =\n{";
 
-	mat << "};\n";
+	RealLiteralFormatter::writeMatrixRows(out, G.data(), dimension, dimension, num_threads);
 
-	std::string buf = mat.str();
-	return buf;
+	out << "};\n";
 }
 
 void SystemConductanceGenerator::importFromASCIIMatlab(std::string filename)
@@ -500,6 +941,7 @@ void SystemConductanceGenerator::importFromASCIIMatlab(std::string filename)
 		throw std::runtime_error("SystemConductanceGenerator::importFromASCIIMatlab(): failed to open or read file");
 	}
 
+	setSparseAssemblyEnable(false);
 	reset(dimension);
 
 	//in a lazy way, we are not checking the matlab file for proper formatting here, so beware!
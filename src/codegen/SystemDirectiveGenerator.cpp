@@ -0,0 +1,182 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/SystemDirectiveGenerator.hpp"
+#include "codegen/SystemStateGenerator.hpp"
+#include "codegen/SystemSplitGenerator.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cstdlib>
+
+namespace lblmc
+{
+
+const unsigned int SystemDirectiveGenerator::MEMORY_PORTS;
+
+const std::string SystemDirectiveGenerator::UNROLL_PLACEHOLDER = "//#unroll";
+
+SystemDirectiveGenerator::SystemDirectiveGenerator() :
+	init_interval(0)
+{}
+
+SystemDirectiveGenerator::SystemDirectiveGenerator(unsigned int init_interval) :
+	init_interval(init_interval)
+{}
+
+unsigned long SystemDirectiveGenerator::getNumberOfBanks(unsigned long accesses, unsigned int ports) const
+{
+	if(init_interval == 0 || ports == 0) return 1;
+
+	const unsigned long accesses_per_bank = (unsigned long)ports*init_interval;
+
+	return accesses <= accesses_per_bank ? 1 : (accesses + accesses_per_bank - 1)/accesses_per_bank;
+}
+
+std::string SystemDirectiveGenerator::generatePipelineCode() const
+{
+	if(init_interval == 0) return "";
+
+	return "#pragma HLS pipeline II=" + std::to_string(init_interval) + "\n";
+}
+
+std::string SystemDirectiveGenerator::generateLoopCode(const std::string& code) const
+{
+		//a pipelined solver unrolls its loops anyway, so the directive only makes it explicit
+
+	const std::string directive = init_interval > 0 ? "#pragma HLS unroll" : "#pragma HLS pipeline II=1";
+
+	std::string result;
+	std::size_t begin = 0;
+	std::size_t found;
+
+	while((found = code.find(UNROLL_PLACEHOLDER, begin)) != std::string::npos)
+	{
+		result.append(code, begin, found - begin);
+		result += directive;
+
+		begin = found + UNROLL_PLACEHOLDER.size();
+	}
+
+	result.append(code, begin, std::string::npos);
+
+	return result;
+}
+
+std::string SystemDirectiveGenerator::generateArrayPartitionCode(const std::string& name, const std::vector<unsigned long>& dimensions,
+	unsigned long accesses, unsigned int ports) const
+{
+	std::stringstream sstrm;
+
+	unsigned long banks = getNumberOfBanks(accesses, ports);
+
+	for(std::size_t d = dimensions.size(); d > 0 && banks > 1; d--)
+	{
+		const unsigned long size = dimensions[d-1];
+
+		if(size <= 1) continue;
+
+		if(banks >= size)
+		{
+			sstrm << "#pragma HLS array_partition variable=" << name << " complete dim=" << d << "\n";
+
+			banks = (banks + size - 1)/size;
+		}
+		else
+		{
+			sstrm << "#pragma HLS array_partition variable=" << name << " cyclic factor=" << banks << " dim=" << d << "\n";
+
+			banks = 1;
+		}
+	}
+
+	return sstrm.str();
+}
+
+std::string SystemDirectiveGenerator::generateInterfaceCode(const std::string& parameter_list, unsigned int iterations) const
+{
+	std::stringstream sstrm;
+
+	for(const auto& parameter : SystemStateGenerator::splitTopLevel(parameter_list, ','))
+	{
+		const std::string port = SystemStateGenerator::trim(parameter);
+
+		if(port.empty()) continue;
+
+		const std::string name = SystemSplitGenerator::findDeclaredName(port);
+		std::vector<std::string> dimensions;
+
+		const std::string head = SystemStateGenerator::stripDimensions(port, dimensions);
+
+		if(!dimensions.empty())
+		{
+			sstrm << "#pragma HLS interface ap_memory port=" << name << "\n";
+
+				//ports of generated dimensions are partitioned; others are left whole
+
+			std::vector<unsigned long> sizes;
+			unsigned long elements = 1;
+
+			for(const auto& dimension : dimensions)
+			{
+				char* end = nullptr;
+				const unsigned long size = std::strtoul(dimension.c_str(), &end, 10);
+
+				if(end == dimension.c_str() || *end != '\0')
+				{
+					sizes.clear();
+					break;
+				}
+
+				sizes.push_back(size);
+				elements *= size;
+			}
+
+				//each iteration accesses one slice of the last dimension, so only the others are partitioned
+
+			if(iterations > 1 && !sizes.empty())
+			{
+				elements /= sizes.back();
+				sizes.pop_back();
+			}
+
+			if(!sizes.empty())
+				sstrm << generateArrayPartitionCode(name, sizes, elements, 1);
+		}
+		else if(head.find_first_of("&*") != std::string::npos && head.compare(0, 6, "const ") != 0)
+		{
+			sstrm << "#pragma HLS interface ap_vld port=" << name << "\n";
+		}
+		else
+		{
+			sstrm << "#pragma HLS interface ap_none port=" << name << "\n";
+		}
+	}
+
+	sstrm << "#pragma HLS interface ap_ctrl_hs port=return\n";
+
+	return sstrm.str();
+}
+
+} //namespace lblmc
@@ -0,0 +1,544 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/SystemLUSolverGenerator.hpp"
+#include "codegen/AdderTreeGenerator.hpp"
+#include "codegen/SystemTableSolverGenerator.hpp"
+
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <set>
+
+#include <Eigen/SparseCore>
+#include <Eigen/OrderingMethods>
+
+namespace lblmc
+{
+
+	//a pivot on the diagonal is kept if it is at least this fraction of the largest candidate in its column,
+	//so that the fill-reducing ordering is preserved unless it is numerically unsafe
+const static double LU_PIVOT_THRESHOLD = 0.1;
+
+SystemLUSolverGenerator::SystemLUSolverGenerator() :
+	lu(), row_order(), col_order(), dimension(0), zero_bound(1.0e-12), adder_tree_fan_in(0), solved(), solution_indices()
+{}
+
+SystemLUSolverGenerator::SystemLUSolverGenerator(const MatrixRMXd& G, double zero_bound) :
+	lu(), row_order(), col_order(), dimension(0), zero_bound(zero_bound), adder_tree_fan_in(0), solved(), solution_indices()
+{
+	factor(G.sparseView());
+}
+
+SystemLUSolverGenerator::SystemLUSolverGenerator(const SparseMatrixRMXd& G, double zero_bound) :
+	lu(), row_order(), col_order(), dimension(0), zero_bound(zero_bound), adder_tree_fan_in(0), solved(), solution_indices()
+{
+	factor(G);
+}
+
+SystemLUSolverGenerator::SystemLUSolverGenerator(const SystemLUSolverGenerator& base) :
+	lu(base.lu), row_order(base.row_order), col_order(base.col_order),
+	dimension(base.dimension), zero_bound(base.zero_bound), adder_tree_fan_in(base.adder_tree_fan_in),
+	solved(base.solved), solution_indices(base.solution_indices)
+{
+	//do nothing else
+}
+
+void SystemLUSolverGenerator::reset(const MatrixRMXd& G, double zero_bound)
+{
+	this->zero_bound = zero_bound;
+	factor(G.sparseView());
+}
+
+void SystemLUSolverGenerator::reset(const SparseMatrixRMXd& G, double zero_bound)
+{
+	this->zero_bound = zero_bound;
+	factor(G);
+}
+
+void SystemLUSolverGenerator::reset(const SystemLUSolverGenerator& base)
+{
+	lu = base.lu;
+	row_order = base.row_order;
+	col_order = base.col_order;
+	dimension = base.dimension;
+	zero_bound = base.zero_bound;
+	adder_tree_fan_in = base.adder_tree_fan_in;
+	solved = base.solved;
+	solution_indices = base.solution_indices;
+}
+
+void SystemLUSolverGenerator::factor(const SparseMatrixRMXd& G)
+{
+	if(G.rows() == 0 || G.rows() != G.cols())
+		throw std::invalid_argument("SystemLUSolverGenerator::factor(): conductance matrix must be square and nonempty");
+
+	dimension = G.rows();
+
+		//fill-reducing symmetric ordering from the nonzero pattern of G
+
+	Eigen::SparseMatrix<double> pattern = G;
+	pattern.prune([](const Eigen::Index&, const Eigen::Index&, const double& value) { return value != 0.0; });
+
+	Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> perm;
+	Eigen::AMDOrdering<int> amd;
+	amd(pattern, perm);
+
+	row_order.resize(dimension);
+	col_order.resize(dimension);
+
+	std::vector<unsigned int> ordered_col(dimension);
+
+	for(unsigned int i = 0; i < dimension; i++)
+	{
+		row_order[i] = perm.indices()(i);
+		col_order[i] = perm.indices()(i);
+		ordered_col[col_order[i]] = i;
+	}
+
+		//rows of the ordered matrix hold only its nonzero elements, and each column the rows holding an element in it
+
+	lu.assign(dimension, std::map<unsigned int, double>());
+	std::vector< std::set<unsigned int> > col_rows(dimension);
+	double max_magnitude = 0.0;
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		for(SparseMatrixRMXd::InnerIterator it(G, row_order[r]); it; ++it)
+		{
+			if(it.value() == 0.0) continue;
+
+			lu[r][ordered_col[it.col()]] = it.value();
+			col_rows[ordered_col[it.col()]].insert(r);
+			max_magnitude = std::max(max_magnitude, std::abs(it.value()));
+		}
+	}
+
+	const double singular_bound =
+		std::numeric_limits<double>::epsilon() * dimension * max_magnitude;
+
+		//right-looking elimination with threshold partial pivoting; exact zeros of the ordered
+		//matrix stay exactly zero unless filled in, so the factors keep the sparsity of the ordering
+
+	for(unsigned int k = 0; k < dimension; k++)
+	{
+		unsigned int pivot_row = k;
+		double pivot_max = 0.0;
+
+		for(auto i = col_rows[k].lower_bound(k); i != col_rows[k].end(); ++i)
+		{
+			if(std::abs(lu[*i][k]) > pivot_max)
+			{
+				pivot_max = std::abs(lu[*i][k]);
+				pivot_row = *i;
+			}
+		}
+
+		if(!(pivot_max > singular_bound))
+		{
+			throw std::runtime_error("SystemLUSolverGenerator::factor(): cannot factor conductance matrix as it is singular");
+		}
+
+		const auto diagonal = lu[k].find(k);
+
+		if(diagonal == lu[k].end() || std::abs(diagonal->second) < LU_PIVOT_THRESHOLD*pivot_max)
+		{
+			for(const auto& element : lu[k]) col_rows[element.first].erase(k);
+			for(const auto& element : lu[pivot_row]) col_rows[element.first].erase(pivot_row);
+
+			lu[k].swap(lu[pivot_row]);
+			std::swap(row_order[k], row_order[pivot_row]);
+
+			for(const auto& element : lu[k]) col_rows[element.first].insert(k);
+			for(const auto& element : lu[pivot_row]) col_rows[element.first].insert(pivot_row);
+		}
+
+		const double pivot = lu[k][k];
+
+		for(auto i = col_rows[k].upper_bound(k); i != col_rows[k].end(); ++i)
+		{
+			double& lik = lu[*i][k];
+
+			if(lik == 0.0) continue;
+
+			const double l = lik / pivot;
+			lik = l;
+
+			for(auto j = lu[k].upper_bound(k); j != lu[k].end(); ++j)
+			{
+				if(j->second == 0.0) continue;
+
+				const auto fill = lu[*i].emplace(j->first, 0.0);
+				if(fill.second) col_rows[j->first].insert(*i);
+
+				fill.first->second -= l*j->second;
+			}
+		}
+	}
+}
+
+unsigned long SystemLUSolverGenerator::getNumberOfLowerNonzeros() const
+{
+	unsigned long count = 0;
+
+	for(unsigned int r = 1; r < dimension; r++)
+	{
+		for(auto e = lu[r].begin(); e != lu[r].lower_bound(r); ++e)
+		{
+			if(isKept(e->second)) count++;
+		}
+	}
+
+	return count;
+}
+
+unsigned long SystemLUSolverGenerator::getNumberOfUpperNonzeros() const
+{
+	unsigned long count = 0;
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		count++; //diagonal is always kept
+
+		for(auto e = lu[r].upper_bound(r); e != lu[r].end(); ++e)
+		{
+			if(isKept(e->second)) count++;
+		}
+	}
+
+	return count;
+}
+
+unsigned long SystemLUSolverGenerator::getNumberOfMultiplyAccumulates() const
+{
+	std::vector<bool> forward_rows, back_rows;
+	findRequiredRows(forward_rows, back_rows);
+
+	unsigned long count = 0;
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(forward_rows[r])
+		{
+			for(auto e = lu[r].begin(); e != lu[r].lower_bound(r); ++e)
+			{
+				if(isKept(e->second)) count++;
+			}
+		}
+
+		if(back_rows[r])
+		{
+			count++; //diagonal is always kept
+
+			for(auto e = lu[r].upper_bound(r); e != lu[r].end(); ++e)
+			{
+				if(isKept(e->second)) count++;
+			}
+		}
+	}
+
+	return count;
+}
+
+void SystemLUSolverGenerator::findRequiredRows(std::vector<bool>& forward_rows, std::vector<bool>& back_rows) const
+{
+	back_rows.assign(dimension, solved.empty());
+	forward_rows.assign(dimension, solved.empty());
+
+	if(solved.empty()) return;
+
+		//back substitution row r reads the solutions of later rows c > r through U
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(solutionIndex(col_order[r]) < solved.size() && solved[solutionIndex(col_order[r])]) back_rows[r] = true;
+
+		if(!back_rows[r]) continue;
+
+		for(auto e = lu[r].upper_bound(r); e != lu[r].end(); ++e)
+		{
+			if(isKept(e->second)) back_rows[e->first] = true;
+		}
+	}
+
+		//forward substitution row r is read by back substitution row r, and reads earlier rows c < r through L
+
+	for(int r = dimension-1; r >= 0; r--)
+	{
+		if(back_rows[r]) forward_rows[r] = true;
+
+		if(!forward_rows[r]) continue;
+
+		for(auto e = lu[r].begin(); e != lu[r].lower_bound(r); ++e)
+		{
+			if(isKept(e->second)) forward_rows[e->first] = true;
+		}
+	}
+}
+
+double SystemLUSolverGenerator::getLargestCoefficientMagnitude() const
+{
+	double magnitude = 0.0;
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		for(const auto& element : lu[r])
+		{
+			if(element.first != r && isKept(element.second)) magnitude = std::max(magnitude, std::abs(element.second));
+		}
+
+		magnitude = std::max(magnitude, std::abs(1.0/lu[r].at(r)));
+	}
+
+	return magnitude;
+}
+
+std::string SystemLUSolverGenerator::generateCInlineCode() const
+{
+	if(dimension == 0)
+		throw std::runtime_error("SystemLUSolverGenerator::generateCInlineCode(): cannot generate code without factored conductance matrix");
+
+	std::string code;
+	AdderTreeGenerator adder_tree(adder_tree_fan_in);
+
+	std::stringstream sstrm;
+	sstrm << std::setprecision(16) << std::fixed << std::scientific;
+
+	std::vector<bool> forward_rows, back_rows;
+	findRequiredRows(forward_rows, back_rows);
+
+	code += "real lu_y[" + std::to_string(dimension) + "];\n\n";
+
+		//forward substitution L*y = P*b
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(!forward_rows[r]) continue;
+
+		std::vector<std::string> terms;
+
+		terms.push_back("b[" + std::to_string(row_order[r]) + "]");
+
+		for(auto e = lu[r].begin(); e != lu[r].lower_bound(r); ++e)
+		{
+			if(!isKept(e->second)) continue;
+
+			sstrm.str("");
+			sstrm << "real(" << -e->second << ")*lu_y[" << e->first << "]";
+			terms.push_back(sstrm.str());
+		}
+
+		code += adder_tree.generateAssignment
+		(
+			"lu_y[" + std::to_string(r) + "]",
+			terms,
+			"lu_y_sum_" + std::to_string(r)
+		);
+	}
+
+	code += "\n";
+
+		//back substitution U*(Q^T*x) = y, written directly into solution vector
+
+	code += "x[0] = 0.0;\n";
+
+	for(int r = dimension-1; r >= 0; r--)
+	{
+		if(!back_rows[r]) continue;
+
+		std::vector<std::string> terms;
+
+		terms.push_back("lu_y[" + std::to_string(r) + "]");
+
+		for(auto e = lu[r].upper_bound(r); e != lu[r].end(); ++e)
+		{
+			if(!isKept(e->second)) continue;
+
+			sstrm.str("");
+			sstrm << "real(" << -e->second << ")*x[" << solutionIndex(col_order[e->first]) << "]";
+			terms.push_back(sstrm.str());
+		}
+
+		std::string sum = adder_tree.generatePartialSums(code, terms, "x_sum_" + std::to_string(solutionIndex(col_order[r])));
+
+		sstrm.str("");
+		sstrm << "x[" << solutionIndex(col_order[r]) << "] = (" << sum << ")*real(" << 1.0/lu[r].at(r) << ");\n";
+		code += sstrm.str();
+	}
+
+	return code;
+}
+
+SystemLUSolverGenerator::Tables SystemLUSolverGenerator::buildTables() const
+{
+	Tables tables;
+
+	std::vector<bool> forward_rows, back_rows;
+	findRequiredRows(forward_rows, back_rows);
+
+	tables.fwd_ptr.push_back(0);
+	tables.bwd_ptr.push_back(0);
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(!forward_rows[r]) continue;
+
+		for(auto e = lu[r].begin(); e != lu[r].lower_bound(r); ++e)
+		{
+			if(!isKept(e->second)) continue;
+
+			tables.fwd_val.push_back(-e->second);
+			tables.fwd_col.push_back(e->first);
+		}
+
+		tables.fwd_ptr.push_back(tables.fwd_val.size());
+		tables.fwd_row.push_back(r);
+		tables.fwd_b.push_back(row_order[r]);
+	}
+
+	for(int r = dimension-1; r >= 0; r--)
+	{
+		if(!back_rows[r]) continue;
+
+		for(auto e = lu[r].upper_bound(r); e != lu[r].end(); ++e)
+		{
+			if(!isKept(e->second)) continue;
+
+			tables.bwd_val.push_back(-e->second);
+			tables.bwd_col.push_back(solutionIndex(col_order[e->first]));
+		}
+
+		tables.bwd_ptr.push_back(tables.bwd_val.size());
+		tables.bwd_row.push_back(r);
+		tables.bwd_x.push_back(solutionIndex(col_order[r]));
+		tables.bwd_diag.push_back(1.0/lu[r].at(r));
+	}
+
+	return tables;
+}
+
+void SystemLUSolverGenerator::generateTableCLiteral(std::ostream& out, std::string type_name) const
+{
+	if(dimension == 0)
+		throw std::runtime_error("SystemLUSolverGenerator::generateTableCLiteral(): cannot generate code without factored conductance matrix");
+
+	const Tables tables = buildTables();
+
+	if(!tables.fwd_row.empty())
+	{
+		if(!tables.fwd_val.empty())
+		{
+			SystemTableSolverGenerator::writeValueTable(out, "lu_fwd_val", tables.fwd_val, type_name);
+			SystemTableSolverGenerator::writeIndexTable(out, "lu_fwd_col", tables.fwd_col);
+			SystemTableSolverGenerator::writeIndexTable(out, "lu_fwd_ptr", tables.fwd_ptr);
+		}
+
+		SystemTableSolverGenerator::writeIndexTable(out, "lu_fwd_row", tables.fwd_row);
+		SystemTableSolverGenerator::writeIndexTable(out, "lu_fwd_b", tables.fwd_b);
+	}
+
+	if(!tables.bwd_row.empty())
+	{
+		if(!tables.bwd_val.empty())
+		{
+			SystemTableSolverGenerator::writeValueTable(out, "lu_bwd_val", tables.bwd_val, type_name);
+			SystemTableSolverGenerator::writeIndexTable(out, "lu_bwd_col", tables.bwd_col);
+			SystemTableSolverGenerator::writeIndexTable(out, "lu_bwd_ptr", tables.bwd_ptr);
+		}
+
+		SystemTableSolverGenerator::writeIndexTable(out, "lu_bwd_row", tables.bwd_row);
+		SystemTableSolverGenerator::writeIndexTable(out, "lu_bwd_x", tables.bwd_x);
+		SystemTableSolverGenerator::writeValueTable(out, "lu_bwd_diag", tables.bwd_diag, type_name);
+	}
+}
+
+std::string SystemLUSolverGenerator::generateTableCInlineCode() const
+{
+	if(dimension == 0)
+		throw std::runtime_error("SystemLUSolverGenerator::generateTableCInlineCode(): cannot generate code without factored conductance matrix");
+
+	const Tables tables = buildTables();
+
+	std::stringstream sstrm;
+
+	sstrm << "real lu_y[" << dimension << "];\n\n";
+
+		//forward substitution L*y = P*b
+
+	if(!tables.fwd_row.empty())
+	{
+		sstrm
+		<< "for(unsigned int table_r = 0; table_r < " << tables.fwd_row.size() << "; table_r++)\n"
+		<< "{\n"
+		<< "\treal table_sum = b[lu_fwd_b[table_r]];\n\n";
+
+		if(!tables.fwd_val.empty())
+		{
+			sstrm
+			<< "\tfor(unsigned int table_k = lu_fwd_ptr[table_r]; table_k < lu_fwd_ptr[table_r+1]; table_k++)\n"
+			<< "\t{\n"
+			<< "\t\ttable_sum += lu_fwd_val[table_k]*lu_y[lu_fwd_col[table_k]];\n"
+			<< "\t}\n\n";
+		}
+
+		sstrm
+		<< "\tlu_y[lu_fwd_row[table_r]] = table_sum;\n"
+		<< "}\n";
+	}
+
+	sstrm << "\n";
+
+		//back substitution U*(Q^T*x) = y, written directly into solution vector
+
+	sstrm << "x[0] = 0.0;\n";
+
+	if(!tables.bwd_row.empty())
+	{
+		sstrm
+		<< "\nfor(unsigned int table_r = 0; table_r < " << tables.bwd_row.size() << "; table_r++)\n"
+		<< "{\n"
+		<< "\treal table_sum = lu_y[lu_bwd_row[table_r]];\n\n";
+
+		if(!tables.bwd_val.empty())
+		{
+			sstrm
+			<< "\tfor(unsigned int table_k = lu_bwd_ptr[table_r]; table_k < lu_bwd_ptr[table_r+1]; table_k++)\n"
+			<< "\t{\n"
+			<< "\t\ttable_sum += lu_bwd_val[table_k]*x[lu_bwd_col[table_k]];\n"
+			<< "\t}\n\n";
+		}
+
+		sstrm
+		<< "\tx[lu_bwd_x[table_r]] = table_sum*lu_bwd_diag[table_r];\n"
+		<< "}\n";
+	}
+
+	return sstrm.str();
+}
+
+} // namespace lblmc
@@ -0,0 +1,554 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/SystemPartitioner.hpp"
+
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <limits>
+#include <map>
+
+namespace lblmc
+{
+
+namespace
+{
+
+/**
+	\brief parameters of components holding the index of an extra solution, renumbered along with the nodes
+**/
+const std::map<std::string, unsigned int> SOLUTION_ID_PARAMETERS =
+{
+	{"IdealVoltageSource", 1},
+	{"IdealFunctionalVoltageSource", 0}
+};
+
+/**
+	\return nodes of a component, along with the index of its extra solution, if any
+**/
+std::vector<unsigned int> findSolutions(const ComponentListing& comp)
+{
+	std::vector<unsigned int> solutions = comp.getTerminalConnections();
+
+	const auto found = SOLUTION_ID_PARAMETERS.find(comp.getType());
+
+	if(found != SOLUTION_ID_PARAMETERS.end() && found->second < comp.getParametersCount())
+	{
+		solutions.push_back((unsigned int)comp.getParameter(found->second));
+	}
+
+	return solutions;
+}
+
+/**
+	\brief components that must be kept in the same subsystem, joined by nodes that cannot be cut
+**/
+struct Block
+{
+	std::vector<unsigned int> components; ///< indices of components in netlist
+	std::vector<unsigned int> nodes; ///< non-ground nodes of the components
+	unsigned long operations; ///< estimated operations of the components
+};
+
+/**
+	\brief score of an assignment of blocks to subsystems, compared lexicographically
+**/
+struct Score
+{
+	unsigned int violations; ///< nodes shared by more than two subsystems, and empty subsystems
+	unsigned long max_operations; ///< largest estimated operations of the subsystems
+	unsigned int ports; ///< number of ports between the subsystems
+};
+
+/**
+	\return estimated operations of the subsystems of an assignment, along with its score
+**/
+Score evaluate
+(
+	const std::vector<Block>& blocks,
+	const std::vector<unsigned int>& assignment,
+	unsigned int num_subsystems,
+	unsigned int num_nodes,
+	std::vector<unsigned long>& operations
+)
+{
+	std::vector<char> touched((num_nodes+1)*num_subsystems, 0);
+	std::vector<unsigned int> owners(num_nodes+1, 0);
+	std::vector<unsigned long> nodes(num_subsystems, 0);
+	std::vector<unsigned int> sizes(num_subsystems, 0);
+
+	operations.assign(num_subsystems, 0);
+
+	for(unsigned int b = 0; b < blocks.size(); b++)
+	{
+		const unsigned int s = assignment[b];
+
+		sizes[s]++;
+		operations[s] += blocks[b].operations;
+
+		for(auto node : blocks[b].nodes)
+		{
+			if(touched[node*num_subsystems + s]) continue;
+
+			touched[node*num_subsystems + s] = 1;
+			nodes[s]++;
+			owners[node]++;
+		}
+	}
+
+	Score score = {0, 0, 0};
+
+	for(unsigned int s = 0; s < num_subsystems; s++)
+	{
+		if(sizes[s] == 0) score.violations++;
+
+		operations[s] += nodes[s]*nodes[s];
+		score.max_operations = std::max(score.max_operations, operations[s]);
+	}
+
+	for(auto count : owners)
+	{
+		if(count > 1) score.ports += count-1;
+		if(count > 2) score.violations += count-2;
+	}
+
+	return score;
+}
+
+/**
+	\return distance of each block from the given blocks, through shared nodes; max unsigned int if unreachable
+**/
+std::vector<unsigned int> findDistances
+(
+	const std::vector<Block>& blocks,
+	const std::vector< std::vector<unsigned int> >& node_blocks,
+	const std::vector<unsigned int>& sources
+)
+{
+	const unsigned int unreachable = std::numeric_limits<unsigned int>::max();
+
+	std::vector<unsigned int> distances(blocks.size(), unreachable);
+	std::queue<unsigned int> frontier;
+
+	for(auto b : sources)
+	{
+		distances[b] = 0;
+		frontier.push(b);
+	}
+
+	while(!frontier.empty())
+	{
+		const unsigned int b = frontier.front();
+		frontier.pop();
+
+		for(auto node : blocks[b].nodes)
+		{
+			for(auto neighbor : node_blocks[node])
+			{
+				if(distances[neighbor] != unreachable) continue;
+
+				distances[neighbor] = distances[b] + 1;
+				frontier.push(neighbor);
+			}
+		}
+	}
+
+	return distances;
+}
+
+} //namespace
+
+SystemPartitioner::SystemPartitioner() :
+	latency_types({"Inductor", "Capacitor", "NortonPort"}),
+	tolerance(0.05),
+	subsystems(),
+	num_ports(0),
+	system_operations(0)
+{}
+
+void SystemPartitioner::setBalanceTolerance(double tolerance)
+{
+	if(tolerance < 0.0)
+		throw std::invalid_argument("SystemPartitioner::setBalanceTolerance(): tolerance cannot be negative");
+
+	this->tolerance = tolerance;
+}
+
+void SystemPartitioner::partition(const Netlist& netlist, unsigned int num_subsystems)
+{
+	if(num_subsystems == 0)
+		throw std::invalid_argument("SystemPartitioner::partition(): num_subsystems must be nonzero");
+
+	const auto& components = netlist.getComponents();
+
+	if(components.empty())
+		throw std::invalid_argument("SystemPartitioner::partition(): netlist has no components");
+
+		//extra solutions of components, such as currents of ideal voltage sources, are handled as nodes
+
+	std::vector< std::vector<unsigned int> > solutions(components.size());
+	unsigned int num_nodes = netlist.getNumberOfNodes();
+
+	for(unsigned int c = 0; c < components.size(); c++)
+	{
+		solutions[c] = findSolutions(components[c]);
+		for(auto node : solutions[c]) num_nodes = std::max(num_nodes, node);
+	}
+
+		//nodes with a latency-providing component can be cut; all other nodes join their components
+
+	std::vector<char> cuttable(num_nodes+1, 0);
+
+	for(const auto& comp : components)
+	{
+		if(std::find(latency_types.begin(), latency_types.end(), comp.getType()) == latency_types.end()) continue;
+
+		for(auto node : comp.getTerminalConnections()) cuttable[node] = 1;
+	}
+
+	std::vector<unsigned int> roots(components.size());
+	std::iota(roots.begin(), roots.end(), 0);
+
+	auto find_root = [&roots](unsigned int c)
+	{
+		while(roots[c] != c)
+		{
+			roots[c] = roots[roots[c]];
+			c = roots[c];
+		}
+		return c;
+	};
+
+	std::vector<unsigned int> node_owner(num_nodes+1, components.size());
+
+	for(unsigned int c = 0; c < components.size(); c++)
+	{
+		for(auto node : solutions[c])
+		{
+			if(node == 0 || cuttable[node]) continue;
+
+			if(node_owner[node] == components.size()) node_owner[node] = c;
+			else roots[find_root(c)] = find_root(node_owner[node]);
+		}
+	}
+
+		//blocks of components joined by uncuttable nodes are moved between subsystems as a whole
+
+	std::vector<Block> blocks;
+	std::vector<unsigned int> block_of(components.size());
+	std::vector<unsigned int> root_block(components.size(), components.size());
+	std::vector<char> used(num_nodes+1, 0);
+
+	for(unsigned int c = 0; c < components.size(); c++)
+	{
+		const unsigned int root = find_root(c);
+
+		if(root_block[root] == components.size())
+		{
+			root_block[root] = blocks.size();
+			blocks.push_back(Block{{}, {}, 0});
+		}
+
+		Block& block = blocks[root_block[root]];
+		block_of[c] = root_block[root];
+		block.components.push_back(c);
+		block.operations += components[c].getTerminalConnectionsCount();
+
+		for(auto node : solutions[c])
+		{
+			if(node == 0) continue;
+
+			used[node] = 1;
+			if(std::find(block.nodes.begin(), block.nodes.end(), node) == block.nodes.end()) block.nodes.push_back(node);
+		}
+	}
+
+	if(blocks.size() < num_subsystems)
+	{
+		throw std::runtime_error("SystemPartitioner::partition(): netlist has " + std::to_string(blocks.size()) +
+			" parts between latency-providing components; cannot partition into " + std::to_string(num_subsystems) + " subsystems");
+	}
+
+	std::vector< std::vector<unsigned int> > node_blocks(num_nodes+1);
+
+	for(unsigned int b = 0; b < blocks.size(); b++)
+	{
+		for(auto node : blocks[b].nodes) node_blocks[node].push_back(b);
+	}
+
+	const unsigned long num_used = std::count(used.begin(), used.end(), 1);
+	unsigned long component_operations = 0;
+
+	for(const auto& block : blocks) component_operations += block.operations;
+
+	system_operations = num_used*num_used + component_operations;
+
+		//grow each subsystem from the block farthest from those already assigned, to its share of the cost
+
+	const unsigned int unassigned = num_subsystems;
+	const double share = double(num_used)/num_subsystems;
+	const double target = share*share + double(component_operations)/num_subsystems;
+
+	std::vector<unsigned int> assignment(blocks.size(), unassigned);
+	std::vector<unsigned int> assigned;
+	unsigned int num_unassigned = blocks.size();
+
+	for(unsigned int s = 0; s < num_subsystems; s++)
+	{
+		if(s == num_subsystems-1)
+		{
+			for(auto& a : assignment) if(a == unassigned) a = s;
+			break;
+		}
+
+		const std::vector<unsigned int> distances = findDistances(blocks, node_blocks, assigned.empty() ? std::vector<unsigned int>{0} : assigned);
+
+			//seeds are the farthest reachable blocks, at a periphery of the network; the first from block 0
+
+		const unsigned int unreachable = std::numeric_limits<unsigned int>::max();
+		unsigned int seed = blocks.size();
+
+		for(unsigned int b = 0; b < blocks.size(); b++)
+		{
+			if(assignment[b] != unassigned) continue;
+
+			if(seed == blocks.size() || (distances[b] != unreachable && (distances[seed] == unreachable || distances[b] > distances[seed]))) seed = b;
+		}
+
+		std::vector<char> inside(num_nodes+1, 0);
+		unsigned long nodes = 0;
+		unsigned long operations = 0;
+
+		auto add = [&](unsigned int b)
+		{
+			assignment[b] = s;
+			assigned.push_back(b);
+			num_unassigned--;
+			operations += blocks[b].operations;
+
+			for(auto node : blocks[b].nodes)
+			{
+				if(inside[node]) continue;
+				inside[node] = 1;
+				nodes++;
+			}
+		};
+
+		add(seed);
+
+		while(num_unassigned > num_subsystems-1-s && operations + nodes*nodes < target)
+		{
+				//add the neighbor sharing the most nodes with the subsystem, then adding the fewest
+
+			unsigned int best = blocks.size();
+			unsigned int best_shared = 0;
+			unsigned int best_added = 0;
+
+			for(unsigned int b = 0; b < blocks.size(); b++)
+			{
+				if(assignment[b] != unassigned) continue;
+
+				unsigned int shared = 0;
+				for(auto node : blocks[b].nodes) shared += inside[node];
+
+				const unsigned int added = blocks[b].nodes.size() - shared;
+
+				if(shared == 0) continue;
+
+				if(best == blocks.size() || shared > best_shared || (shared == best_shared && added < best_added))
+				{
+					best = b;
+					best_shared = shared;
+					best_added = added;
+				}
+			}
+
+			if(best == blocks.size()) break;
+
+			add(best);
+		}
+	}
+
+		//move single blocks between subsystems while the score improves, first for balance, then for ports
+
+	std::vector<unsigned long> operations;
+	Score current = evaluate(blocks, assignment, num_subsystems, num_nodes, operations);
+
+	auto refine = [&](bool (*better)(const Score&, const Score&, unsigned long), unsigned long bound)
+	{
+		bool improved = true;
+
+		while(improved)
+		{
+			improved = false;
+
+			for(unsigned int b = 0; b < blocks.size(); b++)
+			{
+				for(unsigned int s = 0; s < num_subsystems; s++)
+				{
+					const unsigned int previous = assignment[b];
+					if(s == previous) continue;
+
+					assignment[b] = s;
+					const Score score = evaluate(blocks, assignment, num_subsystems, num_nodes, operations);
+
+					if(better(score, current, bound))
+					{
+						current = score;
+						improved = true;
+					}
+					else
+					{
+						assignment[b] = previous;
+					}
+				}
+			}
+		}
+	};
+
+	refine
+	(
+		[](const Score& a, const Score& b, unsigned long)
+		{
+			if(a.violations != b.violations) return a.violations < b.violations;
+			if(a.max_operations != b.max_operations) return a.max_operations < b.max_operations;
+			return a.ports < b.ports;
+		},
+		0
+	);
+
+	refine
+	(
+		[](const Score& a, const Score& b, unsigned long bound)
+		{
+			if(a.violations != b.violations) return a.violations < b.violations;
+			if(a.max_operations > bound) return false;
+			if(a.ports != b.ports) return a.ports < b.ports;
+			return a.max_operations < b.max_operations;
+		},
+		(unsigned long)(current.max_operations*(1.0 + tolerance))
+	);
+
+	current = evaluate(blocks, assignment, num_subsystems, num_nodes, operations);
+
+	if(current.violations > 0)
+	{
+		throw std::runtime_error("SystemPartitioner::partition(): cannot partition netlist into " + std::to_string(num_subsystems) +
+			" subsystems with each cut node shared by two subsystems");
+	}
+
+		//number the ports by their nodes, and renumber the nodes of each subsystem from 1
+
+	std::vector<std::vector<char>> members(num_subsystems, std::vector<char>(num_nodes+1, 0));
+
+	for(unsigned int b = 0; b < blocks.size(); b++)
+	{
+		for(auto node : blocks[b].nodes) members[assignment[b]][node] = 1;
+	}
+
+	std::vector<unsigned int> port_ids(num_nodes+1, 0);
+	num_ports = 0;
+
+	for(unsigned int node = 1; node <= num_nodes; node++)
+	{
+		unsigned int count = 0;
+		for(unsigned int s = 0; s < num_subsystems; s++) count += members[s][node];
+
+		if(count > 1) port_ids[node] = ++num_ports;
+	}
+
+	subsystems.assign(num_subsystems, Subsystem());
+
+	for(unsigned int s = 0; s < num_subsystems; s++)
+	{
+		Subsystem& sub = subsystems[s];
+		std::vector<unsigned int> local(num_nodes+1, 0);
+
+		for(unsigned int node = 1; node <= num_nodes; node++)
+		{
+			if(!members[s][node]) continue;
+
+			sub.nodes.push_back(node);
+			local[node] = sub.nodes.size();
+
+			if(port_ids[node]) sub.ports.push_back(SubsystemSolverEngineGenerator::Port(port_ids[node], local[node], 0));
+		}
+
+		sub.netlist.setModelName(netlist.getModelName() + "_" + std::to_string(s));
+
+		for(unsigned int c = 0; c < components.size(); c++)
+		{
+			if(assignment[block_of[c]] != s) continue;
+
+			std::vector<unsigned int> terminals = components[c].getTerminalConnections();
+			std::vector<double> parameters = components[c].getParameters();
+
+			for(auto& node : terminals) node = local[node];
+
+			const auto found = SOLUTION_ID_PARAMETERS.find(components[c].getType());
+
+			if(found != SOLUTION_ID_PARAMETERS.end() && found->second < parameters.size())
+			{
+				parameters[found->second] = local[(unsigned int)parameters[found->second]];
+			}
+
+			sub.netlist.addComponent
+			(
+				ComponentListing
+				(
+					std::string(components[c].getType()),
+					std::string(components[c].getLabel()),
+					std::move(parameters),
+					std::move(terminals)
+				)
+			);
+		}
+
+		sub.operations = operations[s];
+	}
+}
+
+std::string SystemPartitioner::generateReport() const
+{
+	std::stringstream sstrm;
+
+	sstrm
+	<< "partitioned system into " << subsystems.size() << " subsystems across " << num_ports << " ports:\n"
+	<< "  unpartitioned:        " << system_operations << " MACs per time step (estimated)\n";
+
+	for(const auto& sub : subsystems)
+	{
+		sstrm
+		<< "  " << sub.netlist.getModelName() << ": " << sub.nodes.size() << " nodes, "
+		<< sub.netlist.getComponentsCount() << " components, " << sub.ports.size() << " ports, "
+		<< sub.operations << " MACs per time step (estimated)\n";
+	}
+
+	return sstrm.str();
+}
+
+} // namespace lblmc
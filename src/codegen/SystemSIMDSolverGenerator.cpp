@@ -0,0 +1,305 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/SystemSIMDSolverGenerator.hpp"
+#include "codegen/RealLiteralFormatter.hpp"
+
+#include <string>
+#include <sstream>
+#include <stdexcept>
+
+namespace lblmc
+{
+
+const unsigned int SystemSIMDSolverGenerator::PANEL_HEIGHT;
+
+SystemSIMDSolverGenerator::SystemSIMDSolverGenerator() :
+	M(nullptr), rows(0), cols(0), zero_bound(1.0e-12), solved(), solution_indices(), row_index()
+{}
+
+SystemSIMDSolverGenerator::SystemSIMDSolverGenerator(const double* M, unsigned int rows, unsigned int cols, double zero_bound) :
+	M(M), rows(rows), cols(cols), zero_bound(zero_bound), solved(), solution_indices(), row_index()
+{
+	if(M == nullptr)
+		throw std::invalid_argument("SystemSIMDSolverGenerator::constructor(): matrix M cannot be null");
+
+	if(rows == 0 || cols == 0)
+		throw std::invalid_argument("SystemSIMDSolverGenerator::constructor(): rows and cols must be nonzero");
+
+	updateRowIndex();
+}
+
+SystemSIMDSolverGenerator::SystemSIMDSolverGenerator(const SystemSIMDSolverGenerator& base) :
+	M(base.M), rows(base.rows), cols(base.cols), zero_bound(base.zero_bound),
+	solved(base.solved), solution_indices(base.solution_indices), row_index(base.row_index)
+{
+	//do nothing else
+}
+
+void SystemSIMDSolverGenerator::reset(const double* M, unsigned int rows, unsigned int cols, double zero_bound)
+{
+	if(M == nullptr)
+		throw std::invalid_argument("SystemSIMDSolverGenerator::reset(): matrix M cannot be null");
+
+	if(rows == 0 || cols == 0)
+		throw std::invalid_argument("SystemSIMDSolverGenerator::reset(): rows and cols must be nonzero");
+
+	this->M = M;
+	this->rows = rows;
+	this->cols = cols;
+	this->zero_bound = zero_bound;
+	this->solved.clear();
+	this->solution_indices.clear();
+
+	updateRowIndex();
+}
+
+void SystemSIMDSolverGenerator::reset(const SystemSIMDSolverGenerator& base)
+{
+	M = base.M;
+	rows = base.rows;
+	cols = base.cols;
+	zero_bound = base.zero_bound;
+	solved = base.solved;
+	solution_indices = base.solution_indices;
+	row_index = base.row_index;
+}
+
+void SystemSIMDSolverGenerator::setSolvedSolutions(const std::vector<bool>& solved)
+{
+	this->solved = solved;
+	updateRowIndex();
+}
+
+void SystemSIMDSolverGenerator::setSolutionIndices(const std::vector<unsigned int>& indices)
+{
+	solution_indices = indices;
+	updateRowIndex();
+}
+
+void SystemSIMDSolverGenerator::updateRowIndex()
+{
+	row_index.clear();
+
+	for(unsigned int r = 0; r < rows; r++)
+	{
+		if(solved.empty() || (solutionIndex(r) < solved.size() && solved[solutionIndex(r)])) row_index.push_back(r);
+	}
+}
+
+std::string SystemSIMDSolverGenerator::generateKernelCode()
+{
+	return
+	"#ifndef LBLMC_SIMD_MATVEC_KERNEL\n"
+	"#define LBLMC_SIMD_MATVEC_KERNEL\n"
+	"\n"
+	"#if defined(_MSC_VER)\n"
+	"#define LBLMC_SIMD_ALIGN __declspec(align(64))\n"
+	"#else\n"
+	"#define LBLMC_SIMD_ALIGN __attribute__((aligned(64)))\n"
+	"#endif\n"
+	"\n"
+	"//x[panels*8] = M*v, with M stored as panels of 8 rows, each panel column after column\n"
+	"\n"
+	"template<typename real_m, typename real_v, typename real_x>\n"
+	"inline void lblmc_simd_matvec(const real_m* M, const real_v* v, real_x* x, int panels, int cols)\n"
+	"{\n"
+	"\tfor(int p = 0; p < panels; p++)\n"
+	"\t{\n"
+	"\t\tconst real_m* m = M + p*cols*8;\n"
+	"\n"
+	"\t\treal_x acc[8];\n"
+	"\n"
+	"\t\tfor(int k = 0; k < 8; k++) acc[k] = 0;\n"
+	"\n"
+	"\t\tfor(int c = 0; c < cols; c++)\n"
+	"\t\t{\n"
+	"\t\t\tfor(int k = 0; k < 8; k++) acc[k] = acc[k] + m[c*8+k]*v[c];\n"
+	"\t\t}\n"
+	"\n"
+	"\t\tfor(int k = 0; k < 8; k++) x[p*8+k] = acc[k];\n"
+	"\t}\n"
+	"}\n"
+	"\n"
+	"#if defined(__AVX512F__) || defined(__AVX2__)\n"
+	"\n"
+	"#include <immintrin.h>\n"
+	"\n"
+	"inline void lblmc_simd_matvec(const double* M, const double* v, double* x, int panels, int cols)\n"
+	"{\n"
+	"\tfor(int p = 0; p < panels; p++)\n"
+	"\t{\n"
+	"\t\tconst double* m = M + p*cols*8;\n"
+	"\t\tint c = 0;\n"
+	"\n"
+	"#if defined(__AVX512F__)\n"
+	"\t\t__m512d acc0 = _mm512_setzero_pd();\n"
+	"\t\t__m512d acc1 = _mm512_setzero_pd();\n"
+	"\t\t__m512d acc2 = _mm512_setzero_pd();\n"
+	"\t\t__m512d acc3 = _mm512_setzero_pd();\n"
+	"\n"
+	"\t\tfor(; c+3 < cols; c += 4)\n"
+	"\t\t{\n"
+	"\t\t\tacc0 = _mm512_fmadd_pd(_mm512_load_pd(m + (c+0)*8), _mm512_set1_pd(v[c+0]), acc0);\n"
+	"\t\t\tacc1 = _mm512_fmadd_pd(_mm512_load_pd(m + (c+1)*8), _mm512_set1_pd(v[c+1]), acc1);\n"
+	"\t\t\tacc2 = _mm512_fmadd_pd(_mm512_load_pd(m + (c+2)*8), _mm512_set1_pd(v[c+2]), acc2);\n"
+	"\t\t\tacc3 = _mm512_fmadd_pd(_mm512_load_pd(m + (c+3)*8), _mm512_set1_pd(v[c+3]), acc3);\n"
+	"\t\t}\n"
+	"\t\tfor(; c < cols; c++)\n"
+	"\t\t{\n"
+	"\t\t\tacc0 = _mm512_fmadd_pd(_mm512_load_pd(m + c*8), _mm512_set1_pd(v[c]), acc0);\n"
+	"\t\t}\n"
+	"\n"
+	"\t\t_mm512_store_pd(x + p*8, _mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));\n"
+	"#else\n"
+	"#if defined(__FMA__)\n"
+	"#define LBLMC_SIMD_FMADD_PD(a,b,c) _mm256_fmadd_pd(a,b,c)\n"
+	"#else\n"
+	"#define LBLMC_SIMD_FMADD_PD(a,b,c) _mm256_add_pd(_mm256_mul_pd(a,b),c)\n"
+	"#endif\n"
+	"\t\t__m256d acc0_lo = _mm256_setzero_pd();\n"
+	"\t\t__m256d acc0_hi = _mm256_setzero_pd();\n"
+	"\t\t__m256d acc1_lo = _mm256_setzero_pd();\n"
+	"\t\t__m256d acc1_hi = _mm256_setzero_pd();\n"
+	"\n"
+	"\t\tfor(; c+1 < cols; c += 2)\n"
+	"\t\t{\n"
+	"\t\t\t__m256d v0 = _mm256_set1_pd(v[c+0]);\n"
+	"\t\t\t__m256d v1 = _mm256_set1_pd(v[c+1]);\n"
+	"\t\t\tacc0_lo = LBLMC_SIMD_FMADD_PD(_mm256_load_pd(m + (c+0)*8 + 0), v0, acc0_lo);\n"
+	"\t\t\tacc0_hi = LBLMC_SIMD_FMADD_PD(_mm256_load_pd(m + (c+0)*8 + 4), v0, acc0_hi);\n"
+	"\t\t\tacc1_lo = LBLMC_SIMD_FMADD_PD(_mm256_load_pd(m + (c+1)*8 + 0), v1, acc1_lo);\n"
+	"\t\t\tacc1_hi = LBLMC_SIMD_FMADD_PD(_mm256_load_pd(m + (c+1)*8 + 4), v1, acc1_hi);\n"
+	"\t\t}\n"
+	"\t\tfor(; c < cols; c++)\n"
+	"\t\t{\n"
+	"\t\t\t__m256d v0 = _mm256_set1_pd(v[c]);\n"
+	"\t\t\tacc0_lo = LBLMC_SIMD_FMADD_PD(_mm256_load_pd(m + c*8 + 0), v0, acc0_lo);\n"
+	"\t\t\tacc0_hi = LBLMC_SIMD_FMADD_PD(_mm256_load_pd(m + c*8 + 4), v0, acc0_hi);\n"
+	"\t\t}\n"
+	"\n"
+	"\t\t_mm256_store_pd(x + p*8 + 0, _mm256_add_pd(acc0_lo, acc1_lo));\n"
+	"\t\t_mm256_store_pd(x + p*8 + 4, _mm256_add_pd(acc0_hi, acc1_hi));\n"
+	"#undef LBLMC_SIMD_FMADD_PD\n"
+	"#endif\n"
+	"\t}\n"
+	"}\n"
+	"\n"
+	"#endif //__AVX512F__ || __AVX2__\n"
+	"\n"
+	"#endif //LBLMC_SIMD_MATVEC_KERNEL\n";
+}
+
+std::string SystemSIMDSolverGenerator::generateCLiteral(std::string M_name) const
+{
+	std::stringstream sstrm;
+
+	generateCLiteral(sstrm, M_name);
+
+	return sstrm.str();
+}
+
+std::vector<double> SystemSIMDSolverGenerator::getBlockedMatrix() const
+{
+	if(M == nullptr)
+		throw std::runtime_error("SystemSIMDSolverGenerator::getBlockedMatrix(): cannot block without matrix M");
+
+	const unsigned int panels = getNumberOfPanels();
+
+	std::vector<double> blocked(std::size_t(panels)*cols*PANEL_HEIGHT, 0.0);
+
+	for(unsigned int p = 0; p < panels; p++)
+	{
+		for(unsigned int c = 0; c < cols; c++)
+		{
+			for(unsigned int k = 0; k < PANEL_HEIGHT; k++)
+			{
+				const unsigned int i = p*PANEL_HEIGHT + k;
+
+				if(i >= row_index.size()) continue;
+
+				const double val = M[row_index[i]*cols + c];
+
+				if(val < zero_bound && val > -zero_bound) continue;
+
+				blocked[(std::size_t(p)*cols + c)*PANEL_HEIGHT + k] = val;
+			}
+		}
+	}
+
+	return blocked;
+}
+
+void SystemSIMDSolverGenerator::generateCLiteral(std::ostream& out, std::string M_name, std::string type_name) const
+{
+	if(M == nullptr)
+		throw std::runtime_error("SystemSIMDSolverGenerator::generateCLiteral(): cannot generate literal without matrix M");
+
+	if( M_name.empty() )
+		throw std::invalid_argument("SystemSIMDSolverGenerator::generateCLiteral(): M_name cannot be empty");
+
+	const std::vector<double> blocked = getBlockedMatrix();
+
+	if(blocked.empty()) return;
+
+	char literal[RealLiteralFormatter::MAX_LENGTH];
+
+	out << "LBLMC_SIMD_ALIGN const static " << type_name << " " << M_name << "[" << blocked.size() << "] =\n{\n";
+
+		//one line per panel column
+
+	for(std::size_t i = 0; i < blocked.size(); i++)
+	{
+		out.write(literal, RealLiteralFormatter::format(literal, blocked[i]) - literal);
+
+		if(i != blocked.size()-1) out << ",";
+
+		if((i+1) % PANEL_HEIGHT == 0) out << "\n";
+	}
+
+	out << "};\n";
+}
+
+std::string SystemSIMDSolverGenerator::generateCInlineCode(std::string M_name, std::string v_name) const
+{
+	if(M == nullptr)
+		throw std::runtime_error("SystemSIMDSolverGenerator::generateCInlineCode(): cannot generate code without matrix M");
+
+	std::stringstream sstrm;
+
+	if(row_index.empty()) return "x[0] = 0.0;\n";
+
+	sstrm
+	<< "LBLMC_SIMD_ALIGN real x_simd[" << getPaddedRows() << "];\n\n"
+	<< "lblmc_simd_matvec(" << M_name << ", " << v_name << ", x_simd, " << getNumberOfPanels() << ", " << cols << ");\n\n"
+	<< "x[0] = 0.0;\n";
+
+	for(unsigned int i = 0; i < row_index.size(); i++)
+	{
+		sstrm << "x[" << solutionIndex(row_index[i]) << "] = x_simd[" << i << "];\n";
+	}
+
+	return sstrm.str();
+}
+
+} // namespace lblmc
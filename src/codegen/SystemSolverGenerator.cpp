@@ -22,6 +22,8 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 
 
 #include "codegen/SystemSolverGenerator.hpp"
+#include "codegen/AdderTreeGenerator.hpp"
+#include "codegen/RealLiteralFormatter.hpp"
 #include <string>
 #include <sstream>
 #include <fstream>
@@ -31,17 +33,18 @@ namespace lblmc
 {
 
 SystemSolverGenerator::SystemSolverGenerator() :
-	A(nullptr), dimension(0), num_components(0), zero_bound(1.0e-12)
+	A(nullptr), dimension(0), num_components(0), zero_bound(1.0e-12), adder_tree_fan_in(0)
 {}
 
 SystemSolverGenerator::SystemSolverGenerator(const double* A, unsigned int dimension, unsigned int num_components, double zero_bound) :
-	A(A), dimension(dimension), num_components(num_components), zero_bound(zero_bound)
+	A(A), dimension(dimension), num_components(num_components), zero_bound(zero_bound), adder_tree_fan_in(0)
 {
 	//do nothing else
 }
 
 SystemSolverGenerator::SystemSolverGenerator(const SystemSolverGenerator& base) :
-	A(base.A), dimension(base.dimension), num_components(base.num_components), zero_bound(base.zero_bound)
+	A(base.A), dimension(base.dimension), num_components(base.num_components), zero_bound(base.zero_bound),
+	adder_tree_fan_in(base.adder_tree_fan_in), solved(base.solved), solution_indices(base.solution_indices)
 {
 	//do nothing else
 }
@@ -60,36 +63,165 @@ void SystemSolverGenerator::reset(const SystemSolverGenerator& base)
 	dimension = base.dimension;
 	num_components = base.num_components;
 	zero_bound = base.zero_bound;
+	adder_tree_fan_in = base.adder_tree_fan_in;
+	solved = base.solved;
+	solution_indices = base.solution_indices;
+}
+
+unsigned long SystemSolverGenerator::getNumberOfMultiplyAccumulates() const
+{
+	if(A == nullptr) return 0;
+
+	unsigned long count = 0;
+
+	for(unsigned int i = 0; i < dimension*dimension; i++)
+	{
+		if( isSolved(i/dimension) && !(A[i] < zero_bound && A[i] > -zero_bound) ) count++;
+	}
+
+	return count;
+}
+
+unsigned long SystemSolverGenerator::getNumberOfSourceGainMultiplyAccumulates(const double* K) const
+{
+	if(K == nullptr) return 0;
+
+	unsigned long count = 0;
+
+	for(unsigned int i = 0; i < dimension*num_components; i++)
+	{
+		if( isSolved(i/num_components) && !(K[i] < zero_bound && K[i] > -zero_bound) ) count++;
+	}
+
+	return count;
+}
+
+std::string SystemSolverGenerator::generateSourceGainCLiteral(const double* K, std::string K_name) const
+{
+	std::stringstream mat;
+
+	generateSourceGainCLiteral(mat, K, K_name);
+
+	return mat.str();
+}
+
+void SystemSolverGenerator::generateSourceGainCLiteral(std::ostream& out, const double* K, std::string K_name, std::string type_name,
+	unsigned int num_threads) const
+{
+	if(K == nullptr || dimension == 0)
+		throw std::runtime_error("SystemSolverGenerator::generateSourceGainCLiteral(): cannot generate code without source gain matrix and dimension set");
+
+	if(num_components == 0) return;
+
+	out << "const static " << type_name << " " << K_name << "[" << dimension << "][" << num_components << "] =\n{";
+
+	RealLiteralFormatter::writeMatrixRows(out, K, dimension, num_components, num_threads);
+
+	out << "};\n";
+}
+
+std::string SystemSolverGenerator::generateSourceGainCInlineCode(const double* K, std::string K_name) const
+{
+	if(K == nullptr || dimension == 0)
+		throw std::runtime_error("SystemSolverGenerator::generateSourceGainCInlineCode(): cannot generate code without source gain matrix and dimension set");
+
+	std::string code;
+	AdderTreeGenerator adder_tree(adder_tree_fan_in);
+
+	code += "x[0] = 0.0;\n";
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(!isSolved(r)) continue;
+
+		std::vector<std::string> terms;
+
+		for(unsigned int c = 0; c < num_components; c++)
+		{
+			if( K[num_components*r+c] < zero_bound && K[num_components*r+c] > -zero_bound )
+				continue; // K[r,c] is close to zero, so ignore the term.
+
+			std::stringstream term;
+			term << K_name << "[" << r << "][" << c <<"]*b_components[" << c << "]";
+			terms.push_back(term.str());
+		}
+
+		code += adder_tree.generateAssignment
+		(
+			"x[" + std::to_string(solutionIndex(r)) + "]",
+			terms,
+			"x_sum_" + std::to_string(solutionIndex(r))
+		);
+	}
+
+	return code;
 }
 
 void SystemSolverGenerator::generateCInlineCode(std::string& buffer, const char* A_name)
+{
+	std::stringstream sstrm;
+
+	generateCInlineCode(sstrm, A_name);
+
+	buffer = sstrm.str();
+}
+
+void SystemSolverGenerator::generateCInlineCode(std::ostream& out, const char* A_name) const
 {
 	if(A == nullptr || dimension == 0)
 		throw std::runtime_error("SystemSolverGenerator::generateCInlineCode(): cannot generate code without conductance matrix and dimension set");
 
-	std::stringstream sstrm;
+	out << "x[0] = 0.0;\n";
+
+	AdderTreeGenerator adder_tree(adder_tree_fan_in);
 
-	sstrm << "x[0] = 0.0;\n";
+	if(adder_tree.isEnabled())
+	{
+		for(unsigned int r = 0; r < dimension; r++)
+		{
+			if(!isSolved(r)) continue;
+
+			std::vector<std::string> terms;
+
+			for(unsigned int c = 0; c < dimension; c++)
+			{
+				if( A[dimension*r+c] < zero_bound && A[dimension*r+c] > -zero_bound )
+					continue; // A[r,c] is close to zero, so ignore the term.
+
+				std::stringstream term;
+				term << A_name << "[" << r << "][" << c <<"]*b[" << c << "]";
+				terms.push_back(term.str());
+			}
+
+			std::stringstream target, prefix;
+			target << "x[" << solutionIndex(r) << "]";
+			prefix << "x_sum_" << r+1;
+
+			out << adder_tree.generateAssignment(target.str(), terms, prefix.str());
+		}
+
+		return;
+	}
 
 	for(int r = 0; r < dimension; r++)
 	{
-		sstrm << "x[" << r+1 << "] = ";
+		if(!isSolved(r)) continue;
+
+		out << "x[" << solutionIndex(r) << "] = ";
 		if( !(A[dimension*r+0] < zero_bound && A[dimension*r+0] > -zero_bound) )
-			sstrm << A_name << "[" << r << "][" << int(0) <<"]*b[" << int(0) << "] ";
+			out << A_name << "[" << r << "][" << int(0) <<"]*b[" << int(0) << "] ";
 		else
-			sstrm << "real(0.0) ";
+			out << "real(0.0) ";
 		for(int c = 1; c < dimension; c++)
 		{
 			if( A[dimension*r+c] < zero_bound && A[dimension*r+c] > -zero_bound )
 				continue; // A[r,c] is close to zero, so ignore the term.
 
-			sstrm << "+ " << A_name << "[" << r << "][" << c <<"]*b[" << c << "] ";
+			out << "+ " << A_name << "[" << r << "][" << c <<"]*b[" << c << "] ";
 		}
 
-		sstrm << ";\n";
+		out << ";\n";
 	}
-
-	buffer = sstrm.str();
 }
 
 void SystemSolverGenerator::generateCFunction(std::string& buffer, const char* solver_name,const char* A_name, const char* b_func_name) const
@@ -22,6 +22,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 
 
 #include "codegen/SystemSourceVectorGenerator.hpp"
+#include "codegen/AdderTreeGenerator.hpp"
 
 #include <cstdlib>
 #include <vector>
@@ -101,6 +102,61 @@ const std::vector<long>& SystemSourceVectorGenerator::getSourceNodesById(long so
     return (nodes_iter->second);
 }
 
+MatrixRMXd SystemSourceVectorGenerator::asIncidenceMatrix() const
+{
+	MatrixRMXd incidence = MatrixRMXd::Zero(dimension, src_index);
+
+	for(unsigned int i = 0; i < dimension; i++)
+	{
+		for(const auto& src : vector[i])
+		{
+			if(src >= 0)
+				incidence(i, src-1) += 1.0;
+			else
+				incidence(i, -src-1) -= 1.0;
+		}
+	}
+
+	return incidence;
+}
+
+void SystemSourceVectorGenerator::reduceSolutions(const std::vector<unsigned int>& retained)
+{
+	std::vector<unsigned int> renumbered(dimension+1, 0);
+
+	for(unsigned int r = 0; r < retained.size(); r++)
+	{
+		if(retained[r] == 0 || retained[r] > dimension)
+			throw std::invalid_argument("SystemSourceVectorGenerator::reduceSolutions(): retained solution index is out of bounds");
+
+		renumbered[retained[r]] = r+1;
+	}
+
+	for(unsigned int i = 0; i < dimension; i++)
+	{
+		if(renumbered[i+1] == 0 && !vector[i].empty())
+			throw std::invalid_argument("SystemSourceVectorGenerator::reduceSolutions(): cannot eliminate solution with contributing sources");
+	}
+
+	std::vector<std::vector<long> > reduced(retained.size());
+
+	for(unsigned int r = 0; r < retained.size(); r++)
+	{
+		reduced[r] = vector[retained[r]-1];
+	}
+
+	for(auto& source : source_nodes)
+	{
+		for(auto& node : source.second)
+		{
+			if(node > 0 && (unsigned long)node <= dimension) node = renumbered[node];
+		}
+	}
+
+	vector = reduced;
+	dimension = retained.size();
+}
+
 unsigned int SystemSourceVectorGenerator::insertSource(unsigned int npos, unsigned int nneg)
 {
 	if(npos == nneg) return 0;
@@ -109,11 +165,11 @@ unsigned int SystemSourceVectorGenerator::insertSource(unsigned int npos, unsign
 
 	if(npos != 0)
 	{
-		vector[npos-1].push_back(+src_index);
+		vector[npos-1].push_back(+long(src_index));
 	}
 	if(nneg != 0)
 	{
-		vector[nneg-1].push_back(-src_index);
+		vector[nneg-1].push_back(-long(src_index));
 	}
 
 	source_nodes[src_index].push_back(npos);
@@ -315,6 +371,45 @@ std::string SystemSourceVectorGenerator::asCInlineCode() const
 	return sstrm.str();
 }
 
+std::string SystemSourceVectorGenerator::asCInlineCode(unsigned int adder_tree_fan_in) const
+{
+	AdderTreeGenerator adder_tree(adder_tree_fan_in);
+
+	if(!adder_tree.isEnabled())
+	{
+		return asCInlineCode();
+	}
+
+	std::string code;
+
+	for(unsigned int i = 0; i < dimension; i++)
+	{
+		if(vector[i].empty())
+		{
+			code += "b[" + std::to_string(i) + "] = 0.0;\n";
+			continue;
+		}
+
+		std::vector<std::string> terms;
+
+		for(const auto& src : vector[i])
+		{
+			if(src >= 0)
+			{
+				terms.push_back("b_components[" + std::to_string(long(abs(src)-1)) + "]");
+			}
+			else
+			{
+				terms.push_back("-b_components[" + std::to_string(long(abs(src)-1)) + "]");
+			}
+		}
+
+		code += adder_tree.generateAssignment("b[" + std::to_string(i) + "]", terms, "b_sum_" + std::to_string(i));
+	}
+
+	return code;
+}
+
 void SystemSourceVectorGenerator::exportAsCFunctionSource(const char* filename, const char* func_name) const
 {
 	std::fstream file;
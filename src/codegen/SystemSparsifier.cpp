@@ -0,0 +1,144 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/SystemSparsifier.hpp"
+
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+namespace lblmc
+{
+
+SystemSparsifier::SystemSparsifier(const MatrixRMXd& M, const std::vector<double>& input_magnitudes, double zero_bound) :
+	matrix(M), input_magnitudes(input_magnitudes), row_error_bounds(M.rows(), 0.0), row_magnitudes(M.rows(), 0.0),
+	num_original_nonzeros(0), num_removed(0), error_budget(0.0), relative(false)
+{
+	if(input_magnitudes.size() != (std::size_t)M.cols())
+		throw std::invalid_argument("SystemSparsifier::constructor(): input_magnitudes must have an element for each column of M");
+
+	for(auto mag : input_magnitudes)
+	{
+		if(mag < 0.0)
+			throw std::invalid_argument("SystemSparsifier::constructor(): input_magnitudes cannot be negative");
+	}
+
+	for(unsigned int r = 0; r < matrix.rows(); r++)
+	{
+		for(unsigned int c = 0; c < matrix.cols(); c++)
+		{
+			if(matrix(r,c) < zero_bound && matrix(r,c) > -zero_bound) matrix(r,c) = 0.0;
+
+			if(matrix(r,c) != 0.0) num_original_nonzeros++;
+
+			row_magnitudes[r] += std::abs(matrix(r,c))*input_magnitudes[c];
+		}
+	}
+}
+
+void SystemSparsifier::sparsify(double error_budget, bool relative)
+{
+	if(error_budget < 0.0)
+		throw std::invalid_argument("SystemSparsifier::sparsify(): error_budget cannot be negative");
+
+	this->error_budget = error_budget;
+	this->relative = relative;
+
+	std::vector< std::pair<double, unsigned int> > terms;
+
+	for(unsigned int r = 0; r < matrix.rows(); r++)
+	{
+		const double budget = relative ? error_budget*row_magnitudes[r] : error_budget;
+
+		terms.clear();
+
+		for(unsigned int c = 0; c < matrix.cols(); c++)
+		{
+			if(matrix(r,c) == 0.0) continue;
+
+			terms.push_back(std::make_pair(std::abs(matrix(r,c))*input_magnitudes[c], c));
+		}
+
+			//dropping the smallest error terms first removes the most elements within the budget
+
+		std::sort(terms.begin(), terms.end());
+
+		double error = row_error_bounds[r];
+
+		for(const auto& term : terms)
+		{
+			if(error + term.first > budget) break;
+
+			error += term.first;
+			matrix(r, term.second) = 0.0;
+			num_removed++;
+		}
+
+		row_error_bounds[r] = error;
+	}
+}
+
+double SystemSparsifier::getErrorBound() const
+{
+	double bound = 0.0;
+
+	for(auto e : row_error_bounds)
+	{
+		bound = std::max(bound, e);
+	}
+
+	return bound;
+}
+
+double SystemSparsifier::getRelativeErrorBound() const
+{
+	double bound = 0.0;
+
+	for(unsigned int r = 0; r < row_error_bounds.size(); r++)
+	{
+		if(row_magnitudes[r] > 0.0) bound = std::max(bound, row_error_bounds[r]/row_magnitudes[r]);
+	}
+
+	return bound;
+}
+
+std::string SystemSparsifier::generateReport() const
+{
+	std::stringstream sstrm;
+
+	const unsigned long total = (unsigned long)matrix.rows()*matrix.cols();
+	const unsigned long kept = num_original_nonzeros - num_removed;
+
+	sstrm
+	<< "sparsified solve matrix (" << (relative ? "relative" : "absolute") << " error budget " << error_budget << "):\n"
+	<< "  nonzeros:             " << kept << " of " << num_original_nonzeros << " kept (" << num_removed << " MACs removed)\n"
+	<< "  density:              " << (total ? 100.0*kept/total : 0.0) << "%\n"
+	<< "  worst-case error:     " << getErrorBound() << " absolute, " << getRelativeErrorBound() << " relative\n";
+
+	return sstrm.str();
+}
+
+} // namespace lblmc
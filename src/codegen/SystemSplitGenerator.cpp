@@ -0,0 +1,379 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/SystemSplitGenerator.hpp"
+#include "codegen/SystemStateGenerator.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+#include <cctype>
+#include <algorithm>
+#include <utility>
+
+namespace lblmc
+{
+
+const std::string SystemSplitGenerator::ARGUMENTS = "args";
+
+SystemSplitGenerator::SystemSplitGenerator() :
+	function_size(65536), parts(), declarations(), literal_definitions(), literal_declarations()
+{}
+
+SystemSplitGenerator::SystemSplitGenerator(unsigned long function_size) :
+	function_size(65536), parts(), declarations(), literal_definitions(), literal_declarations()
+{
+	reset(function_size);
+}
+
+void SystemSplitGenerator::reset(unsigned long function_size)
+{
+	if(function_size == 0)
+		throw std::invalid_argument("SystemSplitGenerator::reset(): function_size must be nonzero");
+
+	this->function_size = function_size;
+
+	parts.clear();
+	declarations.clear();
+	literal_definitions.clear();
+	literal_declarations.clear();
+}
+
+void SystemSplitGenerator::insertCode(const std::string& code)
+{
+	if(SystemStateGenerator::trim(code).empty()) return;
+
+		//a unit larger than the function size makes a part of its own
+
+	if(parts.empty() || (!parts.back().empty() && parts.back().size() + code.size() > function_size))
+	{
+		parts.emplace_back();
+	}
+
+	parts.back() += code;
+	parts.back() += "\n";
+}
+
+void SystemSplitGenerator::insertStatements(const std::string& code)
+{
+	for(const auto& statement : SystemStateGenerator::splitTopLevel(code, ';'))
+	{
+		const std::string stmt = SystemStateGenerator::trim(statement);
+
+		if(SystemStateGenerator::trim(SystemStateGenerator::stripComments(stmt)).empty()) continue;
+
+		insertCode(stmt + ";");
+	}
+}
+
+void SystemSplitGenerator::insertDeclarations(const std::string& code)
+{
+	for(const auto& statement : SystemStateGenerator::splitTopLevel(SystemStateGenerator::stripComments(code), ';'))
+	{
+		const std::string decl = SystemStateGenerator::trim(statement);
+		if(decl.empty()) continue;
+
+		declarations.push_back(decl + ";");
+	}
+}
+
+void SystemSplitGenerator::insertArguments(const std::string& parameter_list)
+{
+	for(const auto& parameter : SystemStateGenerator::splitTopLevel(parameter_list, ','))
+	{
+		if(SystemStateGenerator::trim(parameter).empty()) continue;
+
+		declarations.push_back(generateArgumentMember(parameter) + " = " + ARGUMENTS + "->" + findDeclaredName(parameter) + ";");
+	}
+}
+
+void SystemSplitGenerator::insertLiterals(const std::string& code)
+{
+	for(const auto& statement : SystemStateGenerator::splitTopLevel(SystemStateGenerator::stripComments(code), ';'))
+	{
+		const std::string decl = SystemStateGenerator::trim(statement);
+		if(decl.empty() || decl.compare(0, 6, "(void)") == 0) continue;
+
+		const std::size_t eq = decl.find('=');
+		const std::string head = SystemStateGenerator::trim(eq == std::string::npos ? decl : decl.substr(0, eq));
+
+			//the static specifier is dropped from the definition and kept by the member declaration
+
+		std::istringstream words(head);
+		std::string definition;
+		std::string declaration;
+		std::string token;
+		bool is_static = false;
+
+		while(words >> token)
+		{
+			const bool static_token = token == "static";
+			is_static = is_static || static_token;
+
+			declaration += (declaration.empty() ? "" : " ") + token;
+			if(!static_token) definition += (definition.empty() ? "" : " ") + token;
+		}
+
+		if(!is_static)
+			throw std::runtime_error("SystemSplitGenerator::insertLiterals(): cannot move literal out of the step: " + decl.substr(0, 80));
+
+		if(eq != std::string::npos) definition += " " + decl.substr(eq);
+
+			//the definition is split before the name, where it is qualified by the class holding the parts
+
+		const std::size_t name_begin = definition.rfind(findDeclaredName(head), std::min(definition.find('='), definition.find('[')));
+
+		literal_definitions.push_back(std::make_pair(definition.substr(0, name_begin), definition.substr(name_begin) + ";"));
+		literal_declarations.push_back(declaration + ";");
+	}
+}
+
+std::string SystemSplitGenerator::extractDeclarations(std::string& code, const std::unordered_set<std::string>& names)
+{
+	const std::vector<std::string> statements = SystemStateGenerator::splitTopLevel(code, ';');
+	std::string kept;
+	std::string extracted;
+
+	for(std::size_t i = 0; i < statements.size(); i++)
+	{
+		const std::string& statement = statements[i];
+		const std::string separator = i+1 < statements.size() ? ";" : "";
+
+			//a declaration begins a statement, or follows the last block of one, as in "if(c) {...} real a = b"
+
+		const std::size_t block_end = statement.rfind('}');
+		const std::size_t begin = block_end == std::string::npos ? 0 : block_end + 1;
+		const std::string decl = SystemStateGenerator::trim(SystemStateGenerator::stripComments(statement.substr(begin)));
+
+		const std::size_t eq = decl.find('=');
+		const std::string declarator = SystemStateGenerator::trim(eq == std::string::npos ? decl : decl.substr(0, eq));
+		const std::string name = findDeclaredName(declarator);
+
+		std::vector<std::string> dimensions;
+		std::istringstream words(SystemStateGenerator::stripDimensions(declarator, dimensions));
+		std::vector<std::string> tokens;
+		std::string token;
+
+		while(words >> token) tokens.push_back(token);
+
+			//only plain declarations "type name", "type name[N]", or "type name = value" are extracted, not
+			//statements such as "return name", nor constants or arrays with initializers
+
+		bool is_declaration = tokens.size() == 2 && tokens[1] == name && names.count(name) != 0 &&
+			(eq == std::string::npos || dimensions.empty());
+
+		for(const auto& t : tokens)
+		{
+			is_declaration = is_declaration && t != "return" && t != "else" && t != "goto" && t != "const" && t != "static" &&
+				std::all_of(t.begin(), t.end(), [](char c) { return std::isalnum((unsigned char)c) || c == '_'; });
+		}
+
+		if(!is_declaration)
+		{
+			kept += statement + separator;
+			continue;
+		}
+
+			//the declaration is dropped, and an initializer is kept as an assignment
+
+		extracted += declarator + ";\n";
+
+		kept += statement.substr(0, begin);
+
+		if(eq != std::string::npos) kept += "\n" + name + " " + decl.substr(eq) + separator;
+	}
+
+	code = kept;
+
+	return extracted;
+}
+
+std::string SystemSplitGenerator::generateDeclarationCode(unsigned int part) const
+{
+	std::unordered_set<std::string> words = findWords(getPartCode(part));
+	const std::vector<bool> selected = selectDeclarations(declarations, words);
+
+	std::string code;
+
+	for(unsigned int i = 0; i < declarations.size(); i++)
+	{
+		if(selected[i]) code += declarations[i] + "\n";
+	}
+
+	return code;
+}
+
+std::string SystemSplitGenerator::generateLiteralMemberCode() const
+{
+	std::string code;
+
+	for(const auto& declaration : literal_declarations)
+	{
+		code += declaration + "\n";
+	}
+
+	return code;
+}
+
+std::string SystemSplitGenerator::generateLiteralDefinitionCode(const std::string& template_head, const std::string& scope) const
+{
+	std::string code;
+
+	for(const auto& definition : literal_definitions)
+	{
+		code += template_head + definition.first + scope + "::" + definition.second + "\n";
+	}
+
+	return code;
+}
+
+std::vector<bool> SystemSplitGenerator::selectDeclarations(const std::vector<std::string>& candidates, std::unordered_set<std::string>& words)
+{
+		//declarations only refer to earlier ones, so one pass from the last declaration selects all needed
+
+	std::vector<bool> selected(candidates.size(), false);
+
+	for(std::size_t i = candidates.size(); i-- > 0; )
+	{
+		if(words.count(findDeclaredName(candidates[i])) == 0) continue;
+
+		selected[i] = true;
+
+		const std::unordered_set<std::string> referenced = findWords(candidates[i]);
+		words.insert(referenced.begin(), referenced.end());
+	}
+
+	return selected;
+}
+
+std::string SystemSplitGenerator::generateArgumentsStruct(const std::string& struct_name, const std::string& parameter_list)
+{
+	std::stringstream sstrm;
+
+	sstrm
+	<< "struct " << struct_name << "\n"
+	<< "{\n";
+
+	for(const auto& parameter : SystemStateGenerator::splitTopLevel(parameter_list, ','))
+	{
+		if(SystemStateGenerator::trim(parameter).empty()) continue;
+
+		sstrm << "\t" << generateArgumentMember(parameter) << ";\n";
+	}
+
+	sstrm
+	<< "};\n";
+
+	return sstrm.str();
+}
+
+std::string SystemSplitGenerator::generateArgumentMember(const std::string& parameter)
+{
+	const std::string name = findDeclaredName(parameter);
+	std::vector<std::string> dimensions;
+
+	const std::string head = SystemStateGenerator::stripDimensions(parameter, dimensions);
+	const std::string type = SystemStateGenerator::trim(head.substr(0, head.rfind(name)));
+
+	std::stringstream sstrm;
+
+	if(dimensions.size() == 1)
+	{
+		sstrm << type << "* " << name;
+	}
+	else if(!dimensions.empty())
+	{
+		sstrm << type << " (*" << name << ")";
+		for(unsigned int k = 1; k < dimensions.size(); k++) sstrm << "[" << dimensions[k] << "]";
+	}
+	else if(!type.empty() && type.back() == '&')
+	{
+		sstrm << type << " " << name;
+	}
+	else
+	{
+		sstrm << type << "& " << name;
+	}
+
+	return sstrm.str();
+}
+
+std::vector<std::string> SystemSplitGenerator::findArgumentNames(const std::string& parameter_list)
+{
+	std::vector<std::string> names;
+
+	for(const auto& parameter : SystemStateGenerator::splitTopLevel(parameter_list, ','))
+	{
+		if(SystemStateGenerator::trim(parameter).empty()) continue;
+
+		names.push_back(findDeclaredName(parameter));
+	}
+
+	return names;
+}
+
+std::string SystemSplitGenerator::findDeclaredName(const std::string& declaration)
+{
+	const std::size_t end_of_declarator = std::min(declaration.find('='), declaration.find(';'));
+	std::vector<std::string> dimensions;
+
+	const std::string head = SystemStateGenerator::stripDimensions(declaration.substr(0, end_of_declarator), dimensions);
+
+		//the name is the last word of the declarator, as in "real (&x)" of a bound array
+
+	std::size_t end = head.size();
+
+	while(end > 0 && !(std::isalnum((unsigned char)head[end-1]) || head[end-1] == '_')) end--;
+
+	std::size_t begin = end;
+
+	while(begin > 0 && (std::isalnum((unsigned char)head[begin-1]) || head[begin-1] == '_')) begin--;
+
+	return head.substr(begin, end-begin);
+}
+
+std::unordered_set<std::string> SystemSplitGenerator::findWords(const std::string& code)
+{
+	std::unordered_set<std::string> words;
+	std::string word;
+
+	for(char c : code)
+	{
+		if(std::isalnum((unsigned char)c) || c == '_')
+		{
+			word += c;
+		}
+		else if(!word.empty())
+		{
+			words.insert(word);
+			word.clear();
+		}
+	}
+
+	if(!word.empty()) words.insert(word);
+
+	return words;
+}
+
+} //namespace lblmc
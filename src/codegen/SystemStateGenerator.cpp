@@ -0,0 +1,315 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/SystemStateGenerator.hpp"
+
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <cctype>
+
+namespace lblmc
+{
+
+const std::string SystemStateGenerator::STATE = "state";
+
+SystemStateGenerator::SystemStateGenerator() :
+	fields(), local_code()
+{}
+
+void SystemStateGenerator::reset()
+{
+	fields.clear();
+	local_code.clear();
+}
+
+std::string SystemStateGenerator::trim(const std::string& str)
+{
+	std::size_t begin = 0;
+	std::size_t end = str.size();
+
+	while(begin < end && std::isspace((unsigned char)str[begin])) begin++;
+	while(end > begin && std::isspace((unsigned char)str[end-1])) end--;
+
+	return str.substr(begin, end-begin);
+}
+
+std::vector<std::string> SystemStateGenerator::splitTopLevel(const std::string& code, char delimiter)
+{
+	std::vector<std::string> parts;
+	std::string part;
+	int depth = 0;
+
+	for(char c : code)
+	{
+		if(c == '(' || c == '[' || c == '{') depth++;
+		if(c == ')' || c == ']' || c == '}') depth--;
+
+		if(c == delimiter && depth == 0)
+		{
+			parts.push_back(part);
+			part.clear();
+			continue;
+		}
+
+		part += c;
+	}
+
+	parts.push_back(part);
+
+	return parts;
+}
+
+std::string SystemStateGenerator::stripComments(const std::string& code)
+{
+	std::string stripped;
+
+	for(std::size_t i = 0; i < code.size(); i++)
+	{
+		if(code.compare(i, 2, "//") == 0)
+		{
+			i = code.find('\n', i);
+			if(i == std::string::npos) break;
+		}
+		else if(code.compare(i, 2, "/*") == 0)
+		{
+			i = code.find("*/", i+2);
+			if(i == std::string::npos) break;
+			i++;
+			continue;
+		}
+
+		stripped += code[i];
+	}
+
+	return stripped;
+}
+
+std::string SystemStateGenerator::stripDimensions(const std::string& declarator, std::vector<std::string>& dimensions)
+{
+		//split "type name[A][B]" into "type name" and dimensions A, B
+
+	std::string head = trim(declarator);
+	dimensions.clear();
+
+	while(!head.empty() && head.back() == ']')
+	{
+		const std::size_t open = head.rfind('[');
+		if(open == std::string::npos) break;
+
+		dimensions.insert(dimensions.begin(), trim(head.substr(open+1, head.size()-open-2)));
+		head = trim(head.substr(0, open));
+	}
+
+	return head;
+}
+
+void SystemStateGenerator::insertFields(const std::string& code, bool hold_locals)
+{
+	for(const auto& statement : splitTopLevel(stripComments(code), ';'))
+	{
+		const std::string decl = trim(statement);
+		if(decl.empty()) continue;
+
+		const std::size_t eq = decl.find('=');
+		std::vector<std::string> dimensions;
+		std::string head = stripDimensions(eq == std::string::npos ? decl : decl.substr(0, eq), dimensions);
+
+		std::istringstream words(head);
+		std::vector<std::string> tokens;
+		std::string token;
+		bool is_static = false;
+
+		while(words >> token)
+		{
+			if(token == "static") is_static = true;
+			else if(token != "const") tokens.push_back(token);
+		}
+
+		if(tokens.size() < 2 || head.find(',') != std::string::npos)
+			throw std::runtime_error("SystemStateGenerator::insertFields(): cannot parse field declaration: " + decl);
+
+		if(!is_static && !hold_locals)
+		{
+			local_code += decl + ";\n";
+			continue;
+		}
+
+		Field field;
+		field.name = tokens.back();
+		tokens.pop_back();
+
+		for(const auto& t : tokens)
+		{
+			field.type += (field.type.empty() ? "" : " ") + t;
+		}
+
+		field.dimensions = dimensions;
+		field.initializer = eq == std::string::npos ? std::string() : trim(decl.substr(eq+1));
+
+		fields.push_back(field);
+	}
+}
+
+void SystemStateGenerator::insertVariable(const std::string& type, const std::string& name, const std::vector<std::string>& dimensions)
+{
+	Field field;
+	field.type = type;
+	field.name = name;
+	field.dimensions = dimensions;
+
+	fields.push_back(field);
+}
+
+std::string SystemStateGenerator::generateStateStruct(const std::string& struct_name, bool templated_real) const
+{
+	std::stringstream sstrm;
+
+	if(templated_real)
+	{
+		sstrm << "template<typename real>\n";
+	}
+
+	sstrm
+	<< "struct " << struct_name << "\n"
+	<< "{\n";
+
+	for(const auto& field : fields)
+	{
+		sstrm << "\t" << field.type << " " << field.name;
+		for(const auto& d : field.dimensions) sstrm << "[" << d << "]";
+		sstrm << ";\n";
+	}
+
+	sstrm
+	<< "};\n";
+
+	return sstrm.str();
+}
+
+std::string SystemStateGenerator::generateInitializationCode() const
+{
+	std::stringstream sstrm;
+
+	for(const auto& field : fields)
+	{
+		const std::string member = STATE + "->" + field.name;
+
+		if(field.dimensions.empty())
+		{
+			sstrm << member << " = " << (field.initializer.empty() ? "0" : field.initializer) << ";\n";
+			continue;
+		}
+
+			//arrays are set element by element, from a copy of their initializer if any
+
+		std::string element = member;
+		std::string value = "0";
+
+		if(!field.initializer.empty())
+		{
+			value = field.name + "_init";
+
+			sstrm << "{\n" << "const " << field.type << " " << value;
+			for(const auto& d : field.dimensions) sstrm << "[" << d << "]";
+			sstrm << " = " << field.initializer << ";\n";
+		}
+
+		for(unsigned int k = 0; k < field.dimensions.size(); k++)
+		{
+			const std::string index = "k" + std::to_string(k);
+			sstrm << "for(int " << index << " = 0; " << index << " < " << field.dimensions[k] << "; " << index << "++)\n";
+			element += "[" + index + "]";
+			if(!field.initializer.empty()) value += "[" + index + "]";
+		}
+
+		sstrm << element << " = " << value << ";\n";
+
+		if(!field.initializer.empty())
+		{
+			sstrm << "}\n";
+		}
+	}
+
+	return sstrm.str();
+}
+
+std::string SystemStateGenerator::generateInitializerList() const
+{
+	std::stringstream sstrm;
+
+	sstrm << "{\n";
+
+		//zero initialized scalars are given 0, as C++03 allows no empty braces for them
+
+	for(unsigned int i = 0; i < fields.size(); i++)
+	{
+		const std::string zero = fields[i].dimensions.empty() ? "0" : "{}";
+
+		sstrm << "\t" << (fields[i].initializer.empty() ? zero : fields[i].initializer);
+		sstrm << (i+1 < fields.size() ? ",\n" : "\n");
+	}
+
+	sstrm << "}";
+
+	return sstrm.str();
+}
+
+std::string SystemStateGenerator::generateStaticDeclarations() const
+{
+	std::stringstream sstrm;
+
+	for(const auto& field : fields)
+	{
+		sstrm << "static " << field.type << " " << field.name;
+		for(const auto& d : field.dimensions) sstrm << "[" << d << "]";
+		if(!field.initializer.empty()) sstrm << " = " << field.initializer;
+		sstrm << ";\n";
+	}
+
+	return sstrm.str();
+}
+
+std::string SystemStateGenerator::generateBindingCode() const
+{
+	std::stringstream sstrm;
+
+	for(const auto& field : fields)
+	{
+		if(field.dimensions.empty())
+		{
+			sstrm << field.type << "& " << field.name;
+		}
+		else
+		{
+			sstrm << field.type << " (&" << field.name << ")";
+			for(const auto& d : field.dimensions) sstrm << "[" << d << "]";
+		}
+
+		sstrm << " = " << STATE << "->" << field.name << ";\n";
+	}
+
+	return sstrm.str();
+}
+
+} //namespace lblmc
@@ -0,0 +1,447 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/SystemSwitchBankGenerator.hpp"
+#include "codegen/SystemSolverGenerator.hpp"
+#include "codegen/RealLiteralFormatter.hpp"
+
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+namespace lblmc
+{
+
+const unsigned int SystemSwitchBankGenerator::MAX_SWITCHES;
+
+SystemSwitchBankGenerator::SystemSwitchBankGenerator() :
+	dimension(0), zero_bound(1.0e-12), memory_budget(0), switches(), base_state(0),
+	bank_states(), bank_inverses(), bank_magnitudes(), correction_gains(), correction_coupling(),
+	num_singular_states(0), adder_tree_fan_in(0), solved(), solution_indices()
+{}
+
+SystemSwitchBankGenerator::SystemSwitchBankGenerator(const SystemConductanceGenerator& cond_gen, unsigned long memory_budget, double zero_bound) :
+	dimension(0), zero_bound(zero_bound), memory_budget(memory_budget), switches(), base_state(0),
+	bank_states(), bank_inverses(), bank_magnitudes(), correction_gains(), correction_coupling(),
+	num_singular_states(0), adder_tree_fan_in(0), solved(), solution_indices()
+{
+	reset(cond_gen, memory_budget, zero_bound);
+}
+
+void SystemSwitchBankGenerator::reset(const SystemConductanceGenerator& cond_gen, unsigned long memory_budget, double zero_bound)
+{
+	if(cond_gen.getNumberOfSwitches() == 0)
+		throw std::invalid_argument("SystemSwitchBankGenerator::reset(): system has no switched conductances");
+
+	if(cond_gen.getNumberOfSwitches() > MAX_SWITCHES)
+		throw std::invalid_argument("SystemSwitchBankGenerator::reset(): system has more switched conductances than MAX_SWITCHES");
+
+	this->dimension = cond_gen.getDimension();
+	this->zero_bound = zero_bound;
+	this->memory_budget = memory_budget;
+	this->switches = cond_gen.getSwitchedConductances();
+	this->bank_states.clear();
+	this->bank_inverses.clear();
+	this->num_singular_states = 0;
+
+	const unsigned int num_switches = switches.size();
+	const unsigned long long num_states = 1ull << num_switches;
+	const unsigned long long all_on = num_states - 1;
+	const unsigned long entry_size = dimension*dimension*sizeof(double);
+	const unsigned long capacity = std::max(1ul, memory_budget / entry_size);
+
+		//base state is all switches on, which connects the most nodes, unless singular
+
+	if(!bankState(cond_gen, all_on) && !bankState(cond_gen, 0))
+	{
+		throw std::runtime_error("SystemSwitchBankGenerator::reset(): cannot bank inverses as conductance matrices of all switches on and all off are singular");
+	}
+
+	base_state = bank_states.front();
+
+		//bank further states by number of switches that differ from base state, enumerating the
+		//differing switch sets of each size in increasing order (Gosper's hack)
+
+	for(unsigned int d = 1; d <= num_switches && bank_states.size() < capacity; d++)
+	{
+		unsigned long long diff = (1ull << d) - 1;
+
+		while(diff < num_states && bank_states.size() < capacity)
+		{
+			const unsigned long long state = base_state ^ diff;
+
+			if(!(base_state == 0 && state == all_on)) //all switches on was found singular already
+			{
+				bankState(cond_gen, state);
+			}
+
+			const unsigned long long lowest = diff & (~diff + 1);
+			const unsigned long long ripple = diff + lowest;
+			diff = ripple | (((diff ^ ripple) >> 2) / lowest);
+		}
+	}
+
+	bank_magnitudes = MatrixRMXd::Zero(dimension, dimension);
+
+	for(const auto& inverse : bank_inverses)
+	{
+		bank_magnitudes = bank_magnitudes.cwiseMax(inverse.cwiseAbs());
+	}
+
+		//Z = G0^-1*U and U^T*Z of base state for the correction of unbanked states
+
+	const MatrixRMXd& base_inverse = bank_inverses.front();
+
+	correction_gains = MatrixRMXd::Zero(dimension, num_switches);
+
+	for(unsigned int s = 0; s < num_switches; s++)
+	{
+		if(switches[s].p != 0) correction_gains.col(s) += base_inverse.col(switches[s].p-1);
+		if(switches[s].n != 0) correction_gains.col(s) -= base_inverse.col(switches[s].n-1);
+	}
+
+	correction_coupling = MatrixRMXd::Zero(num_switches, num_switches);
+
+	for(unsigned int s = 0; s < num_switches; s++)
+	{
+		if(switches[s].p != 0) correction_coupling.row(s) += correction_gains.row(switches[s].p-1);
+		if(switches[s].n != 0) correction_coupling.row(s) -= correction_gains.row(switches[s].n-1);
+	}
+}
+
+bool SystemSwitchBankGenerator::bankState(const SystemConductanceGenerator& cond_gen, unsigned long state)
+{
+	auto lu = cond_gen.asSwitchStateEigen3Matrix(state).fullPivLu();
+
+	if(!lu.isInvertible())
+	{
+		num_singular_states++;
+		return false;
+	}
+
+	bank_states.push_back(state);
+	bank_inverses.push_back(lu.inverse());
+
+	return true;
+}
+
+unsigned long SystemSwitchBankGenerator::getNumberOfMultiplyAccumulates() const
+{
+	unsigned long count = 0;
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(!isSolved(r)) continue;
+
+		for(unsigned int c = 0; c < dimension; c++)
+		{
+			if(bank_magnitudes(r,c) >= zero_bound) count++;
+		}
+	}
+
+	return count;
+}
+
+double SystemSwitchBankGenerator::getLargestCoefficientMagnitude() const
+{
+	double magnitude = bank_magnitudes.size() ? bank_magnitudes.maxCoeff() : 0.0;
+
+	if(isComplete()) return magnitude;
+
+	if(correction_gains.size()) magnitude = std::max(magnitude, correction_gains.cwiseAbs().maxCoeff());
+	if(correction_coupling.size()) magnitude = std::max(magnitude, correction_coupling.cwiseAbs().maxCoeff());
+
+	for(unsigned int s = 0; s < switches.size(); s++)
+	{
+		const double dg = switches[s].on_conductance - switches[s].off_conductance;
+
+		if(dg != 0.0) magnitude = std::max(magnitude, std::abs(1.0/dg));
+	}
+
+	return magnitude;
+}
+
+std::string SystemSwitchBankGenerator::generateCLiteral(std::string bank_name) const
+{
+	std::stringstream mat;
+
+	generateCLiteral(mat, bank_name);
+
+	return mat.str();
+}
+
+void SystemSwitchBankGenerator::generateCLiteral(std::ostream& out, std::string bank_name, std::string type_name, unsigned int num_threads) const
+{
+	if(bank_states.empty())
+		throw std::runtime_error("SystemSwitchBankGenerator::generateCLiteral(): cannot generate code without banked inverses");
+
+	const unsigned int num_switches = switches.size();
+
+	out << "const static " << type_name << " " << bank_name << "[" << bank_states.size() << "][" << dimension << "][" << dimension << "] =\n{\n";
+
+	for(unsigned int k = 0; k < bank_states.size(); k++)
+	{
+		out << "{ //switch state " << bank_states[k] << "\n";
+
+		RealLiteralFormatter::writeMatrixRows(out, bank_inverses[k].data(), dimension, dimension, num_threads);
+
+		out << "}";
+
+		if(k != bank_states.size()-1) out << ",";
+
+		out << "\n";
+	}
+
+	out << "};\n";
+
+	if(isComplete()) return;
+
+		//correction of unbanked states
+
+	std::vector<unsigned int> rows;
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(isSolved(r)) rows.push_back(r);
+	}
+
+	out << "\nconst static " << type_name << " " << bank_name << "_z[" << rows.size() << "][" << num_switches << "] =\n{";
+
+	MatrixRMXd solved_gains(rows.size(), num_switches);
+
+	for(unsigned int i = 0; i < rows.size(); i++)
+	{
+		solved_gains.row(i) = correction_gains.row(rows[i]);
+	}
+
+	RealLiteralFormatter::writeMatrixRows(out, solved_gains.data(), rows.size(), num_switches, 1);
+
+	out << "};\n";
+
+	out << "\nconst static " << type_name << " " << bank_name << "_w[" << num_switches << "][" << num_switches << "] =\n{";
+
+	RealLiteralFormatter::writeMatrixRows(out, correction_coupling.data(), num_switches, num_switches, 1);
+
+	out << "};\n";
+
+	out << "\nconst static unsigned int " << bank_name << "_p[" << num_switches << "] = {";
+
+	for(unsigned int s = 0; s < num_switches; s++)
+	{
+		out << (s ? "," : "") << (switches[s].p ? solutionIndex(switches[s].p-1) : 0);
+	}
+
+	out << "};\n";
+
+	out << "const static unsigned int " << bank_name << "_n[" << num_switches << "] = {";
+
+	for(unsigned int s = 0; s < num_switches; s++)
+	{
+		out << (s ? "," : "") << (switches[s].n ? solutionIndex(switches[s].n-1) : 0);
+	}
+
+	out << "};\n";
+
+		//inverse of the change of each switch's conductance from its base state
+
+	out << "const static " << type_name << " " << bank_name << "_dg_inv[" << num_switches << "] = {";
+
+	for(unsigned int s = 0; s < num_switches; s++)
+	{
+		const bool base_on = (base_state >> s) & 1ul;
+		const double dg = base_on ?
+			switches[s].off_conductance - switches[s].on_conductance :
+			switches[s].on_conductance - switches[s].off_conductance;
+
+		out << (s ? "," : "") << RealLiteralFormatter::format(1.0/dg);
+	}
+
+	out << "};\n";
+
+	out << "const static unsigned int " << bank_name << "_x[" << rows.size() << "] = {";
+
+	for(unsigned int i = 0; i < rows.size(); i++)
+	{
+		out << (i ? "," : "") << solutionIndex(rows[i]);
+	}
+
+	out << "};\n";
+}
+
+std::string SystemSwitchBankGenerator::generateCInlineCode(std::string bank_name) const
+{
+	if(bank_states.empty())
+		throw std::runtime_error("SystemSwitchBankGenerator::generateCInlineCode(): cannot generate code without banked inverses");
+
+	const unsigned int num_switches = switches.size();
+	const bool complete = isComplete();
+
+	std::stringstream sstrm;
+
+		//pack switch states and select bank entry
+
+	sstrm << "unsigned int sw_state = 0;\n";
+
+	for(unsigned int s = 0; s < num_switches; s++)
+	{
+		sstrm << "if(" << switches[s].state << ") sw_state |= " << (1ul << s) << "u;\n";
+	}
+
+	sstrm << "\nunsigned int sw_entry = 0;\n";
+
+	if(!complete) sstrm << "bool sw_banked = true;\n";
+
+	sstrm << "\nswitch(sw_state)\n{\n";
+
+	for(unsigned int k = 0; k < bank_states.size(); k++)
+	{
+		sstrm << "\tcase " << bank_states[k] << "u: sw_entry = " << k << "; break;\n";
+	}
+
+	if(complete)
+		sstrm << "\tdefault: break; //singular states are left to base state entry 0\n";
+	else
+		sstrm << "\tdefault: sw_banked = false; break; //corrected from base state entry 0 below\n";
+
+	sstrm << "}\n\n";
+
+		//solve with the selected inverse, keeping terms that are nonzero in any banked inverse
+
+	SystemSolverGenerator solver_gen(bank_magnitudes.data(), dimension, 0, zero_bound);
+	solver_gen.setAdderTreeFanIn(adder_tree_fan_in);
+	solver_gen.setSolvedSolutions(solved);
+	solver_gen.setSolutionIndices(solution_indices);
+
+	std::string buf;
+	const std::string entry_name = bank_name + "[sw_entry]";
+	solver_gen.generateCInlineCode(buf, entry_name.c_str());
+
+	sstrm << buf;
+
+	if(complete) return sstrm.str();
+
+	unsigned int num_rows = 0;
+
+	for(unsigned int r = 0; r < dimension; r++)
+	{
+		if(isSolved(r)) num_rows++;
+	}
+
+	const std::string S = std::to_string(num_switches);
+
+	sstrm
+	<< "\nif(!sw_banked)\n"
+	<< "{\n"
+	<< "\t\t//low-rank (Woodbury) correction of base state solution for the switches differing from base state\n\n"
+	<< "\tunsigned int sw_flip[" << S << "];\n"
+	<< "\treal sw_y[" << S << "];\n"
+	<< "\treal sw_c[" << S << "][" << S << "];\n"
+	<< "\tunsigned int sw_k = 0;\n\n"
+	<< "\tfor(unsigned int s = 0; s < " << S << "; s++)\n"
+	<< "\t{\n"
+	<< "\t\tif( ((sw_state ^ " << base_state << "u) >> s) & 1u )\n"
+	<< "\t\t{\n"
+	<< "\t\t\tsw_flip[sw_k] = s;\n"
+	<< "\t\t\tsw_k++;\n"
+	<< "\t\t}\n"
+	<< "\t}\n\n"
+	<< "\tfor(unsigned int i = 0; i < sw_k; i++)\n"
+	<< "\t{\n"
+	<< "\t\tsw_y[i] = x[" << bank_name << "_p[sw_flip[i]]] - x[" << bank_name << "_n[sw_flip[i]]];\n\n"
+	<< "\t\tfor(unsigned int j = 0; j < sw_k; j++)\n"
+	<< "\t\t{\n"
+	<< "\t\t\tsw_c[i][j] = " << bank_name << "_w[sw_flip[i]][sw_flip[j]];\n"
+	<< "\t\t}\n\n"
+	<< "\t\tsw_c[i][i] += " << bank_name << "_dg_inv[sw_flip[i]];\n"
+	<< "\t}\n\n"
+	<< "\t\t//solve sw_c*sw_y = U^T*x by Gaussian elimination with partial pivoting\n\n"
+	<< "\tfor(unsigned int k = 0; k < sw_k; k++)\n"
+	<< "\t{\n"
+	<< "\t\tunsigned int pivot = k;\n\n"
+	<< "\t\tfor(unsigned int i = k+1; i < sw_k; i++)\n"
+	<< "\t\t{\n"
+	<< "\t\t\tconst real c_ik = sw_c[i][k] < real(0.0) ? real(-sw_c[i][k]) : sw_c[i][k];\n"
+	<< "\t\t\tconst real c_pk = sw_c[pivot][k] < real(0.0) ? real(-sw_c[pivot][k]) : sw_c[pivot][k];\n\n"
+	<< "\t\t\tif(c_ik > c_pk) pivot = i;\n"
+	<< "\t\t}\n\n"
+	<< "\t\tfor(unsigned int j = 0; j < sw_k; j++)\n"
+	<< "\t\t{\n"
+	<< "\t\t\tconst real t = sw_c[k][j];\n"
+	<< "\t\t\tsw_c[k][j] = sw_c[pivot][j];\n"
+	<< "\t\t\tsw_c[pivot][j] = t;\n"
+	<< "\t\t}\n\n"
+	<< "\t\tconst real t = sw_y[k];\n"
+	<< "\t\tsw_y[k] = sw_y[pivot];\n"
+	<< "\t\tsw_y[pivot] = t;\n\n"
+	<< "\t\tfor(unsigned int i = k+1; i < sw_k; i++)\n"
+	<< "\t\t{\n"
+	<< "\t\t\tconst real l = sw_c[i][k] / sw_c[k][k];\n\n"
+	<< "\t\t\tfor(unsigned int j = k+1; j < sw_k; j++)\n"
+	<< "\t\t\t{\n"
+	<< "\t\t\t\tsw_c[i][j] -= l*sw_c[k][j];\n"
+	<< "\t\t\t}\n\n"
+	<< "\t\t\tsw_y[i] -= l*sw_y[k];\n"
+	<< "\t\t}\n"
+	<< "\t}\n\n"
+	<< "\tfor(unsigned int k = sw_k; k > 0; k--)\n"
+	<< "\t{\n"
+	<< "\t\tfor(unsigned int j = k; j < sw_k; j++)\n"
+	<< "\t\t{\n"
+	<< "\t\t\tsw_y[k-1] -= sw_c[k-1][j]*sw_y[j];\n"
+	<< "\t\t}\n\n"
+	<< "\t\tsw_y[k-1] = sw_y[k-1] / sw_c[k-1][k-1];\n"
+	<< "\t}\n\n"
+	<< "\tfor(unsigned int r = 0; r < " << num_rows << "; r++)\n"
+	<< "\t{\n"
+	<< "\t\tfor(unsigned int i = 0; i < sw_k; i++)\n"
+	<< "\t\t{\n"
+	<< "\t\t\tx[" << bank_name << "_x[r]] -= " << bank_name << "_z[r][sw_flip[i]]*sw_y[i];\n"
+	<< "\t\t}\n"
+	<< "\t}\n"
+	<< "}\n";
+
+	return sstrm.str();
+}
+
+std::string SystemSwitchBankGenerator::generateReport() const
+{
+	std::stringstream sstrm;
+
+	sstrm
+	<< "switch-state inverse bank (" << switches.size() << " switches, " << getNumberOfStates() << " states):\n"
+	<< "  banked states:        " << bank_states.size() << " (base state " << base_state << ")\n"
+	<< "  bank memory:          " << getBankMemory() << " bytes of " << memory_budget << " byte budget\n"
+	<< "  singular states:      " << num_singular_states << " found while banking\n"
+	<< "  banked solve:         " << getNumberOfMultiplyAccumulates() << " MACs per step\n";
+
+	if(isComplete())
+		sstrm << "  unbanked states:      none\n";
+	else
+		sstrm << "  unbanked states:      corrected from base state by a run-time k by k solve, k switches differing\n";
+
+	return sstrm.str();
+}
+
+} // namespace lblmc
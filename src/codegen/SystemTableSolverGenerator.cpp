@@ -0,0 +1,270 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/SystemTableSolverGenerator.hpp"
+#include "codegen/RealLiteralFormatter.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+namespace lblmc
+{
+
+const unsigned int SystemTableSolverGenerator::ELL_MAX_PADDING_PERCENT;
+
+SystemTableSolverGenerator::SystemTableSolverGenerator() :
+	rows(0), cols(0), zero_bound(1.0e-12), values(), columns(), row_offsets(1, 0), row_solutions()
+{}
+
+SystemTableSolverGenerator::SystemTableSolverGenerator(const double* M, unsigned int rows, unsigned int cols, double zero_bound,
+	const std::vector<bool>& solved, const std::vector<unsigned int>& solution_indices) :
+	rows(0), cols(0), zero_bound(1.0e-12), values(), columns(), row_offsets(1, 0), row_solutions()
+{
+	reset(M, rows, cols, zero_bound, solved, solution_indices);
+}
+
+void SystemTableSolverGenerator::reset(const double* M, unsigned int rows, unsigned int cols, double zero_bound,
+	const std::vector<bool>& solved, const std::vector<unsigned int>& solution_indices)
+{
+	if(M == nullptr)
+		throw std::invalid_argument("SystemTableSolverGenerator::reset(): matrix M cannot be null");
+
+	if(rows == 0 || cols == 0)
+		throw std::invalid_argument("SystemTableSolverGenerator::reset(): rows and cols must be nonzero");
+
+	this->rows = rows;
+	this->cols = cols;
+	this->zero_bound = zero_bound;
+
+	values.clear();
+	columns.clear();
+	row_offsets.assign(1, 0);
+	row_solutions.clear();
+
+	for(unsigned int r = 0; r < rows; r++)
+	{
+		const unsigned int solution = solution_indices.empty() ? r+1 : solution_indices[r];
+
+		if(!solved.empty() && !(solution < solved.size() && solved[solution])) continue;
+
+		const double* row = M + std::size_t(r)*cols;
+
+		for(unsigned int c = 0; c < cols; c++)
+		{
+			if(row[c] < zero_bound && row[c] > -zero_bound) continue; // M[r,c] is close to zero, so ignore the term.
+
+			values.push_back(row[c]);
+			columns.push_back(c);
+		}
+
+		row_offsets.push_back(values.size());
+		row_solutions.push_back(solution);
+	}
+}
+
+unsigned int SystemTableSolverGenerator::getLongestRowLength() const
+{
+	unsigned int length = 0;
+
+	for(unsigned int i = 0; i < row_solutions.size(); i++)
+	{
+		length = std::max(length, getRowLength(i));
+	}
+
+	return length;
+}
+
+SystemTableSolverGenerator::Format SystemTableSolverGenerator::getFormat() const
+{
+	const unsigned long padded = (unsigned long)getLongestRowLength()*row_solutions.size();
+
+	return padded*100 <= values.size()*(100 + ELL_MAX_PADDING_PERCENT) ? ELL : CSR;
+}
+
+std::vector<double> SystemTableSolverGenerator::getValueTable() const
+{
+	if(getFormat() == CSR) return values;
+
+	const unsigned int num_rows = row_solutions.size();
+
+	std::vector<double> table(std::size_t(getLongestRowLength())*num_rows, 0.0);
+
+	for(unsigned int i = 0; i < num_rows; i++)
+	{
+		for(unsigned int k = 0; k < getRowLength(i); k++)
+		{
+			table[std::size_t(k)*num_rows + i] = values[row_offsets[i] + k];
+		}
+	}
+
+	return table;
+}
+
+std::vector<unsigned int> SystemTableSolverGenerator::getColumnTable() const
+{
+	if(getFormat() == CSR) return columns;
+
+	const unsigned int num_rows = row_solutions.size();
+
+	std::vector<unsigned int> table(std::size_t(getLongestRowLength())*num_rows, 0);
+
+	for(unsigned int i = 0; i < num_rows; i++)
+	{
+		for(unsigned int k = 0; k < getRowLength(i); k++)
+		{
+			table[std::size_t(k)*num_rows + i] = columns[row_offsets[i] + k];
+		}
+	}
+
+	return table;
+}
+
+void SystemTableSolverGenerator::generateValueCLiteral(std::ostream& out, std::string M_name, std::string type_name) const
+{
+	if( M_name.empty() )
+		throw std::invalid_argument("SystemTableSolverGenerator::generateValueCLiteral(): M_name cannot be empty");
+
+	if(values.empty()) return;
+
+	writeValueTable(out, M_name + "_val", getValueTable(), type_name);
+}
+
+void SystemTableSolverGenerator::generateIndexCLiteral(std::ostream& out, std::string M_name) const
+{
+	if( M_name.empty() )
+		throw std::invalid_argument("SystemTableSolverGenerator::generateIndexCLiteral(): M_name cannot be empty");
+
+	if(values.empty()) return;
+
+	writeIndexTable(out, M_name + "_col", getColumnTable());
+
+	if(getFormat() == CSR)
+	{
+		writeIndexTable(out, M_name + "_ptr", row_offsets);
+	}
+
+	writeIndexTable(out, M_name + "_row", row_solutions);
+}
+
+std::string SystemTableSolverGenerator::generateCInlineCode(std::string M_name, std::string v_name) const
+{
+	std::stringstream sstrm;
+
+	sstrm << "x[0] = 0.0;\n";
+
+	if(values.empty())
+	{
+		for(auto solution : row_solutions)
+		{
+			sstrm << "x[" << solution << "] = 0.0;\n";
+		}
+
+		return sstrm.str();
+	}
+
+	const unsigned int num_rows = row_solutions.size();
+
+	sstrm << "\n";
+
+	if(getFormat() == CSR)
+	{
+		sstrm
+		<< "for(unsigned int table_r = 0; table_r < " << num_rows << "; table_r++)\n"
+		<< "{\n"
+		<< "\treal table_sum = 0.0;\n\n"
+		<< "\tfor(unsigned int table_k = " << M_name << "_ptr[table_r]; table_k < " << M_name << "_ptr[table_r+1]; table_k++)\n"
+		<< "\t{\n"
+		<< "\t\ttable_sum += " << M_name << "_val[table_k]*" << v_name << "[" << M_name << "_col[table_k]];\n"
+		<< "\t}\n\n"
+		<< "\tx[" << M_name << "_row[table_r]] = table_sum;\n"
+		<< "}\n";
+
+		return sstrm.str();
+	}
+
+		//rows within a slot are independent, so the inner loop vectorizes
+
+	sstrm
+	<< "real table_sum[" << num_rows << "];\n\n"
+	<< "for(unsigned int table_r = 0; table_r < " << num_rows << "; table_r++) table_sum[table_r] = 0.0;\n\n"
+	<< "for(unsigned int table_k = 0; table_k < " << getLongestRowLength() << "; table_k++)\n"
+	<< "{\n"
+	<< "\tfor(unsigned int table_r = 0; table_r < " << num_rows << "; table_r++)\n"
+	<< "\t{\n"
+	<< "\t\ttable_sum[table_r] += " << M_name << "_val[table_k*" << num_rows << " + table_r]*"
+	<< v_name << "[" << M_name << "_col[table_k*" << num_rows << " + table_r]];\n"
+	<< "\t}\n"
+	<< "}\n\n"
+	<< "for(unsigned int table_r = 0; table_r < " << num_rows << "; table_r++) x[" << M_name << "_row[table_r]] = table_sum[table_r];\n";
+
+	return sstrm.str();
+}
+
+void SystemTableSolverGenerator::writeValueTable(std::ostream& out, std::string name, const std::vector<double>& values, std::string type_name)
+{
+	if(values.empty())
+		throw std::invalid_argument("SystemTableSolverGenerator::writeValueTable(): table " + name + " cannot be empty");
+
+	char literal[RealLiteralFormatter::MAX_LENGTH];
+
+	out << "const static " << type_name << " " << name << "[" << values.size() << "] =\n{\n";
+
+	for(std::size_t i = 0; i < values.size(); i++)
+	{
+		out.write(literal, RealLiteralFormatter::format(literal, values[i]) - literal);
+
+		if(i != values.size()-1) out << ",";
+
+		if(i % 8 == 7 || i == values.size()-1) out << "\n";
+	}
+
+	out << "};\n";
+}
+
+void SystemTableSolverGenerator::writeIndexTable(std::ostream& out, std::string name, const std::vector<unsigned int>& indices)
+{
+	if(indices.empty())
+		throw std::invalid_argument("SystemTableSolverGenerator::writeIndexTable(): table " + name + " cannot be empty");
+
+		//16 bit indices halve the table traffic when every index fits
+
+	const bool short_enable = *std::max_element(indices.begin(), indices.end()) <= 0xFFFF;
+
+	out << "const static " << (short_enable ? "unsigned short " : "unsigned int ") << name << "[" << indices.size() << "] =\n{\n";
+
+	for(std::size_t i = 0; i < indices.size(); i++)
+	{
+		out << indices[i];
+
+		if(i != indices.size()-1) out << ",";
+
+		if(i % 16 == 15 || i == indices.size()-1) out << "\n";
+	}
+
+	out << "};\n";
+}
+
+} //namespace lblmc
@@ -0,0 +1,295 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "codegen/SystemWordLengthAnalyzer.hpp"
+#include "codegen/SystemStateGenerator.hpp"
+
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace lblmc
+{
+
+double SystemWordLengthAnalyzer::Format::getResolution() const
+{
+	return std::ldexp(1.0, (int)int_width - (int)word_width);
+}
+
+SystemWordLengthAnalyzer::SystemWordLengthAnalyzer(const MatrixRMXd& M, const std::vector<double>& input_magnitudes, double zero_bound) :
+	solution_magnitudes(M.rows(), 0.0), row_input_sums(M.rows(), 0.0), matrix_magnitude(0.0), coefficient_magnitude(-1.0),
+	coefficient_divider(1.0), inline_coefficient_magnitude(0.0), source_magnitude(0.0), state_magnitude(0.0),
+	parameter_magnitude(0.0), parameter_min_magnitude(0.0), resolution(0.0), max_word_width(0)
+{
+	if(input_magnitudes.size() != (std::size_t)M.cols())
+		throw std::invalid_argument("SystemWordLengthAnalyzer::constructor(): input_magnitudes must have an element for each column of M");
+
+	for(auto mag : input_magnitudes)
+	{
+		if(mag < 0.0)
+			throw std::invalid_argument("SystemWordLengthAnalyzer::constructor(): input_magnitudes cannot be negative");
+	}
+
+	for(unsigned int r = 0; r < M.rows(); r++)
+	{
+		for(unsigned int c = 0; c < M.cols(); c++)
+		{
+			if(M(r,c) < zero_bound && M(r,c) > -zero_bound) continue;
+
+			solution_magnitudes[r] += std::abs(M(r,c))*input_magnitudes[c];
+			row_input_sums[r] += input_magnitudes[c];
+			matrix_magnitude = std::max(matrix_magnitude, std::abs(M(r,c)));
+		}
+	}
+}
+
+void SystemWordLengthAnalyzer::setCoefficientDivider(double divider)
+{
+	int exponent;
+
+	if(!(divider > 0.0) || std::frexp(divider, &exponent) != 0.5)
+		throw std::invalid_argument("SystemWordLengthAnalyzer::setCoefficientDivider(): divider must be a positive power of 2");
+
+	coefficient_divider = divider;
+}
+
+unsigned int SystemWordLengthAnalyzer::integralWidth(double magnitude)
+{
+		//fewest bits I, sign included, with 2^(I-1) > magnitude
+
+	if(!(magnitude > 0.0)) return 1;
+
+	return (unsigned int)std::max(1, (int)std::floor(std::log2(magnitude)) + 2);
+}
+
+int SystemWordLengthAnalyzer::fractionalWidth(double resolution)
+{
+	return std::max(0, (int)std::ceil(-std::log2(resolution)));
+}
+
+bool SystemWordLengthAnalyzer::parseLiteralParameter(const std::string& declaration, std::string& name, double& value)
+{
+	const std::size_t eq = declaration.find('=');
+	if(eq == std::string::npos) return false;
+
+	std::istringstream head(declaration.substr(0, eq));
+	std::vector<std::string> words;
+	std::string word;
+
+	while(head >> word) words.push_back(word);
+
+		//"const static real name" or "static const real name"
+
+	if(words.size() != 4 || words[2] != "real" ||
+		!((words[0] == "const" && words[1] == "static") || (words[0] == "static" && words[1] == "const")))
+		return false;
+
+	const std::string literal = SystemStateGenerator::trim(declaration.substr(eq+1));
+	if(literal.empty()) return false;
+
+	char* end;
+	value = std::strtod(literal.c_str(), &end);
+	name = words[3];
+
+	return *end == '\0';
+}
+
+void SystemWordLengthAnalyzer::insertParameters(const std::string& code)
+{
+	for(const auto& statement : SystemStateGenerator::splitTopLevel(SystemStateGenerator::stripComments(code), ';'))
+	{
+		std::string name;
+		double value;
+
+		if(!parseLiteralParameter(SystemStateGenerator::trim(statement), name, value) || value == 0.0) continue;
+
+		const double magnitude = std::abs(value);
+
+		parameter_magnitude = std::max(parameter_magnitude, magnitude);
+
+		if(parameter_min_magnitude == 0.0 || magnitude < parameter_min_magnitude)
+			parameter_min_magnitude = magnitude;
+	}
+}
+
+double SystemWordLengthAnalyzer::findParameterMagnitude(const std::string& code, const std::vector<std::string>& names)
+{
+	double magnitude = 0.0;
+
+	for(const auto& statement : SystemStateGenerator::splitTopLevel(SystemStateGenerator::stripComments(code), ';'))
+	{
+		std::string name;
+		double value;
+
+		if(!parseLiteralParameter(SystemStateGenerator::trim(statement), name, value)) continue;
+
+		if(std::find(names.begin(), names.end(), name) != names.end())
+			magnitude = std::max(magnitude, std::abs(value));
+	}
+
+	return magnitude;
+}
+
+std::string SystemWordLengthAnalyzer::generateParameterCode(const std::string& code)
+{
+	std::stringstream sstrm;
+
+	for(const auto& statement : SystemStateGenerator::splitTopLevel(SystemStateGenerator::stripComments(code), ';'))
+	{
+		const std::string decl = SystemStateGenerator::trim(statement);
+		if(decl.empty()) continue;
+
+		std::string name;
+		double value;
+
+		if(!parseLiteralParameter(decl, name, value))
+		{
+			sstrm << decl << ";\n";
+			continue;
+		}
+
+		const std::size_t type_begin = decl.find("real");
+
+		sstrm << decl.substr(0, type_begin) << getTypeName(PARAMETER) << decl.substr(type_begin+4) << ";\n";
+	}
+
+	return sstrm.str();
+}
+
+void SystemWordLengthAnalyzer::analyze(double resolution, unsigned int max_word_width)
+{
+	if(!(resolution > 0.0))
+		throw std::invalid_argument("SystemWordLengthAnalyzer::analyze(): resolution must be positive");
+
+	this->resolution = resolution;
+	this->max_word_width = max_word_width;
+
+	double solution_magnitude = 0.0;
+	double row_input_sum = 0.0;
+
+	for(unsigned int r = 0; r < solution_magnitudes.size(); r++)
+	{
+		solution_magnitude = std::max(solution_magnitude, solution_magnitudes[r]);
+		row_input_sum = std::max(row_input_sum, row_input_sums[r]);
+	}
+
+	const int fraction = fractionalWidth(resolution);
+
+		//rounding error of coefficients, divider*2^-(F+1)*sum(|v[c]|), within half of the resolution
+
+	const int coefficient_fraction = row_input_sum > 0.0 ?
+		std::max(0, (int)std::ceil(std::log2(coefficient_divider*row_input_sum/resolution))) : fraction;
+
+	formats[COEFFICIENT].magnitude = coefficient_magnitude >= 0.0 ? coefficient_magnitude : matrix_magnitude/coefficient_divider;
+	formats[SOURCE].magnitude = source_magnitude;
+	formats[SOLUTION].magnitude = solution_magnitude;
+	formats[STATE].magnitude = std::max(std::max(state_magnitude, inline_coefficient_magnitude), std::max(source_magnitude, solution_magnitude));
+	formats[PARAMETER].magnitude = parameter_magnitude;
+
+	int fractions[NUM_SIGNAL_CLASSES];
+	fractions[COEFFICIENT] = coefficient_fraction;
+	fractions[SOURCE] = fraction;
+	fractions[SOLUTION] = fraction;
+	fractions[STATE] = inline_coefficient_magnitude > 0.0 ? std::max(fraction, coefficient_fraction) : fraction;
+
+		//rounding error of parameters, 2^-(F+1), within the resolution relative to the smallest parameter
+
+	fractions[PARAMETER] = parameter_min_magnitude > 0.0 ?
+		std::max(0, (int)std::ceil(-std::log2(parameter_min_magnitude*resolution)) - 1) : fraction;
+
+	for(unsigned int i = 0; i < NUM_SIGNAL_CLASSES; i++)
+	{
+		Format& format = formats[i];
+
+		format.int_width = integralWidth(format.magnitude);
+
+		if(format.int_width > max_word_width)
+			throw std::runtime_error("SystemWordLengthAnalyzer::analyze(): integral width of " + getTypeName((SignalClass)i) +
+			" signals exceeds the maximum word width");
+
+		format.word_width = std::min(max_word_width, format.int_width + (unsigned int)fractions[i]);
+	}
+}
+
+std::string SystemWordLengthAnalyzer::getTypeName(SignalClass signal_class)
+{
+	switch(signal_class)
+	{
+		case COEFFICIENT: return "real_coef";
+		case SOURCE: return "real_src";
+		case SOLUTION: return "real_sol";
+		case PARAMETER: return "real_param";
+		default: return "real";
+	}
+}
+
+std::string SystemWordLengthAnalyzer::generateCTypedefs(std::string fixed_template, std::string extra_template_arguments) const
+{
+	std::stringstream sstrm;
+
+	for(unsigned int i = 0; i < NUM_SIGNAL_CLASSES; i++)
+	{
+		sstrm
+		<< "typedef " << fixed_template << "<" << formats[i].word_width << ", " << formats[i].int_width
+		<< extra_template_arguments << "> " << getTypeName((SignalClass)i) << ";\n";
+	}
+
+	return sstrm.str();
+}
+
+std::string SystemWordLengthAnalyzer::generateReport() const
+{
+	const char* labels[NUM_SIGNAL_CLASSES] =
+	{
+		"coefficients",
+		"sources",
+		"solutions",
+		"states",
+		"parameters",
+	};
+
+	std::stringstream sstrm;
+
+	sstrm
+	<< "fixed point word lengths (target resolution " << resolution << ", max word width " << max_word_width << "):\n";
+
+	if(coefficient_divider != 1.0)
+		sstrm << "  coefficients scaled by 1/" << coefficient_divider << "\n";
+
+	for(unsigned int i = 0; i < NUM_SIGNAL_CLASSES; i++)
+	{
+		std::string label = std::string(labels[i]) + " (" + getTypeName((SignalClass)i) + "):";
+		label.resize(std::max<std::size_t>(label.size()+1, 24), ' ');
+
+		sstrm
+		<< "  " << label << "<" << formats[i].word_width << ", " << formats[i].int_width << ">"
+		<< "  magnitude " << formats[i].magnitude << ", resolution " << formats[i].getResolution() << "\n";
+	}
+
+	return sstrm.str();
+}
+
+} // namespace lblmc
@@ -0,0 +1,149 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include "codegen/WordRenamer.hpp"
+
+#include <vector>
+#include <string>
+#include <cctype>
+#include <stdexcept>
+
+namespace lblmc
+{
+
+	//same delimiters as StringProcessor::isWordDelimiter()
+
+static inline bool isWordDelimiter(char c)
+{
+	const unsigned char u = static_cast<unsigned char>(c);
+
+	return (std::ispunct(u) || std::isspace(u) || u == '\0') && (u != '_');
+}
+
+void WordRenamer::addWord(const std::string& word, const std::string& replacement)
+{
+	std::string::size_type start = 0;
+
+	while(start < word.size() && isWordDelimiter(word[start])) start++;
+
+	if(start == word.size())
+	{
+		throw std::invalid_argument("WordRenamer::addWord(): word \"" + word + "\" must contain a word character");
+	}
+
+	for(std::string::size_type i = start; i < word.size(); i++)
+	{
+		if(isWordDelimiter(word[i]))
+		{
+			throw std::invalid_argument("WordRenamer::addWord(): word \"" + word + "\" cannot contain delimiters after its first word character");
+		}
+	}
+
+	replacements[word.substr(start)].push_back( Replacement{word.substr(0, start), replacement} );
+}
+
+void WordRenamer::addWords(const std::vector<std::string>& words, const std::vector<std::string>& new_words)
+{
+	if(words.size() != new_words.size())
+	{
+		throw std::invalid_argument("WordRenamer::addWords(): number of words must equal number of new_words");
+	}
+
+	for(std::size_t i = 0; i < words.size(); i++)
+	{
+		addWord(words[i], new_words[i]);
+	}
+}
+
+std::string& WordRenamer::replaceWords(std::string& body) const
+{
+	if(replacements.empty()) return body;
+
+	std::string output;
+	output.reserve(body.size() + body.size()/4);
+
+	std::string word;
+
+	const std::string::size_type length = body.size();
+	std::string::size_type pos = 0;
+
+	while(pos < length)
+	{
+			//delimiters are copied as is
+
+		if(isWordDelimiter(body[pos]))
+		{
+			output += body[pos++];
+			continue;
+		}
+
+		std::string::size_type end = pos+1;
+
+		while(end < length && !isWordDelimiter(body[end])) end++;
+
+		word.assign(body, pos, end-pos);
+
+		const auto found = replacements.find(word);
+		bool replaced = false;
+
+		if(found != replacements.end())
+		{
+			for(const Replacement& r : found->second)
+			{
+				const std::string::size_type prefix_length = r.prefix.size();
+
+				if(prefix_length > pos) continue;
+
+				const std::string::size_type start = pos - prefix_length;
+
+				if(body.compare(start, prefix_length, r.prefix) != 0) continue;
+
+				if(start != 0 && !isWordDelimiter(body[start-1])) continue;
+
+					//prefix was copied with the delimiters before the word
+
+				output.resize(output.size() - prefix_length);
+				output += r.replacement;
+
+				replaced = true;
+				break;
+			}
+		}
+
+		if(!replaced) output.append(body, pos, end-pos);
+
+		pos = end;
+	}
+
+	body.swap(output);
+
+	return body;
+}
+
+std::string WordRenamer::renamed(const std::string& body) const
+{
+	std::string copy = body;
+
+	return replaceWords(copy);
+}
+
+} //namespace lblmc
@@ -26,7 +26,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
+#include "codegen/WordRenamer.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -513,117 +513,119 @@ std::string BridgeConverter3LegIdealSwitches::generateUpdateBody()
 		//specialize converter update body code for component instance
 
 	std::string body = HALFBRIDGECONVERTER3PHASE_GENERATEUPDATEBODY_BASE_STRING;
-	lblmc::StringProcessor str_proc(body);
+	lblmc::WordRenamer renamer;
 
 		//specialize data type
 
-	str_proc.replaceWordAll("NumType", "real");
+	renamer.addWord("NumType", "real");
 
 		//specialize constant parameters
 
-	str_proc.replaceWordAll("cap_conduct", appendName("CAP_CONDUCTANCE") );
-	str_proc.replaceWordAll("dt", appendName("DT") );
-	str_proc.replaceWordAll("cap", appendName("CAP") );
-	str_proc.replaceWordAll("ind", appendName("IND") );
-	str_proc.replaceWordAll("res", appendName("RES") );
-	str_proc.replaceWordAll("hol", appendName("HOL") );
-	str_proc.replaceWordAll("hoc", appendName("HOC") );
+	renamer.addWord("cap_conduct", appendName("CAP_CONDUCTANCE") );
+	renamer.addWord("dt", appendName("DT") );
+	renamer.addWord("cap", appendName("CAP") );
+	renamer.addWord("ind", appendName("IND") );
+	renamer.addWord("res", appendName("RES") );
+	renamer.addWord("hol", appendName("HOL") );
+	renamer.addWord("hoc", appendName("HOC") );
 
 		//specialize internal temp parameters
-	str_proc.replaceWordAll("a1", appendName("a1") );
-	str_proc.replaceWordAll("a2", appendName("a2") );
-	str_proc.replaceWordAll("a3", appendName("a3") );
-	str_proc.replaceWordAll("b1", appendName("b1") );
-	str_proc.replaceWordAll("b2", appendName("b2") );
-	str_proc.replaceWordAll("b3", appendName("b3") );
-	str_proc.replaceWordAll("a", appendName("a") );
-	str_proc.replaceWordAll("b", appendName("b") );
-	str_proc.replaceWordAll("c", appendName("c") );
+	renamer.addWord("a1", appendName("a1") );
+	renamer.addWord("a2", appendName("a2") );
+	renamer.addWord("a3", appendName("a3") );
+	renamer.addWord("b1", appendName("b1") );
+	renamer.addWord("b2", appendName("b2") );
+	renamer.addWord("b3", appendName("b3") );
+	renamer.addWord("a", appendName("a") );
+	renamer.addWord("b", appendName("b") );
+	renamer.addWord("c", appendName("c") );
 
 		//specialize states and fields
-	str_proc.replaceWordAll("vc1", appendName("vc1") );
-	str_proc.replaceWordAll("vc2", appendName("vc2") );
-	str_proc.replaceWordAll("il1", appendName("il1") );
-	str_proc.replaceWordAll("il2", appendName("il2") );
-	str_proc.replaceWordAll("il3", appendName("il3") );
-	str_proc.replaceWordAll("ipos", appendName("ipos") );
-	str_proc.replaceWordAll("ineg", appendName("ineg") );
-	str_proc.replaceWordAll("epos_past", appendName("epos_past") );
-	str_proc.replaceWordAll("eneu_past", appendName("eneu_past") );
-	str_proc.replaceWordAll("eneg_past", appendName("eneg_past") );
-	str_proc.replaceWordAll("eout1_past", appendName("eout1_past") );
-	str_proc.replaceWordAll("eout2_past", appendName("eout2_past") );
-	str_proc.replaceWordAll("eout3_past", appendName("eout3_past") );
-	str_proc.replaceWordAll("vc1_past", appendName("vc1_past") );
-	str_proc.replaceWordAll("vc2_past", appendName("vc2_past") );
-	str_proc.replaceWordAll("il1_past", appendName("il1_past") );
-	str_proc.replaceWordAll("il2_past", appendName("il2_past") );
-	str_proc.replaceWordAll("il3_past", appendName("il3_past") );
-	str_proc.replaceWordAll("sw1", appendName("sw1") );
-	str_proc.replaceWordAll("sw2", appendName("sw2") );
-	str_proc.replaceWordAll("sw3", appendName("sw3") );
+	renamer.addWord("vc1", appendName("vc1") );
+	renamer.addWord("vc2", appendName("vc2") );
+	renamer.addWord("il1", appendName("il1") );
+	renamer.addWord("il2", appendName("il2") );
+	renamer.addWord("il3", appendName("il3") );
+	renamer.addWord("ipos", appendName("ipos") );
+	renamer.addWord("ineg", appendName("ineg") );
+	renamer.addWord("epos_past", appendName("epos_past") );
+	renamer.addWord("eneu_past", appendName("eneu_past") );
+	renamer.addWord("eneg_past", appendName("eneg_past") );
+	renamer.addWord("eout1_past", appendName("eout1_past") );
+	renamer.addWord("eout2_past", appendName("eout2_past") );
+	renamer.addWord("eout3_past", appendName("eout3_past") );
+	renamer.addWord("vc1_past", appendName("vc1_past") );
+	renamer.addWord("vc2_past", appendName("vc2_past") );
+	renamer.addWord("il1_past", appendName("il1_past") );
+	renamer.addWord("il2_past", appendName("il2_past") );
+	renamer.addWord("il3_past", appendName("il3_past") );
+	renamer.addWord("sw1", appendName("sw1") );
+	renamer.addWord("sw2", appendName("sw2") );
+	renamer.addWord("sw3", appendName("sw3") );
 
 		//specialize solution inputs and outputs
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<P<<"]";
-	str_proc.replaceWordAll("epos", sstrm.str());
+	renamer.addWord("epos", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<G<<"]";
-	str_proc.replaceWordAll("eneu", sstrm.str());
+	renamer.addWord("eneu", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<N<<"]";
-	str_proc.replaceWordAll("eneg", sstrm.str());
+	renamer.addWord("eneg", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<A<<"]";
-	str_proc.replaceWordAll("eout1", sstrm.str());
+	renamer.addWord("eout1", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<B<<"]";
-	str_proc.replaceWordAll("eout2", sstrm.str());
+	renamer.addWord("eout2", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<C<<"]";
-	str_proc.replaceWordAll("eout3", sstrm.str());
+	renamer.addWord("eout3", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_P-1<<"]";
-	str_proc.replaceWordAll("*bpos", sstrm.str());
+	renamer.addWord("*bpos", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_N-1<<"]";
-	str_proc.replaceWordAll("*bneg", sstrm.str());
+	renamer.addWord("*bneg", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_A-1<<"]";
-	str_proc.replaceWordAll("*bout1", sstrm.str());
+	renamer.addWord("*bout1", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_B-1<<"]";
-	str_proc.replaceWordAll("*bout2", sstrm.str());
+	renamer.addWord("*bout2", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_C-1<<"]";
-	str_proc.replaceWordAll("*bout3", sstrm.str());
+	renamer.addWord("*bout3", sstrm.str());
 
 		//specialize signal inputs and outputs
-	str_proc.replaceWordAll("sw_ctrl1", appendName("sw_ctrl")+std::string("[0]"));
-	str_proc.replaceWordAll("sw_ctrl2", appendName("sw_ctrl")+std::string("[1]"));
-	str_proc.replaceWordAll("sw_ctrl3", appendName("sw_ctrl")+std::string("[2]"));
-	str_proc.replaceWordAll("sw_en", appendName("sw_en"));
+	renamer.addWord("sw_ctrl1", appendName("sw_ctrl")+std::string("[0]"));
+	renamer.addWord("sw_ctrl2", appendName("sw_ctrl")+std::string("[1]"));
+	renamer.addWord("sw_ctrl3", appendName("sw_ctrl")+std::string("[2]"));
+	renamer.addWord("sw_en", appendName("sw_en"));
+
+	renamer.replaceWords(body);
 
 	return body;
 }
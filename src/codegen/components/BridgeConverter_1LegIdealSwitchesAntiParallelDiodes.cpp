@@ -26,7 +26,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
+#include "codegen/WordRenamer.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -464,13 +464,13 @@ std::string BridgeConverter_1LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 		//specialize converter update body code for component instance
 
 	std::string body = BRIDGECONVERTER1LEGIDEALSWITCHESANTIPARALLELDIODES_GENERATEUPDATEBODY_BASE_STRING;
-	StringProcessor str_proc(body);
+	WordRenamer renamer;
 
 		//specialize constant parameters
 
-	appendNameToWords
+	addNameToWords
 	(
-		body,
+		renamer,
 		{
 			"DT"  ,
 			"RIN" ,
@@ -486,9 +486,9 @@ std::string BridgeConverter_1LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 
 		//specialize fields
 
-	appendNameToWords
+	addNameToWords
 	(
-		body,
+		renamer,
 		{
 			"vcp_past",
 			"vcn_past",
@@ -529,20 +529,20 @@ std::string BridgeConverter_1LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 
 		//specialize solution and source contribution access
 
-    replaceTerminalConnectionNameWithIndex(body, "P", P);
-    replaceTerminalConnectionNameWithIndex(body, "G", G);
-    replaceTerminalConnectionNameWithIndex(body, "N", N);
-    replaceTerminalConnectionNameWithIndex(body, "A", A);
+    renamer.addWord("P", std::to_string(P));
+    renamer.addWord("G", std::to_string(G));
+    renamer.addWord("N", std::to_string(N));
+    renamer.addWord("A", std::to_string(A));
 
-	replaceSourceNameWithSourceContributionVector(body, "bpos", source_id_P);
-	replaceSourceNameWithSourceContributionVector(body, "bneg", source_id_N);
-	replaceSourceNameWithSourceContributionVector(body, "bouta", source_id_A);
+	addSourceNameWithSourceContributionVector(renamer, "bpos", source_id_P);
+	addSourceNameWithSourceContributionVector(renamer, "bneg", source_id_N);
+	addSourceNameWithSourceContributionVector(renamer, "bouta", source_id_A);
 
 		//specialize signal inputs and outputs
 
-	appendNameToWords
+	addNameToWords
 	(
-		body,
+		renamer,
 		{
 			"switch_gates",
 			"positive_capacitor_voltage",
@@ -551,6 +551,8 @@ std::string BridgeConverter_1LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 		}
 	);
 
+	renamer.replaceWords(body);
+
 	return body;
 }
 
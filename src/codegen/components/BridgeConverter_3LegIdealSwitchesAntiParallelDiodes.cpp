@@ -26,7 +26,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
+#include "codegen/WordRenamer.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -694,13 +694,13 @@ std::string BridgeConverter_3LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 		//specialize converter update body code for component instance
 
 	std::string body = BRIDGECONVERTER3LEGIDEALSWITCHESANTIPARALLELDIODES_GENERATEUPDATEBODY_BASE_STRING;
-	StringProcessor str_proc(body);
+	WordRenamer renamer;
 
 		//specialize constant parameters
 
-	appendNameToWords
+	addNameToWords
 	(
-		body,
+		renamer,
 		{
 			"DT"  ,
 			"RIN" ,
@@ -716,9 +716,9 @@ std::string BridgeConverter_3LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 
 		//specialize fields
 
-	appendNameToWords
+	addNameToWords
 	(
-		body,
+		renamer,
 		{
 			"vcp_past",
 			"vcn_past",
@@ -809,24 +809,24 @@ std::string BridgeConverter_3LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 
 		//specialize solution and source contribution access
 
-    replaceTerminalConnectionNameWithIndex(body, "P", P);
-    replaceTerminalConnectionNameWithIndex(body, "G", G);
-    replaceTerminalConnectionNameWithIndex(body, "N", N);
-    replaceTerminalConnectionNameWithIndex(body, "A", A);
-    replaceTerminalConnectionNameWithIndex(body, "B", B);
-    replaceTerminalConnectionNameWithIndex(body, "Ct", Ct);
+    renamer.addWord("P", std::to_string(P));
+    renamer.addWord("G", std::to_string(G));
+    renamer.addWord("N", std::to_string(N));
+    renamer.addWord("A", std::to_string(A));
+    renamer.addWord("B", std::to_string(B));
+    renamer.addWord("Ct", std::to_string(Ct));
 
-	replaceSourceNameWithSourceContributionVector(body, "bpos", source_id_P);
-	replaceSourceNameWithSourceContributionVector(body, "bneg", source_id_N);
-	replaceSourceNameWithSourceContributionVector(body, "bouta", source_id_A);
-	replaceSourceNameWithSourceContributionVector(body, "boutb", source_id_B);
-	replaceSourceNameWithSourceContributionVector(body, "boutc", source_id_C);
+	addSourceNameWithSourceContributionVector(renamer, "bpos", source_id_P);
+	addSourceNameWithSourceContributionVector(renamer, "bneg", source_id_N);
+	addSourceNameWithSourceContributionVector(renamer, "bouta", source_id_A);
+	addSourceNameWithSourceContributionVector(renamer, "boutb", source_id_B);
+	addSourceNameWithSourceContributionVector(renamer, "boutc", source_id_C);
 
 		//specialize signal inputs and outputs
 
-	appendNameToWords
+	addNameToWords
 	(
-		body,
+		renamer,
 		{
 			"switch_gates",
 			"positive_capacitor_voltage",
@@ -837,6 +837,8 @@ std::string BridgeConverter_3LegIdealSwitchesAntiParallelDiodes::generateUpdateB
 		}
 	);
 
+	renamer.replaceWords(body);
+
 	return body;
 }
 
@@ -25,7 +25,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SystemConductanceGenerator.hpp"
 #include "codegen/SystemSolverGenerator.hpp"
 #include "codegen/SolverEngineGenerator.hpp"
-#include "codegen/StringProcessor.hpp"
+#include "codegen/WordRenamer.hpp"
 
 #include <sstream>
 
@@ -49,6 +49,7 @@ void Component::stampSystem(SolverEngineGenerator& gen, const std::vector<std::s
 	stampSources(ssvg);
 	buf = generateParameters();
 	gen.insertComponentParametersCode(buf);
+	gen.insertComponentSourceParameters(getSourceParameters());
 
 	buf = generateFields();
 	gen.insertComponentFieldsCode(buf);
@@ -71,62 +72,97 @@ void Component::stampSystem(SolverEngineGenerator& gen, const std::vector<std::s
 
 std::string& Component::appendNameToWords(std::string& body, const std::vector<std::string>& words) const
 {
-	StringProcessor str_proc(body);
+	WordRenamer renamer;
 
-	for(const auto& word : words)
-	{
-		str_proc.replaceWordAll(word, appendName(word));
-	}
+	addNameToWords(renamer, words);
 
-	return body;
+	return renamer.replaceWords(body);
 }
 
 std::string&
 Component::appendNameToFields(std::string& body, const std::vector<Component::Field>& fields) const
 {
-	StringProcessor str_proc(body);
+	WordRenamer renamer;
 
-	for(const auto& field : fields)
-	{
-		str_proc.replaceWordAll(field.label, appendName(field.label));
-	}
+	addNameToFields(renamer, fields);
 
-	return body;
+	return renamer.replaceWords(body);
 }
 
 std::string& Component::replaceSourceNameWithSourceContributionVector(std::string& body, const std::string& src_name, unsigned int source_id )
 {
-	StringProcessor str_proc(body);
-	std::stringstream sstrm;
-	sstrm << "b_components["<<source_id-1<<"]";
-	str_proc.replaceWordAll(src_name, sstrm.str());
+	WordRenamer renamer;
+
+	addSourceNameWithSourceContributionVector(renamer, src_name, source_id);
 
-	return body;
+	return renamer.replaceWords(body);
 }
 
 std::string& Component::replaceTerminalConnectionNameWithIndex(std::string& body, const std::string& term_name, unsigned int index)
 {
-	StringProcessor str_proc(body);
-	str_proc.replaceWordAll(term_name, std::to_string(index));
+	WordRenamer renamer;
 
-	return body;
+	renamer.addWord(term_name, std::to_string(index));
+
+	return renamer.replaceWords(body);
 }
 
 std::string&
 Component::replaceTerminalConnectionNames(std::string& body, const std::vector<Component::Terminal>& terminals)
+{
+	WordRenamer renamer;
+
+	addTerminalConnectionNames(renamer, terminals);
+
+	return renamer.replaceWords(body);
+}
+
+std::string&
+Component::replaceSourceNames(std::string& body, const std::vector<Component::Source>& sources)
+{
+	WordRenamer renamer;
+
+	addSourceNames(renamer, sources);
+
+	return renamer.replaceWords(body);
+}
+
+void Component::addNameToWords(WordRenamer& renamer, const std::vector<std::string>& words) const
+{
+	for(const auto& word : words)
+	{
+		renamer.addWord(word, appendName(word));
+	}
+}
+
+void Component::addNameToFields(WordRenamer& renamer, const std::vector<Component::Field>& fields) const
+{
+	for(const auto& field : fields)
+	{
+		renamer.addWord(field.label, appendName(field.label));
+	}
+}
+
+void Component::addSourceNameWithSourceContributionVector(WordRenamer& renamer, const std::string& src_name, unsigned int source_id) const
+{
+	std::stringstream sstrm;
+	sstrm << "b_components["<<source_id-1<<"]";
+	renamer.addWord(src_name, sstrm.str());
+}
+
+void Component::addTerminalConnectionNames(WordRenamer& renamer, const std::vector<Component::Terminal>& terminals) const
 {
 	for(const auto& terminal : terminals)
 	{
-		replaceTerminalConnectionNameWithIndex(body, terminal.label, terminal.node_index);
+		renamer.addWord(terminal.label, std::to_string(terminal.node_index));
 	}
 }
 
-std::string&
-Component::replaceSourceNames(std::string& body, const std::vector<Component::Source>& sources)
+void Component::addSourceNames(WordRenamer& renamer, const std::vector<Component::Source>& sources) const
 {
 	for(const auto& source : sources)
 	{
-		replaceSourceNameWithSourceContributionVector(body, source.label, source.id);
+		addSourceNameWithSourceContributionVector(renamer, source.label, source.id);
 	}
 }
 
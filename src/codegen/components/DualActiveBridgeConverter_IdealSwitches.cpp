@@ -26,7 +26,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
+#include "codegen/WordRenamer.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -519,11 +519,13 @@ std::string DualActiveBridgeConverter_IdealSwitches::generateUpdateBody()
 {
 	std::string body = DUALACTIVEBRIDGECONVERTER_IDEALSWITCHES_GENERATEUPDATEBODY_BASE_STRING;
 
+	WordRenamer renamer;
+
 	//specialize code for instance of this component
 
-	appendNameToWords
+	addNameToWords
 	(
-		body,
+		renamer,
 
 		{
 				//constants/parameters
@@ -593,14 +595,15 @@ std::string DualActiveBridgeConverter_IdealSwitches::generateUpdateBody()
 		}
 	);
 
-	replaceTerminalConnectionNameWithIndex(body, "P1", P1);
-	replaceTerminalConnectionNameWithIndex(body, "N1", N1);
-	replaceTerminalConnectionNameWithIndex(body, "P2", P2);
-	replaceTerminalConnectionNameWithIndex(body, "N2", N2);
+	renamer.addWord("P1", std::to_string(P1));
+	renamer.addWord("N1", std::to_string(N1));
+	renamer.addWord("P2", std::to_string(P2));
+	renamer.addWord("N2", std::to_string(N2));
 
-	replaceSourceNameWithSourceContributionVector(body, "b1", source_id1);
-	replaceSourceNameWithSourceContributionVector(body, "b2", source_id2);
+	addSourceNameWithSourceContributionVector(renamer, "b1", source_id1);
+	addSourceNameWithSourceContributionVector(renamer, "b2", source_id2);
 
+	renamer.replaceWords(body);
 
 	return body;
 }
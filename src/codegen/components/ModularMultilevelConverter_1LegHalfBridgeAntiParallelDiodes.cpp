@@ -26,7 +26,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
+#include "codegen/WordRenamer.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -416,17 +416,21 @@ for(int i = 0; i < NUM_SM; i++)
 
 )";
 
-	appendNameToFields(output_body, parameters);
+	WordRenamer renamer;
 
-	appendNameToFields(output_body, constants);
+	addNameToFields(renamer, parameters);
 
-	appendNameToFields(output_body, persistents);
+	addNameToFields(renamer, constants);
 
-	appendNameToFields(output_body, temporaries);
+	addNameToFields(renamer, persistents);
 
-	appendNameToFields(output_body, signal_inputs);
+	addNameToFields(renamer, temporaries);
 
-	appendNameToFields(output_body, signal_outputs);
+	addNameToFields(renamer, signal_inputs);
+
+	addNameToFields(renamer, signal_outputs);
+
+	renamer.replaceWords(output_body);
 
 	return output_body;
 }
@@ -869,21 +873,25 @@ ModularMultilevelConverter_1LegHalfBridgeAntiParallelDiodes::generateUpdateBody(
 
 	std::string body = MODULARMULTILEVELCONVERTER_1LEGHALFBRIDGEANTIPARALLELDIODES_MODELBODY_BASE_STRING;
 
-	appendNameToFields(body, parameters);
+	WordRenamer renamer;
+
+	addNameToFields(renamer, parameters);
+
+	addNameToFields(renamer, constants);
 
-	appendNameToFields(body, constants);
+	addNameToFields(renamer, persistents);
 
-	appendNameToFields(body, persistents);
+	addNameToFields(renamer, temporaries);
 
-	appendNameToFields(body, temporaries);
+	addNameToFields(renamer, signal_inputs);
 
-	appendNameToFields(body, signal_inputs);
+	addNameToFields(renamer, signal_outputs);
 
-	appendNameToFields(body, signal_outputs);
+	addTerminalConnectionNames(renamer, terminals);
 
-	replaceTerminalConnectionNames(body, terminals);
+	addSourceNames(renamer, sources);
 
-	replaceSourceNames(body, sources);
+	renamer.replaceWords(body);
 
 	return body;
 }
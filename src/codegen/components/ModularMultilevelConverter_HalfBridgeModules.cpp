@@ -26,7 +26,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
+#include "codegen/WordRenamer.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -649,17 +649,17 @@ std::string ModularMultilevelConverter_HalfBridgeModules::generateUpdateBody()
 		//specialize converter update body code for component instance
 
 	std::string body = MODULARMULTILEVELCONVERTER_HALFBRIDGEMODULES_GENERATEUPDATEBODY_BASE_STRING;
-	StringProcessor str_proc(body);
+	WordRenamer renamer;
 
 		//specialize data type
 
-	str_proc.replaceWordAll("real", "real");
+	renamer.addWord("real", "real");
 
 		//specialize constant parameters
 
-	appendNameToWords
+	addNameToWords
 	(
-		body,
+		renamer,
 		{
 			"MMC_LEVELS",
 			"DT",
@@ -680,9 +680,9 @@ std::string ModularMultilevelConverter_HalfBridgeModules::generateUpdateBody()
 
 		//specialize internal temp parameters
 
-	appendNameToWords
+	addNameToWords
 	(
-		body,
+		renamer,
 		{
 			"upa",
 			"upb",
@@ -695,9 +695,9 @@ std::string ModularMultilevelConverter_HalfBridgeModules::generateUpdateBody()
 
 		//specialize states and fields
 
-	appendNameToWords
+	addNameToWords
 	(
-		body,
+		renamer,
 		{
 			"Rpre",
 			"a",
@@ -735,42 +735,42 @@ std::string ModularMultilevelConverter_HalfBridgeModules::generateUpdateBody()
 
 		//specialize solution inputs and outputs
 
-	str_proc.replaceWordAll("P", std::to_string(P));
-	str_proc.replaceWordAll("N", std::to_string(N));
-	str_proc.replaceWordAll("A", std::to_string(A));
-	str_proc.replaceWordAll("B", std::to_string(B));
-	str_proc.replaceWordAll("C", std::to_string(C));
+	renamer.addWord("P", std::to_string(P));
+	renamer.addWord("N", std::to_string(N));
+	renamer.addWord("A", std::to_string(A));
+	renamer.addWord("B", std::to_string(B));
+	renamer.addWord("C", std::to_string(C));
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_P-1<<"]";
-	str_proc.replaceWordAll("*bpos", sstrm.str());
+	renamer.addWord("*bpos", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_N-1<<"]";
-	str_proc.replaceWordAll("*bneg", sstrm.str());
+	renamer.addWord("*bneg", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_A-1<<"]";
-	str_proc.replaceWordAll("*bout1", sstrm.str());
+	renamer.addWord("*bout1", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_B-1<<"]";
-	str_proc.replaceWordAll("*bout2", sstrm.str());
+	renamer.addWord("*bout2", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_C-1<<"]";
-	str_proc.replaceWordAll("*bout3", sstrm.str());
+	renamer.addWord("*bout3", sstrm.str());
 
 		//specialize signal inputs and outputs
 
-	appendNameToWords
+	addNameToWords
 	(
-		body,
+		renamer,
 		{
 			"swp",
 			"Sa",
@@ -779,6 +779,8 @@ std::string ModularMultilevelConverter_HalfBridgeModules::generateUpdateBody()
 		}
 	);
 
+	renamer.replaceWords(body);
+
 	return body;
 }
 
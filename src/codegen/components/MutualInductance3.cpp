@@ -26,7 +26,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
+#include "codegen/WordRenamer.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -217,70 +217,72 @@ std::string MutualInductance3::generateUpdateBody()
 	std::scientific;
 
 	std::string body = MUTUALINDUCTANCE3_GENERATEUPDATEBODY_BASE_STRING;
-	lblmc::StringProcessor proc(body);
-
-	proc.replaceWordAll("D", appendName("D") );
-	proc.replaceWordAll("K1", appendName("K1") );
-	proc.replaceWordAll("K2", appendName("K2") );
-	proc.replaceWordAll("K3", appendName("K3") );
-	proc.replaceWordAll("K4", appendName("K4") );
-	proc.replaceWordAll("K5", appendName("K5") );
-	proc.replaceWordAll("K6", appendName("K6") );
-	proc.replaceWordAll("K7", appendName("K7") );
-	proc.replaceWordAll("K8", appendName("K8") );
-	proc.replaceWordAll("K9", appendName("K9") );
-
-	proc.replaceWordAll("current_comp1", appendName("current_comp1") );
-	proc.replaceWordAll("current_comp2", appendName("current_comp2") );
-	proc.replaceWordAll("current_comp3", appendName("current_comp3") );
-	proc.replaceWordAll("voltage1", appendName("voltage1") );
-	proc.replaceWordAll("voltage2", appendName("voltage2") );
-	proc.replaceWordAll("voltage3", appendName("voltage3") );
+	lblmc::WordRenamer renamer;
+
+	renamer.addWord("D", appendName("D") );
+	renamer.addWord("K1", appendName("K1") );
+	renamer.addWord("K2", appendName("K2") );
+	renamer.addWord("K3", appendName("K3") );
+	renamer.addWord("K4", appendName("K4") );
+	renamer.addWord("K5", appendName("K5") );
+	renamer.addWord("K6", appendName("K6") );
+	renamer.addWord("K7", appendName("K7") );
+	renamer.addWord("K8", appendName("K8") );
+	renamer.addWord("K9", appendName("K9") );
+
+	renamer.addWord("current_comp1", appendName("current_comp1") );
+	renamer.addWord("current_comp2", appendName("current_comp2") );
+	renamer.addWord("current_comp3", appendName("current_comp3") );
+	renamer.addWord("voltage1", appendName("voltage1") );
+	renamer.addWord("voltage2", appendName("voltage2") );
+	renamer.addWord("voltage3", appendName("voltage3") );
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<PA<<"]";
-	proc.replaceWordAll("epos1", sstrm.str());
+	renamer.addWord("epos1", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<NA<<"]";
-	proc.replaceWordAll("eneg1", sstrm.str());
+	renamer.addWord("eneg1", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<PB<<"]";
-	proc.replaceWordAll("epos2", sstrm.str());
+	renamer.addWord("epos2", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<NB<<"]";
-	proc.replaceWordAll("eneg2", sstrm.str());
+	renamer.addWord("eneg2", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<PC<<"]";
-	proc.replaceWordAll("epos3", sstrm.str());
+	renamer.addWord("epos3", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<NC<<"]";
-	proc.replaceWordAll("eneg3", sstrm.str());
+	renamer.addWord("eneg3", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_A-1<<"]";
-	proc.replaceWordAll("*bout1", sstrm.str());
+	renamer.addWord("*bout1", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_B-1<<"]";
-	proc.replaceWordAll("*bout2", sstrm.str());
+	renamer.addWord("*bout2", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id_C-1<<"]";
-	proc.replaceWordAll("*bout3", sstrm.str());
+	renamer.addWord("*bout3", sstrm.str());
+
+	renamer.replaceWords(body);
 
 	return body;
 }
@@ -26,7 +26,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
+#include "codegen/WordRenamer.hpp"
 #include <string>
 #include <stdexcept>
 #include <sstream>
@@ -40,6 +40,8 @@ SeriesRLIdealSwitch::SeriesRLIdealSwitch(std::string comp_name) :
 	DT(1.0),
 	L(1.0),
 	R(1.0),
+	GOFF(0.0),
+	switched_conductance_enable(false),
 	P(0), N(0),
 	source_id(0),
 	integration_method(INTEGRATION_EULER_FORWARD)
@@ -50,6 +52,8 @@ SeriesRLIdealSwitch::SeriesRLIdealSwitch(std::string comp_name, double dt, doubl
 	DT(dt),
 	L(l),
 	R(r),
+	GOFF(0.0),
+	switched_conductance_enable(false),
 	P(0), N(0),
 	source_id(0),
 	integration_method(INTEGRATION_EULER_FORWARD)
@@ -60,6 +64,8 @@ SeriesRLIdealSwitch::SeriesRLIdealSwitch(const SeriesRLIdealSwitch& base) :
 	DT(base.DT),
 	L(base.L),
 	R(base.R),
+	GOFF(base.GOFF),
+	switched_conductance_enable(base.switched_conductance_enable),
 	P(base.P), N(base.N),
 	source_id(base.source_id),
 	integration_method(base.integration_method)
@@ -85,7 +91,12 @@ void SeriesRLIdealSwitch::getResistiveCompanionElements(std::vector<ResistiveCom
 
 void SeriesRLIdealSwitch::stampConductance(SystemConductanceGenerator& gen)
 {
-	//do nothing since using explicit integration methods
+	if(switched_conductance_enable)
+	{
+		gen.stampSwitchedConductance(1.0/(R + L/DT), GOFF, P, N, appendName("sw"));
+	}
+
+	//otherwise do nothing since using explicit integration methods
 }
 
 void SeriesRLIdealSwitch::stampSources(SystemSourceVectorGenerator& gen)
@@ -102,7 +113,20 @@ std::string SeriesRLIdealSwitch::generateParameters()
 	std::scientific;
 
 
-	if(integration_method == INTEGRATION_EULER_FORWARD)
+	if(switched_conductance_enable)
+	{
+
+			// L*(x(t+dt) - x(t))/dt + R*x(t+dt) = u(t+dt)
+			// x(t+dt) = GON*u(t+dt) + HIST*x(t)
+		const double GON = 1.0/(R + L/DT);
+		const double HIST = GON*L/DT;
+		generateParameter(sstrm, "DT", DT);
+		generateParameter(sstrm, "L", L);
+		generateParameter(sstrm, "R", R);
+		generateParameter(sstrm, "GON", GON);
+		generateParameter(sstrm, "HIST", HIST);
+	}
+	else if(integration_method == INTEGRATION_EULER_FORWARD)
 	{
 
 			// dx/dt (t) = -R/L*x(t) + 1/L*u(t)
@@ -151,6 +175,11 @@ std::string SeriesRLIdealSwitch::generateFields()
 	generateField(sstrm, "current_past", 0.0);
 	generateBoolField(sstrm, "sw_past", false);
 
+	if(switched_conductance_enable)
+	{
+		generateField(sstrm, "hist", 0.0);
+	}
+
 	return sstrm.str();
 }
 
@@ -241,8 +270,38 @@ sw_past = sw;
 *bout = -current;
 )";
 
+const static std::string SERIESRLIDEALSWITCH_GENERATEUPDATEBODY_BASE_SWITCHED_STRING =
+R"(
+real current;
+
+if(sw_past)
+{
+	current = GON*(epos - eneg) + hist; //Euler Backward (implicit) companion model of last solve
+}
+else
+{
+	current = 0; //inductor is de-energized while switch open
+}
+
+if(sw)
+{
+	hist = HIST*current;
+}
+else
+{
+	hist = 0;
+}
+
+current_past = current;
+sw_past = sw;
+
+*bout = -hist;
+)";
+
 std::string SeriesRLIdealSwitch::generateUpdateBody()
 {
+	if(switched_conductance_enable)
+		return generateUpdateBodySwitchedConductance();
 
 	if(integration_method == INTEGRATION_EULER_FORWARD)
 		return generateUpdateBodyEulerForward();
@@ -262,34 +321,36 @@ std::string SeriesRLIdealSwitch::generateUpdateBodyEulerForward()
 	std::scientific;
 
 	std::string body = SERIESRLIDEALSWITCH_GENERATEUPDATEBODY_BASE_EF_STRING;
-	lblmc::StringProcessor str_proc(body);
+	lblmc::WordRenamer renamer;
 
-	str_proc.replaceWordAll("NumType", "real");
+	renamer.addWord("NumType", "real");
 
-	str_proc.replaceWordAll("HOL", appendName("HOL"));
-	str_proc.replaceWordAll("R", appendName("R"));
-	str_proc.replaceWordAll("L", appendName("L"));
-	str_proc.replaceWordAll("DT", appendName("DT"));
+	renamer.addWord("HOL", appendName("HOL"));
+	renamer.addWord("R", appendName("R"));
+	renamer.addWord("L", appendName("L"));
+	renamer.addWord("DT", appendName("DT"));
 
-	str_proc.replaceWordAll("sw_past", appendName("sw_past"));
-	str_proc.replaceWordAll("current", appendName("current"));
-	str_proc.replaceWordAll("current_past", appendName("current_past"));
-	str_proc.replaceWordAll("sw", appendName("sw"));
+	renamer.addWord("sw_past", appendName("sw_past"));
+	renamer.addWord("current", appendName("current"));
+	renamer.addWord("current_past", appendName("current_past"));
+	renamer.addWord("sw", appendName("sw"));
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<P<<"]";
-	str_proc.replaceWordAll("epos", sstrm.str());
+	renamer.addWord("epos", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<N<<"]";
-	str_proc.replaceWordAll("eneg", sstrm.str());
+	renamer.addWord("eneg", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id-1<<"]";
-	str_proc.replaceWordAll("*bout", sstrm.str());
+	renamer.addWord("*bout", sstrm.str());
+
+	renamer.replaceWords(body);
 
 	return body;
 }
@@ -303,32 +364,74 @@ std::string SeriesRLIdealSwitch::generateUpdateBodyRungeKutta4()
 	std::scientific;
 
 	std::string body = SERIESRLIDEALSWITCH_GENERATEUPDATEBODY_BASE_RK4_STRING;
-	lblmc::StringProcessor str_proc(body);
+	lblmc::WordRenamer renamer;
 
-	str_proc.replaceWordAll("NumType", "real");
+	renamer.addWord("NumType", "real");
 
-	str_proc.replaceWordAll("ARK4", appendName("ARK4"));
-	str_proc.replaceWordAll("BRK4", appendName("BRK4"));
+	renamer.addWord("ARK4", appendName("ARK4"));
+	renamer.addWord("BRK4", appendName("BRK4"));
 
-	str_proc.replaceWordAll("sw_past", appendName("sw_past"));
-	str_proc.replaceWordAll("current", appendName("current"));
-	str_proc.replaceWordAll("current_past", appendName("current_past"));
-	str_proc.replaceWordAll("sw", appendName("sw"));
+	renamer.addWord("sw_past", appendName("sw_past"));
+	renamer.addWord("current", appendName("current"));
+	renamer.addWord("current_past", appendName("current_past"));
+	renamer.addWord("sw", appendName("sw"));
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<P<<"]";
-	str_proc.replaceWordAll("epos", sstrm.str());
+	renamer.addWord("epos", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "x["<<N<<"]";
-	str_proc.replaceWordAll("eneg", sstrm.str());
+	renamer.addWord("eneg", sstrm.str());
 
 	sstrm.str("");
 	sstrm.clear();
 	sstrm << "b_components["<<source_id-1<<"]";
-	str_proc.replaceWordAll("*bout", sstrm.str());
+	renamer.addWord("*bout", sstrm.str());
+
+	renamer.replaceWords(body);
+
+	return body;
+}
+
+std::string SeriesRLIdealSwitch::generateUpdateBodySwitchedConductance()
+{
+	std::stringstream sstrm;
+	sstrm <<
+	std::setprecision(16) <<
+	std::fixed <<
+	std::scientific;
+
+	std::string body = SERIESRLIDEALSWITCH_GENERATEUPDATEBODY_BASE_SWITCHED_STRING;
+	lblmc::WordRenamer renamer;
+
+	renamer.addWord("GON", appendName("GON"));
+	renamer.addWord("HIST", appendName("HIST"));
+
+	renamer.addWord("sw_past", appendName("sw_past"));
+	renamer.addWord("current", appendName("current"));
+	renamer.addWord("current_past", appendName("current_past"));
+	renamer.addWord("hist", appendName("hist"));
+	renamer.addWord("sw", appendName("sw"));
+
+	sstrm.str("");
+	sstrm.clear();
+	sstrm << "x["<<P<<"]";
+	renamer.addWord("epos", sstrm.str());
+
+	sstrm.str("");
+	sstrm.clear();
+	sstrm << "x["<<N<<"]";
+	renamer.addWord("eneg", sstrm.str());
+
+	sstrm.str("");
+	sstrm.clear();
+	sstrm << "b_components["<<source_id-1<<"]";
+	renamer.addWord("*bout", sstrm.str());
+
+	renamer.replaceWords(body);
 
 	return body;
 }
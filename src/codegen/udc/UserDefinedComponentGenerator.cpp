@@ -26,7 +26,7 @@ along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.
 #include "codegen/SolverEngineGenerator.hpp"
 #include "codegen/Object.hpp"
 #include "codegen/ArrayObject.hpp"
-#include "codegen/StringProcessor.hpp"
+#include "codegen/WordRenamer.hpp"
 
 #include <exprpar/exprpar.hpp>
 
@@ -782,13 +782,13 @@ UserDefinedComponentGenerator::generateUpdateBody()
 
 	std::string body = component_definition->getModelUpdateCode();
 
-	StringProcessor str_proc(body);
+	WordRenamer renamer;
 
-	//append component label to variables in model code
+	//append component label to variables in model code, replacing all words in one pass
 
 	for(const auto& elem : component_definition->getParameters())
 	{
-		str_proc.replaceWordAll
+		renamer.addWord
 		(
 			elem.label,
 			appendName(elem.label)
@@ -797,7 +797,7 @@ UserDefinedComponentGenerator::generateUpdateBody()
 
 	for(const auto& elem : component_definition->getConstants())
 	{
-		str_proc.replaceWordAll
+		renamer.addWord
 		(
 			elem.label,
 			appendName(elem.label)
@@ -806,7 +806,7 @@ UserDefinedComponentGenerator::generateUpdateBody()
 
 	for(const auto& elem : component_definition->getPersistents())
 	{
-		str_proc.replaceWordAll
+		renamer.addWord
 		(
 			elem.label,
 			appendName(elem.label)
@@ -815,7 +815,7 @@ UserDefinedComponentGenerator::generateUpdateBody()
 
 	for(const auto& elem : component_definition->getTemporaries())
 	{
-		str_proc.replaceWordAll
+		renamer.addWord
 		(
 			elem.label,
 			appendName(elem.label)
@@ -824,7 +824,7 @@ UserDefinedComponentGenerator::generateUpdateBody()
 
 	for(const auto& elem : component_definition->getInputSignalPorts())
 	{
-		str_proc.replaceWordAll
+		renamer.addWord
 		(
 			elem.label,
 			appendName(elem.label)
@@ -833,7 +833,7 @@ UserDefinedComponentGenerator::generateUpdateBody()
 
 	for(const auto& elem : component_definition->getOutputSignalPorts())
 	{
-		str_proc.replaceWordAll
+		renamer.addWord
 		(
 			elem.label,
 			appendName(elem.label)
@@ -842,7 +842,7 @@ UserDefinedComponentGenerator::generateUpdateBody()
 
 	for(const auto& elem : terminal_node_assignments)
 	{
-		str_proc.replaceWordAll
+		renamer.addWord
 		(
 			elem.first,
 			std::to_string(elem.second)
@@ -855,7 +855,7 @@ UserDefinedComponentGenerator::generateUpdateBody()
 		sstrm.clear();
 		sstrm << "b_components["<< (elem.second - 1) <<"]";
 
-		str_proc.replaceWordAll
+		renamer.addWord
 		(
 			elem.first,
 			sstrm.str()
@@ -868,13 +868,15 @@ UserDefinedComponentGenerator::generateUpdateBody()
 		sstrm.clear();
 		sstrm << "b_components["<< (elem.second - 1) <<"]";
 
-		str_proc.replaceWordAll
+		renamer.addWord
 		(
 			elem.first,
 			sstrm.str()
 		);
 	}
 
+	renamer.replaceWords(body);
+
 	return body;
 }
 
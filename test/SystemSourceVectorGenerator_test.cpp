@@ -0,0 +1,79 @@
+/*
+
+Copyright (C) 2019-2021 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+/*
+	Regression test of SystemSourceVectorGenerator::insertSource() keeping the sign of sources
+	contributing negatively to the source vector.
+
+	Build and run from the repository root with:
+	g++ -std=c++14 -I include -I /usr/include/eigen3 test/SystemSourceVectorGenerator_test.cpp \
+		src/codegen/SystemSourceVectorGenerator.cpp src/codegen/AdderTreeGenerator.cpp -o source_vector_test
+	./source_vector_test
+*/
+
+#include "codegen/SystemSourceVectorGenerator.hpp"
+
+#include <iostream>
+#include <string>
+
+using namespace lblmc;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+	if(!condition)
+	{
+		std::cerr << "FAILED: " << what << std::endl;
+		++failures;
+	}
+}
+
+int main()
+{
+	SystemSourceVectorGenerator gen(4); // asVector() bounds n by the dimension exclusively, so leave b[3] unused
+
+	gen.insertSource(1, 2);
+	gen.insertSource(0, 3);
+	gen.insertSource(2, 1);
+
+	check(gen.asVector(1).size() == 2, "b[0] has two sources");
+	check(gen.asVector(1)[0] == +1, "source 1 is positive in b[0]");
+	check(gen.asVector(1)[1] == -3, "source 3 is negative in b[0]");
+	check(gen.asVector(2)[0] == -1, "source 1 is negative in b[1]");
+	check(gen.asVector(2)[1] == +3, "source 3 is positive in b[1]");
+	check(gen.asVector(3)[0] == -2, "source 2 is negative in b[2]");
+
+	MatrixRMXd incidence = gen.asIncidenceMatrix();
+	check(incidence(1, 0) == -1.0, "incidence of source 1 into b[1] is -1");
+	check(incidence(2, 1) == -1.0, "incidence of source 2 into b[2] is -1");
+
+	std::string code = gen.asCInlineCode();
+	check(code.find("b[1] =  -b_components[0] + b_components[2] ;") != std::string::npos,
+		"aggregation of b[1] subtracts source 1");
+	check(code.find("b[2] =  -b_components[1] ;") != std::string::npos,
+		"aggregation of b[2] subtracts source 2");
+
+	if(failures == 0) std::cout << "SystemSourceVectorGenerator_test passed" << std::endl;
+
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+/*
+	Test of generated fixed point solvers against generated double solvers of the same system, whose
+	voltage source contributes a Norton current of 1e4, beyond the default expected source magnitude
+	of word-length analysis.
+
+	The test generates both solvers, compiles and runs a driver for each with the compiler of
+	environment variable CXX, or g++ if not set, and compares their solutions after 2000 time steps.
+
+	Build and run from the repository root with:
+	g++ -std=c++14 -I include -I /usr/include/eigen3 test/fixed_point_solver_test.cpp \
+		$(find src -name '*.cpp') -lpthread -o fixed_point_solver_test
+	./fixed_point_solver_test
+*/
+
+#include "codegen/SolverEngineGenerator.hpp"
+#include "codegen/components/VoltageSource.hpp"
+#include "codegen/components/Inductor.hpp"
+#include "codegen/components/Resistor.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace lblmc;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+	if(!condition)
+	{
+		std::cerr << "FAILED: " << what << std::endl;
+		++failures;
+	}
+}
+
+	//generates the solver of model_name, then compiles and runs its driver, storing the printed results in x
+
+static bool runSolver(const std::string& model_name, const SolverEngineGeneratorParameters& params, double x[3])
+{
+	SolverEngineGenerator seg(model_name, 2, params);
+
+	VoltageSource vg("vg", 100.0, 0.01);
+	Inductor ind("ind", 1.0e-6, 1.0e-3);
+	Resistor res("res", 30.0);
+
+	vg.setTerminalConnections(1, 0);
+	ind.setTerminalConnections(1, 2);
+	res.setTerminalConnections(2, 0);
+
+	vg.stampSystem(seg);
+	ind.stampSystem(seg);
+	res.stampSystem(seg);
+
+	seg.generateCFunctionAndExport(model_name + ".hpp");
+
+	std::ofstream driver(model_name + "_driver.cpp");
+
+	driver
+	<< "#include <cstdio>\n"
+	<< "#include \"" << model_name << ".hpp\"\n"
+	<< "int main()\n"
+	<< "{\n"
+	<< "\treal x[2];\n"
+	<< "\treal current;\n"
+	<< "\tfor(int k = 0; k < 2000; k++) " << model_name << "_solver(x, &current);\n"
+	<< "\tstd::printf(\"%.9g %.9g %.9g\\n\", (double)x[0], (double)x[1], (double)current);\n"
+	<< "\treturn 0;\n"
+	<< "}\n";
+
+	driver.close();
+
+	const char* cxx = std::getenv("CXX");
+
+	const std::string command =
+		std::string(cxx != nullptr ? cxx : "g++") + " -std=c++11 -I . -I include/runtime " +
+		model_name + "_driver.cpp -o " + model_name + "_driver && ./" + model_name + "_driver";
+
+	std::FILE* out = popen(command.c_str(), "r");
+	if(out == nullptr) return false;
+
+	const bool read = std::fscanf(out, "%lf %lf %lf", &x[0], &x[1], &x[2]) == 3;
+	const bool ran = pclose(out) == 0;
+
+	std::remove((model_name + ".hpp").c_str());
+	std::remove((model_name + "_driver.cpp").c_str());
+	std::remove((model_name + "_driver").c_str());
+
+	return ran && read;
+}
+
+int main()
+{
+	SolverEngineGeneratorParameters params;
+
+	double x_double[3];
+
+	check(runSolver("fixed_point_solver_test_double", params, x_double), "double solver runs");
+
+	params.fixed_point_enable = true;
+	params.fixed_point_word_length_analysis_enable = true;
+	params.fixed_point_resolution = 1.0e-6;
+
+	double x_fixed[3];
+
+	check(runSolver("fixed_point_solver_test_fixed", params, x_fixed), "fixed point solver runs");
+
+		//rounding errors of 1e-6 resolution accumulated over the time steps stay well within 1e-2
+
+	check(std::fabs(x_fixed[0] - x_double[0]) < 1.0e-2, "fixed point source node voltage matches double");
+	check(std::fabs(x_fixed[1] - x_double[1]) < 1.0e-2, "fixed point load node voltage matches double");
+	check(std::fabs(x_fixed[2] - x_double[2]) < 1.0e-2, "fixed point inductor current matches double");
+
+	if(failures != 0)
+	{
+		std::cerr
+		<< "double: " << x_double[0] << " " << x_double[1] << " " << x_double[2] << "\n"
+		<< "fixed:  " << x_fixed[0] << " " << x_fixed[1] << " " << x_fixed[2] << std::endl;
+	}
+
+	if(failures == 0) std::cout << "fixed_point_solver_test passed" << std::endl;
+
+	return failures == 0 ? 0 : 1;
+}
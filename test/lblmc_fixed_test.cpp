@@ -0,0 +1,185 @@
+/*
+
+Copyright (C) 2023 Matthew Milton
+
+This file is part of the LB-LMC Solver C++ Code Generation Library, included in the
+Open Real-Time Simulation (ORTiS) Framework.
+
+LB-LMC Solver C++ Code Generation Library is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+LB-LMC Solver C++ Code Generation Library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LB-LMC Solver C++ Code Generation Library.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+/*
+	Test of lblmc_fixed arithmetic with mixed integer, bool, and floating point operands, as found in the
+	update bodies of components of generated fixed point solvers, and of its quantization, overflow, and
+	division against exact values.
+
+	Build and run from the repository root with:
+	g++ -std=c++11 -I include/runtime test/lblmc_fixed_test.cpp -o lblmc_fixed_test
+	./lblmc_fixed_test
+
+	Add -DLBLMC_FIXED_PORTABLE to test the 128 bit integer emulation.
+*/
+
+#include "lblmc_fixed.hpp"
+
+#include <cmath>
+#include <iostream>
+
+typedef lblmc_fixed<32, 12, LBLMC_RND> real;
+typedef lblmc_fixed<32, 1, LBLMC_RND> real_coef;
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+	if(!condition)
+	{
+		std::cerr << "FAILED: " << what << std::endl;
+		++failures;
+	}
+}
+
+static bool near(double a, double b)
+{
+	return std::fabs(a - b) <= 1.0e-5*(1.0 + std::fabs(b));
+}
+
+	//v quantized to <8,4>, with LSB 0.0625, from a double and from a wider fixed point value
+
+template<lblmc_q_mode Q>
+static bool quantizes(double v, double expected)
+{
+	return (double)lblmc_fixed<8, 4, Q>(v) == expected &&
+		(double)lblmc_fixed<8, 4, Q>(lblmc_fixed<16, 8>(v)) == expected;
+}
+
+template<lblmc_o_mode O>
+static bool overflows(double v, double expected)
+{
+	return (double)lblmc_fixed<8, 4, LBLMC_TRN, O>(v) == expected &&
+		(double)lblmc_fixed<8, 4, LBLMC_TRN, O>(lblmc_fixed<16, 12>(v)) == expected;
+}
+
+int main()
+{
+	const real x = 1.5;
+	const real_coef c = 0.25;
+
+		//fixed point with integers, as ap_fixed with int operands
+
+	const int n = 3;
+	const unsigned int u = 2;
+	const long long ll = -4;
+
+	check(near((double)real(n*x), 4.5), "int * fixed");
+	check(near((double)real(x*n), 4.5), "fixed * int");
+	check(near((double)real(u*x), 3.0), "unsigned * fixed");
+	check(near((double)real(x + ll), -2.5), "fixed + long long");
+	check(near((double)real(n - x), 1.5), "int - fixed");
+	check(near((double)real(x/n), 0.5), "fixed / int");
+	check(near((double)real(-1*x), -1.5), "negative int * fixed");
+
+		//fixed point with floating point values
+
+	check(near((double)real(x*2.0), 3.0), "fixed * double");
+	check(near((double)real(2.0*x), 3.0), "double * fixed");
+	check(near((double)real(x*0.5f), 0.75), "fixed * float");
+	check(near((double)real(x - 0.5), 1.0), "fixed - double");
+	check(near((double)real(1.0/x), 2.0/3.0), "double / fixed");
+
+		//switching functions of converters, products of bools scaling fixed point coefficients
+
+	bool Sw[4] = {true, false, false, true};
+
+	check(near((double)real((Sw[0]*Sw[3]-Sw[1]*Sw[2])*c), 0.25), "bool arithmetic * fixed");
+	check(near((double)real(Sw[0]*x), 1.5), "bool * fixed");
+
+	const int num_undecided = 2;
+	const real vth = 0.75;
+
+	check(near((double)real(num_undecided*vth), 1.5), "int count * fixed");
+
+		//comparisons
+
+	check(x == 1.5, "fixed == double");
+	check(x > 1, "fixed > int");
+	check(2 > x, "int > fixed");
+	check((Sw[0]*Sw[3]-Sw[1]*Sw[2]) == 1, "bool arithmetic == int");
+
+		//compound assignment and mixed fixed point formats
+
+	real y = x;
+	y += 1;
+	y *= 2.0;
+	y -= c;
+
+	check(near((double)y, 4.75), "compound assignment");
+	check(near((double)real(x*c + c*x), 0.75), "mixed fixed point formats");
+
+		//quantization modes at ties of half an LSB, and between ties
+
+	check(quantizes<LBLMC_RND>(0.03125, 0.0625), "RND +0.5 LSB");
+	check(quantizes<LBLMC_RND>(-0.03125, 0.0), "RND -0.5 LSB");
+	check(quantizes<LBLMC_RND>(0.09375, 0.125), "RND +1.5 LSB");
+	check(quantizes<LBLMC_RND_ZERO>(0.03125, 0.0), "RND_ZERO +0.5 LSB");
+	check(quantizes<LBLMC_RND_ZERO>(-0.03125, 0.0), "RND_ZERO -0.5 LSB");
+	check(quantizes<LBLMC_RND_ZERO>(0.09375, 0.0625), "RND_ZERO +1.5 LSB");
+	check(quantizes<LBLMC_RND_MIN_INF>(0.03125, 0.0), "RND_MIN_INF +0.5 LSB");
+	check(quantizes<LBLMC_RND_MIN_INF>(-0.03125, -0.0625), "RND_MIN_INF -0.5 LSB");
+	check(quantizes<LBLMC_RND_MIN_INF>(0.09375, 0.0625), "RND_MIN_INF +1.5 LSB");
+	check(quantizes<LBLMC_RND_INF>(0.03125, 0.0625), "RND_INF +0.5 LSB");
+	check(quantizes<LBLMC_RND_INF>(-0.03125, -0.0625), "RND_INF -0.5 LSB");
+	check(quantizes<LBLMC_RND_INF>(0.09375, 0.125), "RND_INF +1.5 LSB");
+	check(quantizes<LBLMC_RND_CONV>(0.03125, 0.0), "RND_CONV +0.5 LSB");
+	check(quantizes<LBLMC_RND_CONV>(-0.03125, 0.0), "RND_CONV -0.5 LSB");
+	check(quantizes<LBLMC_RND_CONV>(0.09375, 0.125), "RND_CONV +1.5 LSB");
+	check(quantizes<LBLMC_TRN>(0.03125, 0.0), "TRN +0.5 LSB");
+	check(quantizes<LBLMC_TRN>(-0.03125, -0.0625), "TRN -0.5 LSB");
+	check(quantizes<LBLMC_TRN>(0.09375, 0.0625), "TRN +1.5 LSB");
+	check(quantizes<LBLMC_TRN_ZERO>(0.03125, 0.0), "TRN_ZERO +0.5 LSB");
+	check(quantizes<LBLMC_TRN_ZERO>(-0.03125, 0.0), "TRN_ZERO -0.5 LSB");
+	check(quantizes<LBLMC_TRN_ZERO>(-0.09375, -0.0625), "TRN_ZERO -1.5 LSB");
+
+		//overflow modes at and beyond the range [-8, 7.9375] of <8,4>
+
+	check(overflows<LBLMC_SAT>(8.0, 7.9375), "SAT 8");
+	check(overflows<LBLMC_SAT>(100.0, 7.9375), "SAT 100");
+	check(overflows<LBLMC_SAT>(-100.0, -8.0), "SAT -100");
+	check(overflows<LBLMC_SAT>(-8.0, -8.0), "SAT -8");
+	check(overflows<LBLMC_SAT_ZERO>(8.0, 0.0), "SAT_ZERO 8");
+	check(overflows<LBLMC_SAT_ZERO>(-100.0, 0.0), "SAT_ZERO -100");
+	check(overflows<LBLMC_SAT_ZERO>(7.9375, 7.9375), "SAT_ZERO 7.9375");
+	check(overflows<LBLMC_SAT_SYM>(8.0, 7.9375), "SAT_SYM 8");
+	check(overflows<LBLMC_SAT_SYM>(-100.0, -7.9375), "SAT_SYM -100");
+	check(overflows<LBLMC_WRAP>(8.0, -8.0), "WRAP 8");
+	check(overflows<LBLMC_WRAP>(100.0, 4.0), "WRAP 100");
+	check(overflows<LBLMC_WRAP>(-100.0, -4.0), "WRAP -100");
+
+		//division of a product, whose dividend has twice the fractional bits of the words
+
+	typedef lblmc_fixed<64, 32> real_wide;
+
+	const real_wide a = 3, b = 2, d = 2;
+
+	check((double)real_wide(a*b/d) == 3.0, "product / fixed");
+	check((double)real_wide(-a*b/d) == -3.0, "negative product / fixed");
+	check((double)real_wide(a/real_wide(-0.75)) == -4.0, "fixed / negative fixed");
+	check((double)lblmc_fixed<8, 4>(lblmc_fixed<8, 4>(1)/lblmc_fixed<8, 4>(3)) == 0.3125, "division truncates towards zero");
+	check((double)lblmc_fixed<8, 4>(lblmc_fixed<8, 4>(-1)/lblmc_fixed<8, 4>(3)) == -0.3125, "negative division truncates towards zero");
+
+	if(failures == 0) std::cout << "lblmc_fixed_test passed" << std::endl;
+
+	return failures == 0 ? 0 : 1;
+}